@@ -0,0 +1,68 @@
+#ifndef ENCODER_PROFILE_H
+#define ENCODER_PROFILE_H
+
+#include <gst/gst.h>
+
+/*
+ * H.264 encoder profilleri: x264enc, vaapih264enc ve nvh264enc aynı
+ * profil adıyla tutarlı ayarlanır.
+ *
+ *   low-latency: B-frame yok, lookahead yok, kısa GOP, kare başına birden çok slice,
+ *                CBR ve tek karelik VBV; intra-refresh yalnızca istenirse (x264enc)
+ *   quality:     B-frame'li, daha yavaş preset, VBR, bir saniyelik VBV
+ *
+ * Encoder'da bulunmayan özellikler sessizce atlanır; böylece aynı profil farklı
+ * GStreamer sürümlerinde de kurulur.
+ */
+
+typedef enum {
+    ENCODER_PROFILE_LOW_LATENCY = 0,
+    ENCODER_PROFILE_QUALITY
+} EncoderProfile;
+
+typedef struct {
+    EncoderProfile profile;
+    guint          bitrate_kbps;    /* başlangıç hedefi */
+    guint          gop;             /* kare; 0 -> profil varsayılanı (fps ya da 2 * fps) */
+    guint          slices;          /* low-latency: kare başına slice; 0 -> 4 */
+    gint           fps;             /* VBV ve GOP hesapları için */
+    gboolean       intra_refresh;   /* low-latency, x264enc: IDR yerine kayan intra şerit
+                                     * (periyodik IDR kalmaz; PLI yine IDR üretir) */
+} EncoderConfig;
+
+/* low-latency, 4000 kbit/s, GOP ve slice profil varsayılanı, 30 fps, intra-refresh kapalı */
+void encoder_default_config(EncoderConfig *cfg);
+
+/**
+ * "low-latency" / "quality" adını çözer.
+ * @return 0 -> geçerli, -1 -> bilinmeyen profil
+ */
+int encoder_profile_from_name(const char *name, EncoderProfile *out);
+const char* encoder_profile_name(EncoderProfile profile);
+
+/**
+ * Encoder'ı oluşturup profile göre ayarlar.
+ *
+ * @param factory  "vaapih264enc", "nvh264enc" ...; NULL -> x264enc (CPU)
+ * @return GstElement* -> ayarlanmış encoder, NULL -> eleman oluşturulamadı
+ */
+GstElement* encoder_new(const char *factory, const EncoderConfig *cfg, const char *name);
+
+/**
+ * Hedef bit hızını PLAYING durumunda, hattı yeniden başlatmadan değiştirir.
+ * Üç ailede de "bitrate" kbit/s'dir ve çalışırken değiştirilebilir.
+ *
+ * @return TRUE -> uygulandı, FALSE -> encoder'da bitrate özelliği yok
+ */
+gboolean encoder_set_bitrate(GstElement *enc, guint kbps);
+
+/**
+ * Encoder'dan mümkün olan ilk karede SPS/PPS'li bir IDR ister (alıcı PLI'ı).
+ * Olay gstreamer-video'nun upstream force-key-unit olayıyla aynıdır; ek
+ * kütüphane gerektirmemek için çekirdek API ile kurulur.
+ *
+ * @return TRUE -> encoder olayı kabul etti
+ */
+gboolean encoder_force_keyframe(GstElement *enc);
+
+#endif // ENCODER_PROFILE_H
@@ -0,0 +1,87 @@
+#ifndef FEC_AGGREGATOR_H
+#define FEC_AGGREGATOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "shard_pool.h"
+
+/*
+ * Küçük erişim birimlerini tek bir FEC bloğunda toplayan blok kurucu.
+ *
+ * Düşük bit hızında bir P-frame k shard'a bölündüğünde her shard birkaç yüz
+ * byte'lık, çoğu hizalama dolgusu olan paketlere dönüşür ve r parity paketi
+ * payload'a göre çok pahalıdır. Kurucu ardışık birimleri, blok kapasitesi
+ * (k * MTU shard'ı) dolana ya da ilk birimden beri gecikme sınırı geçene kadar
+ * bir slab'da biriktirir.
+ *
+ * Toplanmış blok payload'u kayıtlardan oluşur:
+ *
+ *  +---------------+---------------+---------------+---------------+
+ *  |                        length (byte)                          |
+ *  +---------------+---------------+---------------+---------------+
+ *  |                        RTP timestamp                          |
+ *  +---------------+---------------+---------------+---------------+
+ *  |                     length byte AU verisi ...                 |
+ *
+ * IDR'lar ve bloğun yarısından büyük birimler toplanmaz; sıra bozulmasın
+ * diye önce bekleyen blok gönderilir, sonra birim olduğu gibi aktarılır.
+ */
+
+#define FEC_AGG_RECORD_HEADER 8
+
+/**
+ * Kurucunun ürettiği her iş için sırayla ve aynı anda en fazla bir kez çağrılır
+ * (push'u yapan ya da zamanlayıcı iş parçacığından). Kurucunun kilidi bu sırada
+ * tutulmaz; fec_pipeline_submit'e doğrudan aktarılabilir ve geri basınçta bekleyebilir.
+ *
+ * @param aggregated  1 -> data kayıt biçiminde, 0 -> tek erişim birimi
+ */
+typedef void (*FecAggregateEmit)(void *user, const unsigned char *data, size_t len,
+                                 void *owner, void (*release_owner)(void *owner),
+                                 uint32_t rtp_timestamp, int keyframe, int aggregated);
+
+typedef struct {
+    size_t   capacity;          /* blok başına en büyük payload (k * max_shard_size) */
+    unsigned deadline_us;       /* ilk birimden sonra en fazla bekleme; 0 -> toplama kapalı */
+} FecAggregatorConfig;
+
+typedef struct {
+    uint64_t units_in;          /* gelen erişim birimi */
+    uint64_t units_aggregated;  /* bir bloğa toplanan birim */
+    uint64_t blocks_out;        /* gönderilen toplanmış blok */
+    uint64_t flush_full;        /* kapasite dolduğu için */
+    uint64_t flush_deadline;    /* gecikme sınırı yüzünden */
+    uint64_t flush_bypass;      /* IDR ya da büyük birim öncesinde */
+} FecAggregatorStats;
+
+typedef struct FecAggregator FecAggregator;
+
+FecAggregator* fec_aggregator_new(const FecAggregatorConfig *cfg, ShardPool *pool,
+                                  FecAggregateEmit emit, void *user);
+
+/* Bekleyen bloğu gönderir, zamanlayıcı iş parçacığını durdurur */
+void fec_aggregator_free(FecAggregator *agg);
+
+/**
+ * Bir erişim birimi ekler. Toplanan birimler slab'a kopyalanır ve owner
+ * hemen bırakılır; toplanmayanlar owner ile birlikte emit'e aktarılır.
+ */
+void fec_aggregator_push(FecAggregator *agg, const unsigned char *data, size_t len,
+                         void *owner, void (*release_owner)(void *owner),
+                         uint32_t rtp_timestamp, int keyframe);
+
+/* Bekleyen bloğu hemen gönderir */
+void fec_aggregator_flush(FecAggregator *agg);
+
+void fec_aggregator_get_stats(FecAggregator *agg, FecAggregatorStats *out);
+
+/**
+ * Toplanmış bir payload'u kayıtlarına ayırır.
+ * @return kayıt sayısı, biçim bozuksa -1
+ */
+int fec_aggregate_parse(const unsigned char *buf, size_t len,
+                        void (*record)(void *user, const unsigned char *data, size_t len,
+                                       uint32_t rtp_timestamp),
+                        void *user);
+
+#endif // FEC_AGGREGATOR_H
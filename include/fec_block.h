@@ -0,0 +1,47 @@
+#ifndef FEC_BLOCK_H
+#define FEC_BLOCK_H
+
+#include <stddef.h>
+#include "fec_codec.h"
+#include "shard_pool.h"
+
+/**
+ * Bir FEC bloğu: k veri + r parity shard işaretçisi.
+ *
+ * Sıfır kopya modunda tam dolu veri shard'ları doğrudan kaynak tamponu
+ * gösterir; yalnızca son (kısmi) shard slab'a kopyalanıp sıfırla doldurulur.
+ * Kaynak tampon, owner üzerinden release_owner çağrılana kadar canlı tutulur.
+ */
+typedef struct {
+    int k;
+    int r;
+    int shard_size;                                 /* her shard'ın byte boyutu */
+    size_t payload_len;                             /* orijinal (dolgusuz) veri uzunluğu */
+    int zero_copy;                                  /* veri shard'ları kaynak tampona mı bakıyor */
+    unsigned char *shards[FEC_MAX_TOTAL_SHARDS];    /* 0..k-1 veri, k..k+r-1 parity */
+
+    ShardSlab *slab;                                /* parity + kopyalanan veri için bellek */
+    void *owner;                                    /* kaynak tamponun sahibi (örn. GstBuffer) */
+    void (*release_owner)(void *owner);
+} FecBlock;
+
+/**
+ * data/len içeriğini k veri shard'ına böler ve parity için yer ayırır.
+ * zero_copy sıfırdan farklıysa tam shard'lar kopyalanmaz; bu durumda data,
+ * fec_block_release çağrılana kadar geçerli kalmalıdır (owner ile bağlanır).
+ *
+ * @return 0 -> başarılı, -1 -> geçersiz parametre ya da bellek yetersiz
+ */
+int fec_block_prepare(FecBlock *blk, ShardPool *pool, int k, int r,
+                      const unsigned char *data, size_t len, int zero_copy);
+
+/* Kaynak tamponu bağlar; blok bırakılırken release_owner(owner) çağrılır */
+void fec_block_set_owner(FecBlock *blk, void *owner, void (*release_owner)(void *owner));
+
+/* Parity shard'larını hesaplar */
+void fec_block_encode(FecBlock *blk, const FecEncoder *enc);
+
+/* Slab'ı havuza geri verir ve kaynak tamponu bırakır */
+void fec_block_release(FecBlock *blk, ShardPool *pool);
+
+#endif // FEC_BLOCK_H
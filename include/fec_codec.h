@@ -0,0 +1,90 @@
+#ifndef FEC_CODEC_H
+#define FEC_CODEC_H
+
+/* Desteklenen en büyük (k, r) değerleri; önbellek tablosu bu boyutta tutulur */
+#define FEC_MAX_DATA_SHARDS   32
+#define FEC_MAX_PARITY_SHARDS 16
+#define FEC_MAX_TOTAL_SHARDS  (FEC_MAX_DATA_SHARDS + FEC_MAX_PARITY_SHARDS)
+
+/* xor_gen / pq_gen için gereken işaretçi ve uzunluk hizası (AVX2) */
+#define FEC_SIMD_ALIGN 32
+
+/*
+ * Parity sayısına göre seçilen kod. r <= 2 için matris RAID-6 P+Q satırlarıdır
+ * (P = D0 ^ D1 ^ ..., Q = D0 + 2·D1 + 4·D2 + ... GF(2^8) içinde); böylece kodlama
+ * ISA-L xor_gen / pq_gen ile yapılır ve genel çözücü aynı matrisle çalışmaya devam eder.
+ * Gönderici ve alıcı aynı (k, r) için aynı kodu seçer. r <= 2 paritesi önceki
+ * Cauchy düzeniyle uyumsuz olduğundan FEC başlığı RTP_FEC_WIRE_VERSION taşır.
+ */
+typedef enum {
+    FEC_CODE_RS = 0,                /* Cauchy Reed-Solomon, ec_encode_data */
+    FEC_CODE_XOR,                   /* r = 1: tek XOR paritesi, xor_gen */
+    FEC_CODE_PQ                     /* r = 2: P + Q, pq_gen */
+} FecCode;
+
+/* Bir (k, r) çifti için önceden hesaplanmış kodlama bağlamı */
+typedef struct {
+    int k;                          /* veri shard sayısı */
+    int r;                          /* parity shard sayısı */
+    FecCode code;
+    unsigned char *encode_matrix;   /* (k + r) x k; r <= 2 -> P+Q, aksi halde Cauchy */
+    unsigned char *gftbls;          /* ec_init_tables çıktısı, 32 * k * r byte */
+} FecEncoder;
+
+/**
+ * (k, r) için kodlama bağlamını döndürür.
+ * İlk çağrıda matris ve tablolar bir kez üretilir, sonraki çağrılar
+ * önbellekten kilitsiz okunur. Dönen işaretçi fec_codec_shutdown'a kadar geçerlidir.
+ *
+ * @return const FecEncoder*  -> paylaşılan bağlam
+ *                               NULL -> geçersiz (k, r) ya da bellek yetersiz
+ */
+const FecEncoder* fec_encoder_get(int k, int r);
+
+/**
+ * shards[0..k-1] veri dilimlerinden shards[k..k+r-1] parity dilimlerini üretir.
+ * Tüm dilimler en az len byte olmalıdır. XOR / P+Q yolu yalnızca len ve tüm
+ * işaretçiler FEC_SIMD_ALIGN hizalıysa kullanılır; aksi halde (örn. hizasız sıfır
+ * kopya shard'ı) aynı matrisle ec_encode_data'ya düşülür, sonuç aynıdır.
+ */
+void fec_encode(const FecEncoder *enc, int len, unsigned char **shards);
+
+/* --- Çözme (alıcı tarafı) --- */
+
+/*
+ * Kayıp deseni başına önbelleğe alınan çözme tabloları.
+ * Patlama kayıplarında aynı desenler tekrarlandığı için matris tersi ve
+ * ec_init_tables yalnızca yeni bir desen görüldüğünde hesaplanır.
+ * Bir FecDecoder tek iş parçacığından kullanılmalıdır.
+ */
+typedef struct FecDecoder FecDecoder;
+
+typedef struct {
+    unsigned long long decodes;     /* kayıp veri shard'ı olan bloklar */
+    unsigned long long xor_decodes; /* bunlardan P paritesiyle XOR üzerinden çözülen */
+    unsigned long long cache_hits;  /* önbellekten gelen desen */
+    unsigned long long cache_misses;/* yeniden hesaplanan desen */
+    unsigned long long failures;    /* k'dan az shard ya da tekil matris */
+} FecDecoderStats;
+
+/* cache_slots adet desen tutan çözücü (0 -> varsayılan 64) */
+FecDecoder* fec_decoder_new(unsigned int cache_slots);
+void fec_decoder_free(FecDecoder *dec);
+
+/**
+ * Eksik veri shard'larını yeniden oluşturur. XOR / P+Q kodunda tek kayıp veri
+ * shard'ı P mevcutsa xor_gen ile, diğer desenler önbellekli matris tersiyle çözülür.
+ *
+ * @param shards   k + r işaretçi; eksik veri shard'ları için çıktı tamponu verilmelidir
+ * @param present  k + r bayrak; sıfır olmayan -> shard alındı
+ * @return 0 -> tüm veri shard'ları hazır, -1 -> k'dan az shard ya da çözülemedi
+ */
+int fec_decoder_reconstruct(FecDecoder *dec, int k, int r, int len,
+                            unsigned char **shards, const unsigned char *present);
+
+void fec_decoder_get_stats(const FecDecoder *dec, FecDecoderStats *out);
+
+/* Önbellekteki tüm bağlamları serbest bırakır (program sonunda çağrılır) */
+void fec_codec_shutdown(void);
+
+#endif // FEC_CODEC_H
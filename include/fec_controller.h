@@ -0,0 +1,65 @@
+#ifndef FEC_CONTROLLER_H
+#define FEC_CONTROLLER_H
+
+/*
+ * Ölçülen kayba göre parity sayısını seçen uyarlamalı FEC denetleyicisi.
+ *
+ * Alıcıdan gelen RTCP kayıp oranı hızlı yükselen / yavaş düşen bir EWMA ile
+ * süzülür. Her raporda, k + r paketlik bir blokta r'den fazla kayıp olasılığı
+ * (binom kuyruğu) hedefin altına inen en küçük r hesaplanır. IDR blokları
+ * için daha sıkı bir hedef kullanılır; kaybolan bir IDR saniyelerce görüntüyü
+ * bozduğu için fazladan parity'ye değer.
+ *
+ * Bit hızı bütçesi verilirse denetleyici encoder hedefini de üretir: bütçeden
+ * parity payı (k / (k + r)) ayrılır, ham kayıp tıkanıklık eşiğini aşınca hedef
+ * çarpımsal düşer, temiz raporlarda toplamsal olarak geri çıkar (AIMD).
+ */
+
+typedef struct {
+    int    k;                       /* veri shard sayısı */
+    int    r_min;                   /* temiz hatta bile gönderilen parity */
+    int    r_max;                   /* üst sınır */
+    double target_block_loss;       /* P-frame blokları için kabul edilen blok kaybı */
+    double keyframe_block_loss;     /* IDR blokları için (daha sıkı) */
+    double alpha_up;                /* kayıp artarken EWMA katsayısı */
+    double alpha_down;              /* kayıp azalırken EWMA katsayısı */
+    int    adaptive;                /* 0 -> her zaman r_max (sabit oran) */
+    int    bitrate_kbps;            /* parity dahil gönderim bütçesi; 0 -> bit hızı denetimi yok */
+    int    min_bitrate_kbps;        /* encoder hedefinin alt sınırı */
+    double congestion_loss;         /* bu ham kaybın üstü tıkanıklık sayılır */
+} FecControllerConfig;
+
+typedef struct FecController FecController;
+
+typedef struct {
+    double   loss_estimate;         /* süzülmüş paket kayıp oranı */
+    int      r_delta;               /* P-frame blokları için seçili r */
+    int      r_keyframe;            /* IDR blokları için seçili r */
+    unsigned long long reports;     /* işlenen geri bildirim */
+    int      target_kbps;           /* encoder hedefi; 0 -> bit hızı denetimi yok */
+} FecControllerState;
+
+/* k=10, r=1..4, hedef 1e-3 / IDR 1e-5, bit hızı denetimi kapalı (tıkanıklık eşiği %5) */
+void fec_controller_default_config(FecControllerConfig *cfg);
+
+FecController* fec_controller_new(const FecControllerConfig *cfg);
+void fec_controller_free(FecController *ctl);
+
+/* Sınırlara çekilmiş (geçerli) yapılandırmayı döndürür */
+void fec_controller_get_config(const FecController *ctl, FecControllerConfig *out);
+
+/* Alıcının bildirdiği kayıp oranını (0..1) işler; herhangi bir iş parçacığından çağrılabilir */
+void fec_controller_report_loss(FecController *ctl, double loss_fraction);
+
+/* Bir sonraki blok için (k, r) seçer; kilitsiz, akış iş parçacığında çağrılır */
+void fec_controller_select(FecController *ctl, int keyframe, int *k, int *r);
+
+/**
+ * Encoder için güncel hedef bit hızı; kilitsiz, herhangi bir iş parçacığından.
+ * @return int -> kbit/s, 0 -> bütçe verilmemiş
+ */
+int fec_controller_target_bitrate(FecController *ctl);
+
+void fec_controller_get_state(FecController *ctl, FecControllerState *out);
+
+#endif // FEC_CONTROLLER_H
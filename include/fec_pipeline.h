@@ -0,0 +1,132 @@
+#ifndef FEC_PIPELINE_H
+#define FEC_PIPELINE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "fec_block.h"
+#include "telemetry.h"
+
+/*
+ * appsink akış iş parçacığını FEC ve ağdan ayıran iş hattı.
+ *
+ *   appsink ──► [halka 0] ──► işçi 0 ──┐
+ *           └─► [halka 1] ──► işçi 1 ──┼──► sıralayıcı ──► emit (gönderim)
+ *               ...                     ┘
+ *
+ * Üretici işleri işçilere sırayla (round-robin) dağıtır; her işçinin kendi
+ * sınırlı halkası vardır, böylece her halka tek üretici / tek tüketicidir.
+ * Sıralayıcı halkaları aynı sırayla okuduğu için çıktı giriş sırasını korur.
+ *
+ * Birden çok akış aynı işçileri paylaşabilir: gönderimler bir kilitle
+ * sıralanır, her akış kendi FecProducer'ını (etiket ve GOP durumu) taşır.
+ */
+
+/* Halka doluyken ne yapılacağı */
+typedef enum {
+    FEC_QUEUE_BLOCK = 0,    /* üreticiyi beklet (geri basınç) */
+    FEC_QUEUE_DROP          /* P-frame'i at; GOP'un kalanı da sonraki IDR'a kadar atılır */
+} FecQueuePolicy;
+
+typedef struct {
+    unsigned int   workers;         /* FEC işçi sayısı */
+    unsigned int   queue_depth;     /* işçi başına halka boyutu */
+    FecQueuePolicy policy;
+    int            zero_copy;       /* fec_block_prepare'e aktarılır */
+    int            max_shard_size;  /* blok başına en büyük shard (MTU'dan) */
+} FecPipelineConfig;
+
+/* fec_pipeline_submit job_flags bitleri; 0 -> tek parça, tam bir erişim birimi */
+#define FEC_JOB_AGGREGATE   0x01    /* data fec_aggregator kayıtlarından oluşuyor */
+#define FEC_JOB_NOT_FIRST   0x02    /* erişim biriminin ilk parçası değil (slice modu) */
+#define FEC_JOB_NOT_LAST    0x04    /* erişim biriminin son parçası değil (slice modu) */
+
+/* Bir erişim birimi (ya da slice grubu) işi: üretici doldurur, işçi blokları üretir, emit gönderir */
+typedef struct {
+    uint64_t seq;
+    void *tag;                      /* üreticinin etiketi (örn. akış); emit'e aynen gelir */
+    const unsigned char *data;
+    size_t len;
+    void *owner;                    /* data'nın sahibi; emit sonrası bırakılır */
+    void (*release_owner)(void *owner);
+    uint32_t rtp_timestamp;
+    int keyframe;
+    int flags;                      /* FEC_JOB_* */
+    int k, r;
+
+    /* İşçi çıktısı */
+    FecBlock *blocks;
+    int nblocks;
+    int blocks_cap;
+    int failed;
+
+    /* Aşama zaman damgaları (CLOCK_MONOTONIC, ns) */
+    uint64_t t_enqueue;
+    uint64_t t_fec_start;
+    uint64_t t_fec_end;
+    uint64_t t_emit;
+    uint64_t shard_ns;              /* t_fec_start..t_fec_end içinde fec_block_prepare süresi */
+
+    int stop;                       /* iç kullanım: kapanış işareti */
+} FecJob;
+
+/* Sıralayıcı iş parçacığından, giriş sırasıyla çağrılır */
+typedef void (*FecJobEmit)(void *user, FecJob *job);
+
+/* Sayaçlar ve aşama başına gecikme dağılımları (ns); okuma kilitsizdir */
+typedef struct {
+    uint64_t submitted;
+    uint64_t dropped;               /* halka dolu ya da GOP atlanıyor */
+    uint64_t blocked;               /* geri basınçla bekleyen gönderim */
+    uint64_t failed;                /* blok hazırlanamadı (yine de bitmiş iş sayılır) */
+    uint64_t in_flight;             /* kuyrukta ya da işçide olan iş (anlık): submitted - bitmiş */
+    uint64_t bytes_in;              /* gönderilen işlerin payload byte'ı */
+    uint64_t blocks;
+    uint64_t data_shards;
+    uint64_t parity_shards;
+    uint64_t padding_bytes;         /* son shard'ın sıfır dolgusu (k * shard - payload) */
+    TelSummary queue;               /* appsink -> işçi */
+    TelSummary shard;               /* fec_block_prepare: bölme ve kuyruk shard'ı kopyası */
+    TelSummary encode;              /* parity hesabı */
+    TelSummary reorder;             /* işçi bitişi -> sıralayıcı */
+    TelSummary emit;                /* gönderim (ya da zamanlayıcı kuyruğuna kopya) */
+    TelSummary total;               /* appsink -> gönderim sonu */
+} FecPipelineStats;
+
+/* Üretici (akış) başına durum; üretici iş parçacığı dışında yalnızca okunur */
+typedef struct {
+    void *tag;                      /* gönderilen her FecJob.tag'e kopyalanır */
+    int skipping_gop;               /* DROP: sonraki IDR'a kadar P-frame atılıyor */
+    uint64_t submitted;
+    uint64_t dropped;
+} FecProducer;
+
+typedef struct FecPipeline FecPipeline;
+
+void fec_producer_init(FecProducer *src, void *tag);
+
+/* workers=2, queue_depth=8, BLOCK, zero_copy=1 */
+void fec_pipeline_default_config(FecPipelineConfig *cfg);
+
+FecPipeline* fec_pipeline_new(const FecPipelineConfig *cfg, ShardPool *pool,
+                              FecJobEmit emit, void *user);
+
+/**
+ * Bir erişim birimini kuyruğa alır; farklı iş parçacıklarından çağrılabilir.
+ * Sahiplik başarıda da atlamada da havuza geçer: owner her durumda bırakılır.
+ *
+ * @param src        akışın üretici durumu; NULL -> iş hattının kendi (tek akış) durumu
+ * @param job_flags  FEC_JOB_* bitleri, FecJob.flags'e aynen kopyalanır
+ * @return 0 -> kuyruğa alındı, 1 -> politika gereği atıldı
+ */
+int fec_pipeline_submit(FecPipeline *p, FecProducer *src,
+                        const unsigned char *data, size_t len,
+                        void *owner, void (*release_owner)(void *owner),
+                        uint32_t rtp_timestamp, int keyframe, int job_flags, int k, int r);
+
+/* Kuyruktaki işleri bitirir ve iş parçacıklarını durdurur */
+void fec_pipeline_stop(FecPipeline *p);
+void fec_pipeline_free(FecPipeline *p);
+
+void fec_pipeline_get_stats(FecPipeline *p, FecPipelineStats *out);
+
+#endif // FEC_PIPELINE_H
@@ -0,0 +1,171 @@
+#ifndef FEC_REASSEMBLER_H
+#define FEC_REASSEMBLER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "rtp_fec.h"
+
+/* Yeniden kurulan bir erişim birimi (H.264 AU) için geri çağırma */
+typedef void (*FecFrameCallback)(void *user, const unsigned char *data, size_t len,
+                                 uint32_t rtp_timestamp, int keyframe);
+
+/**
+ * Slice çıkışı: erişim biriminin NAL sınırında biten bir parçası. Parçalar
+ * birim tamamlanmadan, RTP_FEC_FLAG_SLICE_END'li blok çözülür çözülmez gelir.
+ *
+ * @param end_of_frame  1 -> birimin son parçası (tam birimler de tek parça olarak gelir)
+ */
+typedef void (*FecSliceCallback)(void *user, const unsigned char *data, size_t len,
+                                 uint32_t rtp_timestamp, int keyframe, int end_of_frame);
+
+/* Geri bildirim isteği türü */
+typedef enum {
+    FEC_REPAIR_NACK,            /* eksik blok geride kaldı: missing'deki shard'lar istenir */
+    FEC_REPAIR_LOST             /* blok kurtarılamadan bırakıldı: birimi bozuldu, IDR gerekir */
+} FecRepairKind;
+
+/**
+ * Göndericiye iletilecek onarım isteği; push/flush'ı çağıran iş parçacığında çağrılır.
+ *
+ * @param missing  NACK: bloğu tamamlamaya yetecek eksik shard'lar (önce veri shard'ları),
+ *                 bloğun hiç paketi gelmediyse UINT64_MAX; LOST: 0
+ */
+typedef void (*FecRepairCallback)(void *user, FecRepairKind kind, uint32_t block_id,
+                                  uint64_t missing);
+
+typedef struct FecReassembler FecReassembler;
+
+typedef struct {
+    uint64_t packets;           /* kabul edilen shard paketi */
+    uint64_t duplicates;        /* aynı shard tekrar geldi */
+    uint64_t late;              /* teslim edilmiş/bırakılmış bloğa ait paket */
+    uint64_t blocks_intact;     /* kayıpsız tamamlanan blok */
+    uint64_t blocks_recovered;  /* parity ile kurtarılan blok */
+    uint64_t blocks_lost;       /* k'dan az shard ile bırakılan blok */
+    uint64_t frames_out;        /* teslim edilen erişim birimi */
+    uint64_t frames_dropped;    /* eksik blok yüzünden atılan (slice çıkışında: eksik kalan) birim */
+    uint64_t slices_out;        /* birim bitmeden teslim edilen slice grubu */
+    uint64_t slices_dropped;    /* kayıp blok yüzünden atılan slice grubu */
+    uint64_t nacks;             /* NACK istenen blok */
+    uint64_t retransmits;       /* kabul edilen yeniden gönderilmiş shard */
+    uint64_t blocks_repaired;   /* yeniden gönderilen shard'la tamamlanan blok */
+    uint64_t resyncs;           /* blok numarası pencereden uzağa sıçradı, pencere yeniden kuruldu */
+    uint64_t layer_switches;    /* simulcast: yeni SSRC'nin IDR'ında geçildi */
+    uint64_t stale_packets;     /* etkin SSRC dışından atılan paket */
+    uint64_t orphan_requests;   /* başlangıç bloğu gelmeyen SSRC için istenen IDR */
+} FecReassemblerStats;
+
+/* Uyarlanır jitter tamponu sınırları (fec_reassembler_set_jitter_buffer) */
+typedef struct {
+    uint32_t min_wait_us;       /* eksik blok için en kısa bekleme */
+    uint32_t max_wait_us;       /* en uzun bekleme; ölçüm yokken de bu kullanılır */
+} FecJitterConfig;
+
+/* Jitter tamponu kararları; anlık değerler son tahmindir */
+typedef struct {
+    uint32_t jitter_us;         /* RFC 3550 varış jitter'ı */
+    uint32_t spread_us;         /* ilk shard -> k. shard süresi (ortalama + 4 sapma) */
+    uint32_t wait_us;           /* güncel bekleme: spread + 2 * jitter, sınırlar içinde */
+    uint64_t blocks_expired;    /* son tarih geçince kayıp sayılan blok */
+    uint64_t shards_after_deadline; /* son tarihi geçmiş bloğa gelen ilk shard (bekleme kısa kaldı) */
+    uint64_t hold_us_total;     /* hazır blokların öndeki eksik bloğu beklediği toplam süre */
+    uint64_t hold_max_us;
+} FecJitterStats;
+
+/**
+ * Blok penceresi ve yeniden sıralama derinliğiyle birleştirici oluşturur.
+ *
+ * @param window       aynı anda açık tutulabilecek blok sayısı (2'nin kuvvetine yuvarlanır)
+ * @param reorder      en yeni bloktan bu kadar geride kalan eksik blok için beklemeyi bırak
+ * @param cb           tamamlanan her erişim birimi için, blok sırasıyla çağrılır
+ */
+FecReassembler* fec_reassembler_new(unsigned int window, unsigned int reorder,
+                                    FecFrameCallback cb, void *user);
+void fec_reassembler_free(FecReassembler *ra);
+
+/**
+ * Erişim birimlerini slice gruplarıyla teslim eder; ayarlanınca FecFrameCallback
+ * yerine bu çağrılır (user aynıdır). Kayıp bir blok yalnızca kendi slice
+ * grubunu götürür: sonraki SLICE_END'den itibaren birimin kalanı yine teslim edilir.
+ */
+void fec_reassembler_set_slice_callback(FecReassembler *ra, FecSliceCallback cb);
+
+/**
+ * Onarım isteklerini açar. Eksik bir blok en yeni bloktan nack_after kadar geride
+ * kalınca bir kez NACK edilir; NACK'in yanıtı ancak blok yeniden sıralama
+ * derinliği dolmadan gelirse işe yarar, bu yüzden nack_after < reorder olmalıdır
+ * (aksi halde reorder - 1'e indirilir). Kurtarılamayan her blok için LOST bildirilir.
+ *
+ * @param nack_after  0 -> yalnızca LOST
+ */
+void fec_reassembler_set_repair_callback(FecReassembler *ra, unsigned int nack_after,
+                                         FecRepairCallback cb);
+
+/**
+ * Ayrıştırılmış bir paketi ekler; tamamlanan bloklar hemen çözülüp teslim edilir.
+ * Blok numarası bekleyen pencereden window kadar uzaktaysa (gönderici yeniden
+ * başladı) pencere fec_reassembler_reset gibi yeniden kurulur ve LOST bildirilir.
+ */
+void fec_reassembler_push(FecReassembler *ra, const RtpFecPacket *pkt);
+
+/* Bekleyen tüm blokları sonuçlandırır (akış sonu) */
+void fec_reassembler_flush(FecReassembler *ra);
+
+/**
+ * Blok numaraları yeni bir diziden gelecek (gönderici simulcast katmanı değiştirdi):
+ * bekleyen bloklar ve yarım erişim birimi onarım istenmeden atılır, sonraki paket
+ * pencereyi yeniden başlatır. İstatistikler korunur.
+ */
+void fec_reassembler_reset(FecReassembler *ra);
+
+/* fec_reassembler_accept_ssrc sonucu */
+#define FEC_SSRC_STALE    0     /* paket atılmalı */
+#define FEC_SSRC_ACCEPT   1     /* etkin SSRC */
+#define FEC_SSRC_SWITCHED 2     /* yeni SSRC'ye geçildi, pencere sıfırlandı */
+#define FEC_SSRC_ORPHAN   3     /* paket atılmalı; bu SSRC'ye IDR istenmeli (PLI) */
+
+/* Başlangıç bloğu olmadan bu kadar süre gelen SSRC için IDR istenir (ve en fazla bu aralıkla) */
+#define FEC_SSRC_ORPHAN_US 300000
+
+/**
+ * Simulcast SSRC kapısı; paket push'tan önce buradan geçer. İlk paketin SSRC'si
+ * kabul edilir. Başka bir SSRC'ye yalnızca ilk gönderimi olan bir IDR başlangıç
+ * bloğunda (KEYFRAME | START_OF_FRAME) geçilir ve pencere sıfırlanır. Öncesinde
+ * gelen yeni SSRC paketleri ve geçişten sonra gelen eski SSRC paketleri atılır.
+ *
+ * Yeniden başlayan gönderici yeni bir SSRC'yle GOP ortasından başlar: aynı yabancı
+ * SSRC'den FEC_SSRC_ORPHAN_US boyunca paket gelmeye devam ederse (ara verirse sayaç
+ * sıfırlanır) FEC_SSRC_ORPHAN döner; çağıran h->ssrc'yi adlandıran bir PLI yollar,
+ * IDR'ın başlangıç bloğu geçişi yapar. Zaman fec_reassembler_advance ile verilir.
+ *
+ * @return FEC_SSRC_STALE / FEC_SSRC_ACCEPT / FEC_SSRC_SWITCHED / FEC_SSRC_ORPHAN
+ */
+int fec_reassembler_accept_ssrc(FecReassembler *ra, const RtpFecHeader *h);
+
+/**
+ * Eksik blokları blok sayısı yerine zamana göre bırakır. Her bloğun son tarihi ilk
+ * shard'ının (hiç gelmediyse sonraki bir bloğun görüldüğü anın) üzerine akışın
+ * ölçülen blok içi yayılımı ve varış jitter'ı kadar eklenerek bulunur; k shard'ı
+ * toplanan blok beklemeden çözülür, teslim yine blok (kod çözme) sırasıyladır.
+ * reorder yok sayılır, pencere üst sınır olarak kalır. Zaman fec_reassembler_advance
+ * ile verilir.
+ */
+void fec_reassembler_set_jitter_buffer(FecReassembler *ra, const FecJitterConfig *cfg);
+
+/* Saati ilerletir (CLOCK_MONOTONIC, µs); sonraki push'lar ve SSRC kapısı bu anı kullanır, son tarihi geçen bloklar sonuçlandırılır */
+void fec_reassembler_advance(FecReassembler *ra, int64_t now_us);
+
+/**
+ * @return int64_t -> sıradaki eksik bloğun son tarihi (µs), -1 -> bekleyen blok yok
+ *                    ya da jitter tamponu kapalı
+ */
+int64_t fec_reassembler_next_deadline(const FecReassembler *ra);
+
+void fec_reassembler_get_stats(const FecReassembler *ra, FecReassemblerStats *out);
+
+void fec_reassembler_get_jitter_stats(const FecReassembler *ra, FecJitterStats *out);
+
+/* Kayıp desenlerine ait çözme önbelleği istatistikleri */
+void fec_reassembler_get_decoder_stats(const FecReassembler *ra, FecDecoderStats *out);
+
+#endif // FEC_REASSEMBLER_H
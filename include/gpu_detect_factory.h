@@ -7,16 +7,44 @@
 #include <string.h>
 
 /* GPU üretici tipi */
-typedef enum { 
-    GPU_UNKNOWN = 0, 
-    GPU_INTEL, 
-    GPU_NVIDIA, 
-    GPU_AMD 
+typedef enum {
+    GPU_UNKNOWN = 0,
+    GPU_INTEL,
+    GPU_NVIDIA,
+    GPU_AMD
 } GpuVendor;
 
+/**
+ * Tek seferlik tespitin sonucu. Alanlar GStreamer element factory adlarıdır;
+ * NULL -> bu rol için GPU hızlandırma yok. jpeg_decoder hiçbir zaman NULL
+ * değildir (son çare "jpegdec").
+ */
+typedef struct {
+    GpuVendor   vendor;
+    const char *decoder;        /* H.264 decode, örn. "vaapidecodebin" */
+    const char *encoder;        /* H.264 encode, örn. "vaapih264enc" */
+    const char *postproc;       /* örn. "vaapipostproc", "nvvideoconvert" */
+    const char *sink;           /* örn. "vaapisink", "nveglglessink" */
+    const char *jpeg_decoder;   /* MJPG kamera için: "vaapijpegdec", "nvjpegdec", "jpegdec" */
+    int         from_cache;     /* sonuç disk önbelleğinden okundu */
+} GpuCapabilities;
+
+/**
+ * GPU'yu /sys/bus/pci üzerinden bir kez tespit eder ve GStreamer kayıt
+ * defterini bir kez sorgular; sonraki çağrılar aynı yapıyı döndürür.
+ * gst_init sonrasında çağrılmalıdır; iş parçacığı güvenlidir.
+ *
+ * GPU_CAPS_CACHE ortam değişkeni bir dosya yolu gösteriyorsa sonuç oraya
+ * yazılır ve çekirdek sürümü, GStreamer sürümü ve kayıt defteri dosyası
+ * değişmediği sürece sonraki süreçler kayıt defterini hiç sorgulamaz.
+ *
+ * @return GpuCapabilities* -> süreç boyunca geçerli, değiştirilmemeli
+ */
+const GpuCapabilities* gpu_detect_capabilities(void);
+
 /**
  * GPU'yu tespit edip GStreamer element factory adını döndürür.
- * 
+ *
  * @param role:
  *   "decoder"  -> GPU decode elementi
  *   "encoder"  -> GPU encode elementi
@@ -28,4 +56,3 @@ typedef enum {
 const char* gpu_detect_and_find_factory(const char *role);
 
 #endif // GPU_DETECT_FACTORY_H
-
@@ -0,0 +1,54 @@
+#ifndef GPU_MEMORY_H
+#define GPU_MEMORY_H
+
+#include <gst/gst.h>
+
+/*
+ * GPU belleği (DMABuf / VASurface) yolunun seçimi ve doğrulanması.
+ *
+ * Post-proc çıkışı cihaz belleğinde tutulursa JPEG çözücüden encoder'a ve
+ * önizlemeye kadar kare sistem belleğine hiç inmez. Negotiation sonunda
+ * gerçekten ne olduğu pad caps'lerinden okunur ve raporlanır.
+ */
+
+/**
+ * Element ailesinin cihaz belleği caps'i (main.c ile aynı eşleme).
+ *
+ * @return const char* -> "video/x-raw(memory:VASurface)" (vaapi*) ya da
+ *                        "video/x-raw(memory:DMABuf)" (diğer GPU post-proc'lar)
+ *                        NULL -> factory yok
+ */
+const char* gpu_memory_caps_for(const char *factory);
+
+/* Elemanın sink template'i bu caps'i kabul ediyor mu (fakesink gibi ANY de kabul eder) */
+gboolean gpu_memory_accepts(GstElement *element, const char *caps_str);
+
+/**
+ * Pad'in negotiated caps özelliği.
+ * @return gchar* -> "VASurface", "DMABuf", "SystemMemory" ... (g_free)
+ *                   NULL -> caps henüz yok
+ */
+gchar* gpu_memory_pad_kind(GstPad *pad);
+
+/**
+ * Cihaz belleğini kabul etmeyen dal için açık indirme: post-proc ailesinden bir
+ * eleman ("<branch>_download") ve sistem belleği caps'i ("<branch>_sysmem"); böylece
+ * indirme raporda görünür bir adımdır. İkisi pipeline'a eklenir ve chain'in sonuna
+ * yazılır (*n iki artar), bağlamak çağırana kalır.
+ *
+ * @return gboolean -> FALSE: eleman oluşturulamadı
+ */
+gboolean gpu_memory_add_download(GstElement *pipeline, const char *post_name, const char *branch,
+                                 GstElement **chain, int *n);
+
+/**
+ * Bir dalın bellek yolunu basar: "src VASurface -> gpu_post VASurface -> ...".
+ * chain[0] için "src", diğerleri için "sink" pad'i okunur. Cihaz belleğinden
+ * sistem belleğine geçilen her adım bir indirmedir.
+ *
+ * @return int -> indirme sayısı, -1 -> dalın caps'i henüz yok
+ */
+int gpu_memory_report_branch(const char *prefix, const char *branch,
+                             GstElement **chain, int n);
+
+#endif // GPU_MEMORY_H
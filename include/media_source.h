@@ -0,0 +1,55 @@
+#ifndef MEDIA_SOURCE_H
+#define MEDIA_SOURCE_H
+
+#include <gst/gst.h>
+
+/*
+ * Görüntü girişi: kamera, sentetik test deseni ya da MJPEG dosyası.
+ *
+ * Kaynak tek bir bin olarak kurulur ve "src" pad'inden çözülmüş ham video
+ * verir; böylece sender ve main aynı hattı kamerasız sunucu ve CI
+ * ortamlarında da çalıştırabilir.
+ */
+
+typedef enum {
+    MEDIA_SOURCE_CAMERA = 0,    /* v4l2src, MJPG */
+    MEDIA_SOURCE_TEST,          /* videotestsrc, ham video */
+    MEDIA_SOURCE_FILE           /* ardışık JPEG karelerinden oluşan dosya */
+} MediaSourceKind;
+
+/* Alanlar GOption ile doğrudan doldurulur (media_source_add_options) */
+typedef struct {
+    gchar    *kind_name;        /* "camera", "test", "file" */
+    gchar    *device;           /* camera: v4l2 aygıtı */
+    gchar    *location;         /* file: MJPEG dosyası */
+    gint      width;            /* camera/test: çözünürlük (file kendi boyutunu kullanır) */
+    gint      height;
+    gint      fps;              /* file: oynatma hızı */
+    gboolean  loop;             /* file: sonunda başa dön */
+} MediaSourceConfig;
+
+/* camera, /dev/video0, 1280x720@30 */
+void media_source_default_config(MediaSourceConfig *cfg);
+void media_source_config_clear(MediaSourceConfig *cfg);
+
+/* --source, --device, --location, --width, --height, --fps, --loop seçeneklerini ekler */
+void media_source_add_options(GOptionContext *ctx, MediaSourceConfig *cfg);
+
+/**
+ * Yapılandırmadaki kaynak adını çözer.
+ * @return 0 -> geçerli, -1 -> bilinmeyen kaynak ya da eksik dosya yolu
+ */
+int media_source_get_kind(const MediaSourceConfig *cfg, MediaSourceKind *out);
+
+/**
+ * Kaynak bin'ini kurar.
+ *
+ * @param jpeg_dec  camera/file için JPEG çözücü fabrikası (örn. "vaapijpegdec");
+ *                  test kaynağında kullanılmaz
+ * @return GstElement* -> "src" ghost pad'li bin
+ *                        NULL -> geçersiz yapılandırma ya da eksik eleman
+ */
+GstElement* media_source_new(const MediaSourceConfig *cfg, const char *jpeg_dec,
+                             const char *name);
+
+#endif // MEDIA_SOURCE_H
@@ -0,0 +1,68 @@
+#ifndef PREVIEW_H
+#define PREVIEW_H
+
+#include <gst/gst.h>
+
+/*
+ * Göndericinin yerel önizleme dalı:
+ *
+ *   tee -> sızdıran kuyruk -> [ölçekleme / indirme -> caps] -> sink
+ *
+ * Kuyruk doluyken gelen karede en eskisi atılır (leaky=downstream); yavaş ya da
+ * takılan bir sink tee'yi, dolayısıyla yakalamayı ve encode dalını hiç bekletmez.
+ * İstenirse kareler kuyruğa girmeden seyreltilir (--preview-fps) ve küçültülür
+ * (--preview-width/--preview-height). --headless'ta dal hiç kurulmaz.
+ */
+
+typedef struct {
+    gint queue_frames;          /* kuyruk derinliği; dolunca en eski kare atılır */
+    gint width, height;         /* 0 -> kaynak boyutu (biri verilirse diğeri de gerekir) */
+    gint fps;                   /* 0 -> kaynak hızı */
+} PreviewConfig;
+
+/* Dal sayaçları; akış iş parçacıkları yazar, herhangi bir iş parçacığı okuyabilir */
+typedef struct {
+    guint64 frames;             /* sink'e giden */
+    guint64 dropped;            /* kuyruk doluyken atılan */
+    guint64 decimated;          /* fps sınırı yüzünden kuyruğa alınmayan */
+} PreviewStats;
+
+typedef struct PreviewBranch PreviewBranch;
+
+/* 2 karelik kuyruk, kaynak boyutu ve hızı */
+void preview_default_config(PreviewConfig *cfg);
+
+/* --preview-queue, --preview-width, --preview-height, --preview-fps seçeneklerini ekler */
+void preview_add_options(GOptionContext *ctx, PreviewConfig *cfg);
+
+/**
+ * Kuyruğu ve sink'i oluşturur; elemanlar preview_branch_attach'e kadar dalındır.
+ *
+ * @param sink_name  GPU sink fabrikası; NULL ya da oluşturulamazsa autovideosink
+ * @return PreviewBranch* -> dal, NULL -> eleman oluşturulamadı
+ */
+PreviewBranch* preview_branch_new(const PreviewConfig *cfg, const char *sink_name);
+
+/* Bellek planı için sink (gpu_memory_accepts) */
+GstElement* preview_branch_sink(PreviewBranch *p);
+
+/**
+ * Dalı pipeline'a ekleyip kuyruktan sink'e bağlar. Ölçekleme ya da sistem
+ * belleğine indirme gerekiyorsa araya converter ve caps filtresi girer.
+ *
+ * @param converter  ölçekleyici/indirici fabrika (GPU post-proc); NULL -> videoscale
+ * @param mem_caps   tee'deki cihaz belleği caps'i, NULL -> sistem belleği
+ * @param download   sink cihaz belleğini kabul etmiyor
+ * @param path       bellek raporu için dalın elemanları (en fazla 4)
+ * @return GstElement* -> tee'ye bağlanacak kuyruk, NULL -> eleman/bağlantı hatası
+ */
+GstElement* preview_branch_attach(PreviewBranch *p, GstElement *pipeline, const char *converter,
+                                  const char *mem_caps, gboolean download,
+                                  GstElement **path, int *path_len);
+
+void preview_branch_get_stats(PreviewBranch *p, PreviewStats *out);
+
+/* Pipeline bırakıldıktan sonra çağrılmalı: prob ve sinyaller dalı gösterir */
+void preview_branch_free(PreviewBranch *p);
+
+#endif // PREVIEW_H
@@ -0,0 +1,109 @@
+#ifndef RTCP_FEEDBACK_H
+#define RTCP_FEEDBACK_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* RTCP paket tipleri (RFC 3550, RFC 4585) */
+#define RTCP_PT_RR    201
+#define RTCP_PT_RTPFB 205   /* taşıma katmanı geri bildirimi */
+#define RTCP_PT_PSFB  206   /* payload'a özgü geri bildirim */
+
+/* FMT alanı */
+#define RTCP_FMT_PLI       1    /* PSFB: Picture Loss Indication */
+#define RTCP_FMT_BLOCK_NACK 15  /* RTPFB: FEC bloğu başına eksik shard maskesi (bu projeye özgü) */
+
+/* Tek rapor bloklu Receiver Report boyutu: 8 byte başlık + 24 byte blok */
+#define RTCP_RR_SIZE 32
+
+/* PLI: 12 byte ortak geri bildirim başlığı, FCI yok */
+#define RTCP_PLI_SIZE 12
+
+/*
+ * Blok NACK'i RFC 4585 Generic NACK'in FEC bloklarına uyarlanmış halidir. Alıcı
+ * serpiştirilmiş akışta kaybolan paketlerin sıra numarasını bilemez, ama blok
+ * kimliğini ve hangi shard'ların eksik olduğunu bilir. FCI girdisi başına:
+ *
+ *   0               1               2               3
+ *  +---------------+---------------+---------------+---------------+
+ *  |                          block_id                             |
+ *  +---------------+---------------+---------------+---------------+
+ *  |                 missing (64 bit, bit i -> shard i)            |
+ *  |                                                               |
+ *  +---------------+---------------+---------------+---------------+
+ *
+ * Alıcı yalnızca bloğu tamamlamaya yetecek kadar shard ister. Bloğun hiçbir
+ * paketi gelmediyse k bilinmez; o zaman bütün bitler 1'dir (RTCP_NACK_WHOLE_BLOCK).
+ */
+#define RTCP_NACK_FCI_SIZE   12
+#define RTCP_NACK_MAX_BLOCKS 16
+#define RTCP_NACK_WHOLE_BLOCK UINT64_MAX
+
+typedef struct {
+    uint32_t block_id;
+    uint64_t missing;
+} RtcpBlockNack;
+
+/*
+ * Alıcı tarafında RTP sıra numaralarından kayıp oranı çıkarır
+ * (RFC 3550 Ek A.1/A.3'ün sadeleştirilmiş hali). FEC öncesi, paket
+ * düzeyinde kayıp ölçülür; denetleyici parity'yi buna göre seçer.
+ */
+typedef struct {
+    int      started;
+    uint32_t media_ssrc;
+    uint16_t max_seq;
+    uint32_t cycles;            /* 16 bit taşma sayısı << 16 */
+    uint32_t base_seq;
+    uint32_t received;
+    uint32_t expected_prior;    /* son rapordaki beklenen */
+    uint32_t received_prior;    /* son rapordaki alınan */
+} RtcpLossTracker;
+
+/* Ayrıştırılmış geri bildirim mesajı */
+typedef struct {
+    int      type;              /* RTCP_PT_* */
+    int      fmt;               /* RTPFB/PSFB: RTCP_FMT_* */
+    uint32_t reporter_ssrc;
+    uint32_t media_ssrc;
+    uint8_t  fraction_lost;     /* son rapordan beri kayıp, /256 */
+    uint32_t cumulative_lost;
+    uint32_t highest_seq;       /* genişletilmiş en yüksek sıra numarası */
+    uint32_t jitter;
+    int      nack_count;        /* RTCP_FMT_BLOCK_NACK girdileri */
+    RtcpBlockNack nacks[RTCP_NACK_MAX_BLOCKS];
+} RtcpFeedback;
+
+void rtcp_loss_tracker_init(RtcpLossTracker *t);
+
+/* Alınan her RTP paketi için çağrılır; SSRC değişirse sayaçlar sıfırlanır */
+void rtcp_loss_tracker_update(RtcpLossTracker *t, uint32_t ssrc, uint16_t seq);
+
+/**
+ * Son rapordan bu yana kaybı içeren bir RR yazar ve aralığı kapatır.
+ * @return yazılan byte sayısı, 0 -> henüz paket yok ya da cap yetersiz
+ */
+size_t rtcp_build_receiver_report(RtcpLossTracker *t, uint32_t reporter_ssrc,
+                                  uint8_t *buf, size_t cap);
+
+/**
+ * media_ssrc için keyframe isteyen bir PLI yazar.
+ * @return yazılan byte sayısı (RTCP_PLI_SIZE), 0 -> cap yetersiz
+ */
+size_t rtcp_build_pli(uint32_t reporter_ssrc, uint32_t media_ssrc, uint8_t *buf, size_t cap);
+
+/**
+ * En fazla RTCP_NACK_MAX_BLOCKS bloğun eksik shard'larını isteyen bir NACK yazar.
+ * @return yazılan byte sayısı, 0 -> girdi yok ya da cap yetersiz
+ */
+size_t rtcp_build_block_nack(uint32_t reporter_ssrc, uint32_t media_ssrc,
+                             const RtcpBlockNack *nacks, int count, uint8_t *buf, size_t cap);
+
+/**
+ * Gelen RTCP datagramını ayrıştırır.
+ * @return 0 -> tanınan mesaj (RR, PLI ya da blok NACK), -1 -> kısa, bozuk ya da
+ *         desteklenmeyen tip
+ */
+int rtcp_parse_feedback(const uint8_t *buf, size_t len, RtcpFeedback *out);
+
+#endif // RTCP_FEEDBACK_H
@@ -0,0 +1,189 @@
+#ifndef RTP_FEC_H
+#define RTP_FEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "fec_block.h"
+
+/* RTP sabitleri */
+#define RTP_VERSION          2
+#define RTP_HEADER_SIZE      12
+#define RTP_FEC_PAYLOAD_TYPE 96      /* dinamik payload tipi */
+#define RTP_FEC_CLOCK_RATE   90000   /* video için 90 kHz zaman damgası */
+
+/*
+ * RTP başlığının hemen ardından gelen FEC başlığı (ağ byte sırası):
+ *
+ *   0               1               2               3
+ *  +---------------+---------------+---------------+---------------+
+ *  |                          block_id                             |
+ *  +---------------+---------------+---------------+---------------+
+ *  |  shard_index  |       k       |       r       |     flags     |
+ *  +---------------+---------------+---------------+---------------+
+ *  |          shard_size           |    version    |   reserved    |
+ *  +---------------+---------------+---------------+---------------+
+ *  |                         payload_len                           |
+ *  +---------------+---------------+---------------+---------------+
+ *  |                           crc32c                              |
+ *  +---------------+---------------+---------------+---------------+
+ *
+ * crc32c (Castagnoli, ISA-L crc32_iscsi) RTP zaman damgası ve SSRC'den başlayıp
+ * FEC başlığı ve shard'ın sonuna kadar her şeyi kapsar; RTP'nin ilk dört byte'ı
+ * (sürüm, marker, PT, sıra numarası) dışarıda kalır çünkü zamanlayıcı sıra
+ * numarasını paket hazırlandıktan sonra yazar. Tutmayan paket atılır; alıcı için
+ * kayıp bir shard'dan farkı yoktur ve FEC onu silinme olarak kurtarır.
+ *
+ * version parity düzenidir: 0 -> her r için Cauchy (eski göndericiler alanı sıfır
+ * yazar), 1 -> r <= 2 için P+Q (fec_codec.h). Alıcı yalnızca kendi sürümünü kabul eder.
+ */
+#define RTP_FEC_HEADER_SIZE  20
+#define RTP_FEC_WIRE_VERSION 1
+#define RTP_FEC_PACKET_OVERHEAD (RTP_HEADER_SIZE + RTP_FEC_HEADER_SIZE)
+
+/* flags alanı */
+#define RTP_FEC_FLAG_END_OF_FRAME   0x01  /* erişim biriminin son bloğu */
+#define RTP_FEC_FLAG_KEYFRAME       0x02  /* blok bir IDR erişim birimine ait */
+#define RTP_FEC_FLAG_START_OF_FRAME 0x04  /* erişim biriminin ilk bloğu */
+#define RTP_FEC_FLAG_AGGREGATE      0x08  /* payload birden çok küçük erişim birimi taşır (fec_aggregator.h) */
+#define RTP_FEC_FLAG_SLICE_END      0x10  /* slice grubunun son bloğu: birimin buraya kadarki kısmı NAL sınırında biter */
+#define RTP_FEC_FLAG_RETRANSMIT     0x20  /* NACK'e yanıt olarak yeniden gönderilen shard (kayıp sayımına girmez) */
+
+/* Varsayılan MTU'ya göre (IPv4 + UDP + RTP + FEC başlıkları düşülerek) en büyük shard */
+#define RTP_FEC_DEFAULT_MTU   1500
+#define RTP_FEC_IP_UDP_OVERHEAD 28
+
+typedef struct {
+    /* RTP */
+    uint16_t seq;
+    uint32_t timestamp;
+    uint32_t ssrc;
+    int      marker;
+    /* FEC */
+    uint32_t block_id;
+    uint8_t  shard_index;
+    uint8_t  k;
+    uint8_t  r;
+    uint8_t  flags;
+    uint16_t shard_size;
+    uint32_t payload_len;
+} RtpFecHeader;
+
+/* Ayrıştırılmış bir paket; payload alım tamponunu gösterir */
+typedef struct {
+    RtpFecHeader hdr;
+    const uint8_t *payload;
+    size_t payload_size;
+} RtpFecPacket;
+
+/* RTP + FEC başlığını buf'a yazar (RTP_FEC_PACKET_OVERHEAD byte); crc32c sıfır kalır */
+void rtp_fec_write_header(uint8_t *buf, const RtpFecHeader *h);
+
+/* Yazılmış başlık ve shard için crc32c'yi hesaplayıp başlığa yazar (shard ayrı tamponda olabilir) */
+void rtp_fec_seal(uint8_t *hdr, const uint8_t *shard, size_t shard_size);
+
+/* rtp_fec_parse dönüş değerleri */
+#define RTP_FEC_PARSE_INVALID  (-1)
+#define RTP_FEC_PARSE_CHECKSUM (-2)
+#define RTP_FEC_PARSE_VERSION  (-3)
+
+/**
+ * Alınan datagramı ayrıştırır, başlık alanlarını ve crc32c'yi doğrular.
+ * @return 0 -> geçerli paket, RTP_FEC_PARSE_INVALID -> kısa/bozuk ya da bizim
+ *         olmayan paket, RTP_FEC_PARSE_CHECKSUM -> içerik bozulmuş (silinme say),
+ *         RTP_FEC_PARSE_VERSION -> başka bir parity düzeniyle kodlanmış (gönderici sürümü farklı)
+ */
+int rtp_fec_parse(const uint8_t *buf, size_t len, RtpFecPacket *out);
+
+/* mtu için 64 byte'ın katı olan en büyük shard boyutu */
+int rtp_fec_max_shard_size(int mtu);
+
+/* --- UDP gönderici --- */
+
+typedef struct RtpFecSender RtpFecSender;
+
+typedef struct {
+    uint64_t packets;       /* gönderilen RTP paketi */
+    uint64_t bytes;         /* başlıklar dahil UDP payload byte'ı */
+    uint64_t blocks;        /* gönderilen FEC bloğu */
+    uint64_t syscalls;      /* sendmmsg/sendmsg çağrısı */
+    uint64_t gso_sends;     /* UDP GSO ile gönderilen mesaj */
+    uint64_t errors;        /* başarısız gönderim */
+} RtpFecSenderStats;
+
+/* NACK yanıtları (rtp_fec_sender_resend) */
+typedef struct {
+    uint64_t requests;      /* NACK'lenen blok */
+    uint64_t packets;       /* yeniden gönderilen shard paketi */
+    uint64_t bytes;
+    uint64_t misses;        /* geçmişten çıkmış ya da hiç görülmemiş blok */
+    uint64_t throttled;     /* bütçe yetmediği için gönderilmeyen shard */
+} RtpFecResendStats;
+
+/**
+ * host:port hedefine UDP soketi açar.
+ * use_gso sıfırdan farklıysa çekirdek UDP_SEGMENT desteği denenir;
+ * desteklenmiyorsa sessizce sendmmsg toplu gönderimine düşülür.
+ *
+ * @return RtpFecSender* -> hazır gönderici, NULL -> soket/adres hatası
+ */
+RtpFecSender* rtp_fec_sender_new(const char *host, int port, uint32_t ssrc, int use_gso);
+void rtp_fec_sender_free(RtpFecSender *s);
+
+/* GSO gerçekten etkin mi */
+int rtp_fec_sender_gso_enabled(const RtpFecSender *s);
+
+/**
+ * Kodlanmış bir bloğun k + r shard'ını tek bir toplu çağrıyla gönderir.
+ * Shard verisi kopyalanmaz; başlıklar iovec ile shard'ların önüne eklenir.
+ *
+ * @param flags      RTP_FEC_FLAG_* bitleri (END_OF_FRAME RTP marker'ını da ayarlar)
+ * @return 0 -> tüm paketler gönderildi, -1 -> gönderim hatası
+ */
+int rtp_fec_sender_send_block(RtpFecSender *s, const FecBlock *blk,
+                              uint32_t rtp_timestamp, uint8_t flags);
+
+/**
+ * Bloğun k + r paketini (başlık + shard kopyası) out'a stride aralıkla yazar;
+ * gönderim daha sonra rtp_fec_sender_send_packets ile yapılır (send_scheduler.h).
+ * Blok kimliği burada, RTP sıra numarası gönderimde atanır; böylece paketleme ve
+ * gönderim farklı iş parçacıklarında olabilir.
+ *
+ * @param stride  paketler arası byte (>= RTP_FEC_PACKET_OVERHEAD + shard_size)
+ * @return yazılan paket sayısı
+ */
+int rtp_fec_sender_pack_block(RtpFecSender *s, const FecBlock *blk, uint32_t rtp_timestamp,
+                              uint8_t flags, uint8_t *out, size_t stride);
+
+/**
+ * Paketlenmiş datagramlara sıra numarası yazıp tek sendmmsg çağrısıyla gönderir.
+ * @param count  en fazla FEC_MAX_TOTAL_SHARDS
+ * @return gönderilen paket sayısı, -1 -> gönderim hatası
+ */
+int rtp_fec_sender_send_packets(RtpFecSender *s, uint8_t *const *pkts, const size_t *lens,
+                                int count);
+
+void rtp_fec_sender_get_stats(const RtpFecSender *s, RtpFecSenderStats *out);
+
+/**
+ * Son `blocks` bloğun paketlerini NACK'lere yanıt için saklamaya başlar
+ * (send_block ve pack_block her paketi bir kez daha kopyalar). Yeniden gönderim
+ * budget_kbps hızında bir token bucket ile sınırlanır; 500 ms'lik birikim tek
+ * seferde harcanabilir.
+ *
+ * @return 0 -> etkin, -1 -> bellek yok
+ */
+int rtp_fec_sender_enable_history(RtpFecSender *s, unsigned int blocks, unsigned int budget_kbps);
+
+/**
+ * Geçmişteki bloğun missing maskesindeki shard'larını RTP_FEC_FLAG_RETRANSMIT ile
+ * yeniden gönderir; istek başına en fazla k shard (bloğu tamamlamaya yeten).
+ * Gönderim iş parçacıklarıyla eşzamanlı çağrılabilir; RTP sıra numarası
+ * tüketmez, alıcı bu paketleri kayıp sayımına katmaz.
+ *
+ * @return gönderilen paket sayısı, -1 -> geçmiş etkin değil
+ */
+int rtp_fec_sender_resend(RtpFecSender *s, uint32_t block_id, uint64_t missing);
+
+void rtp_fec_sender_get_resend_stats(RtpFecSender *s, RtpFecResendStats *out);
+
+#endif // RTP_FEC_H
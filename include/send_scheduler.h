@@ -0,0 +1,83 @@
+#ifndef SEND_SCHEDULER_H
+#define SEND_SCHEDULER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "fec_block.h"
+#include "rtp_fec.h"
+#include "telemetry.h"
+
+/*
+ * Shard gönderim zamanlayıcısı: ardışık FEC bloklarının paketlerini araya
+ * serpiştirir ve token bucket ile zamana yayar.
+ *
+ *   blok A: A0 A1 A2 ... A13        gönderim (derinlik 3):
+ *   blok B: B0 B1 B2 ... B13   ->   A0 B0 C0 A1 B1 C1 A2 B2 C2 ...
+ *   blok C: C0 C1 C2 ... C13
+ *
+ * Blokların paketleri arka arkaya gittiğinde tek bir kayıp patlaması (Wi-Fi,
+ * kuyruk taşması) bir bloktan r'den fazla shard götürebilir. Serpiştirme aynı
+ * patlamayı birkaç bloğa dağıtır, pacing ise patlamanın süresince giden paket
+ * sayısını azaltır; ikisi de parity oranını artırmadan kurtarılabilir kaybı büyütür.
+ *
+ * Serpiştirme beklemeyle değil, kuyrukta zaten bekleyen bloklar arasında yapılır:
+ * tek başına gelen küçük bir blok hiç bekletilmez, yalnızca hızla sınırlanır.
+ * Hız yoksa (rate_kbps 0) her blok geldiği anda tek seferde gider ve pencerede
+ * karışacak ikinci blok neredeyse hiç olmaz; serpiştirme pacing'le anlamlıdır.
+ * Kuyruk frame_interval_us içinde boşalacak şekilde hız gerektiğinde artırılır,
+ * böylece büyük IDR'lar bir kare süresinden fazla gecikmez.
+ *
+ * Alıcının yeniden sıralama derinliği (receiver --reorder) serpiştirme
+ * derinliğinden küçük olmamalıdır.
+ */
+
+typedef struct {
+    unsigned int interleave;        /* aynı anda serpiştirilen blok; 1 -> blok sırasıyla */
+    unsigned int rate_kbps;         /* token bucket hızı; 0 -> pacing yok */
+    unsigned int burst_packets;     /* kovanın en fazla biriktirdiği paket */
+    unsigned int frame_interval_us; /* kuyruk en geç bu sürede boşalır; 0 -> sınır yok */
+    unsigned int queue_blocks;      /* bekleyebilecek en fazla blok (doluysa enqueue bekler) */
+} SendSchedulerConfig;
+
+typedef struct {
+    uint64_t blocks;                /* kuyruğa alınan blok */
+    uint64_t packets;               /* gönderilen paket */
+    uint64_t interleaved;           /* başka bir bloğun paketinden hemen sonra giden paket */
+    uint64_t paced_waits;           /* token beklemesi */
+    uint64_t boosts;                /* kare aralığı sınırı yüzünden artırılan hız */
+    uint64_t queue_full;            /* kuyruk dolu olduğu için bekleyen enqueue */
+    uint64_t send_errors;
+    uint64_t max_delay_us;          /* kuyruğa giriş -> bloğun son paketi */
+    unsigned int max_queue;         /* görülen en uzun kuyruk (blok) */
+    unsigned int queued;            /* şu an kuyrukta bekleyen blok */
+    TelSummary delay;               /* blok başına kuyruğa giriş -> son paket (ns) */
+} SendSchedulerStats;
+
+typedef struct SendScheduler SendScheduler;
+
+/* interleave=4, pacing yok, burst 16 paket, 33 ms, 64 blok */
+void send_scheduler_default_config(SendSchedulerConfig *cfg);
+
+/**
+ * Gönderici için zamanlayıcı iş parçacığını başlatır.
+ * @return SendScheduler* -> hazır zamanlayıcı, NULL -> bellek / iş parçacığı hatası
+ */
+SendScheduler* send_scheduler_new(const SendSchedulerConfig *cfg, RtpFecSender *sender);
+
+/* Kuyruktaki bütün paketleri gönderir ve iş parçacığını durdurur */
+void send_scheduler_stop(SendScheduler *sch);
+void send_scheduler_free(SendScheduler *sch);
+
+/**
+ * Bloğun paketlerini kopyalayıp kuyruğa alır; blok çağrı dönünce bırakılabilir.
+ * Tek bir iş parçacığından (iş hattı sıralayıcısı) çağrılmalıdır.
+ *
+ * @param flags  RTP_FEC_FLAG_* bitleri
+ * @return 0 -> kuyrukta, -1 -> bellek yok
+ */
+int send_scheduler_enqueue(SendScheduler *sch, const FecBlock *blk,
+                           uint32_t rtp_timestamp, uint8_t flags);
+
+void send_scheduler_get_stats(SendScheduler *sch, SendSchedulerStats *out);
+
+#endif // SEND_SCHEDULER_H
@@ -0,0 +1,50 @@
+#ifndef SHARD_POOL_H
+#define SHARD_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+/* Slab ve shard hizalaması (AVX-512 satırı) */
+#define SHARD_POOL_ALIGN 64
+
+/* Bir FEC bloğunun tüm shard'larını tutan tek parça, hizalı bellek */
+typedef struct {
+    unsigned char   *base;      /* SHARD_POOL_ALIGN hizalı başlangıç */
+    size_t           capacity;  /* byte cinsinden slab boyutu */
+    uint32_t         index;     /* havuzdaki sıra; taşma slab'ları için UINT32_MAX */
+    _Atomic uint32_t next;      /* serbest liste bağlantısı (index + 1, 0 = son) */
+} ShardSlab;
+
+typedef struct ShardPool ShardPool;
+
+/* Havuz boyutlandırması için sayaçlar */
+typedef struct {
+    uint64_t hits;          /* hazır slab doğrudan kullanıldı */
+    uint64_t misses;        /* yeni bellek ayrıldı (ilk kullanım, büyüme veya taşma) */
+    uint64_t grows;         /* slab daha büyük bir bloğa göre yeniden ayrıldı */
+    uint64_t overflows;     /* tüm slab'lar kullanımdaydı, geçici slab verildi */
+    uint64_t in_use;        /* şu an dışarıda olan slab sayısı */
+    uint64_t slab_bytes;    /* şimdiye kadar görülen en büyük blok (byte) */
+} ShardPoolStats;
+
+/**
+ * En fazla max_slabs adet slab tutan havuz oluşturur.
+ * Bellek ilk kullanımda ayrılır ve en büyük blok boyutuna göre büyür.
+ */
+ShardPool* shard_pool_new(unsigned int max_slabs);
+void shard_pool_free(ShardPool *pool);
+
+/**
+ * En az bytes boyutunda bir slab döndürür (kilitsiz serbest listeden).
+ * @return ShardSlab*  -> kullanıma hazır slab
+ *                        NULL -> bellek yetersiz
+ */
+ShardSlab* shard_pool_acquire(ShardPool *pool, size_t bytes);
+
+/* Slab'ı havuza geri verir; taşma slab'ları doğrudan serbest bırakılır */
+void shard_pool_release(ShardPool *pool, ShardSlab *slab);
+
+void shard_pool_get_stats(ShardPool *pool, ShardPoolStats *out);
+
+#endif // SHARD_POOL_H
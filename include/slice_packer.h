@@ -0,0 +1,71 @@
+#ifndef SLICE_PACKER_H
+#define SLICE_PACKER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "shard_pool.h"
+
+/*
+ * Slice modu (--slice-mode): h264parse alignment=nal çıkışındaki NAL'ları,
+ * erişim biriminin tamamını beklemeden slice gruplarına toplayan kurucu.
+ *
+ *   AU:  [SPS PPS slice0] [slice1] [slice2 slice3]
+ *         grup 0            grup 1   grup 2 (son)
+ *
+ * Bir grup bir FEC işi olur; gruplar NAL sınırında bittiği için alıcı her
+ * grubu, birimin kalanı gelmeden decoder'a verebilir. Küçük NAL'lar blok
+ * kapasitesine (k * MTU shard'ı) kadar bir slab'da birleştirilir; kapasitenin
+ * yarısından büyük NAL'lar, açık slab'a sığmıyorsa kopyalanmadan kendi grubunu alır.
+ *
+ * Birimin son grubu GST_BUFFER_FLAG_MARKER'lı NAL'da (au_end) ya da sonraki
+ * birimin ilk NAL'ı gelince (zaman damgası değişti) kapanır; bu yüzden her
+ * zaman bir grup bekletilir ve son grup FEC_JOB_NOT_LAST taşımaz.
+ */
+
+/**
+ * Kurucunun ürettiği her grup için, push'u çağıran iş parçacığından sırayla
+ * çağrılır (fec_pipeline_submit'e doğrudan aktarılabilir).
+ *
+ * @param job_flags  FEC_JOB_NOT_FIRST / FEC_JOB_NOT_LAST (fec_pipeline.h)
+ * @param keyframe   birimde şimdiye kadar SPS ya da IDR slice görüldü
+ */
+typedef void (*SlicePackerEmit)(void *user, const unsigned char *data, size_t len,
+                                void *owner, void (*release_owner)(void *owner),
+                                uint32_t rtp_timestamp, int keyframe, int job_flags);
+
+typedef struct {
+    uint64_t nals_in;           /* gelen NAL buffer'ı */
+    uint64_t units;             /* açılan erişim birimi */
+    uint64_t groups_out;        /* gönderilen slice grubu */
+    uint64_t nals_copied;       /* bir slab'da birleştirilen NAL */
+    uint64_t close_marker;      /* birim MARKER ile kapandı */
+    uint64_t close_timestamp;   /* birim sonraki birimin zaman damgasıyla kapandı */
+} SlicePackerStats;
+
+typedef struct SlicePacker SlicePacker;
+
+/**
+ * @param capacity  grup başına en büyük payload (k * max_shard_size)
+ * @return SlicePacker* -> hazır kurucu, NULL -> bellek yok
+ */
+SlicePacker* slice_packer_new(size_t capacity, ShardPool *pool, SlicePackerEmit emit, void *user);
+
+/* Açık birimi kapatır (bekleyen grubu son grup olarak gönderir) ve serbest bırakır */
+void slice_packer_free(SlicePacker *sp);
+
+/**
+ * Tek bir NAL ekler; tek üretici iş parçacığından çağrılmalıdır. Kopyalanan
+ * NAL'ın owner'ı hemen bırakılır, kopyalanmayanlar owner ile emit'e aktarılır.
+ *
+ * @param au_end  NAL erişim biriminin sonuncusu (GST_BUFFER_FLAG_MARKER)
+ */
+void slice_packer_push(SlicePacker *sp, const unsigned char *data, size_t len,
+                       void *owner, void (*release_owner)(void *owner),
+                       uint32_t rtp_timestamp, int au_end);
+
+/* Açık birimi kapatır (akış sonu) */
+void slice_packer_flush(SlicePacker *sp);
+
+void slice_packer_get_stats(const SlicePacker *sp, SlicePackerStats *out);
+
+#endif // SLICE_PACKER_H
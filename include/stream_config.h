@@ -0,0 +1,64 @@
+#ifndef STREAM_CONFIG_H
+#define STREAM_CONFIG_H
+
+#include <gst/gst.h>
+#include "media_source.h"
+
+/*
+ * Çok akışlı gönderici yapılandırması (--streams dosyası, GKeyFile biçimi):
+ *
+ *   [stream cam0]
+ *   source=camera
+ *   device=/dev/video0
+ *   port=5004
+ *   cpus=0-1
+ *
+ *   [stream cam1]
+ *   device=/dev/video2
+ *   numa-node=1
+ *
+ * Her "stream" grubu ayrı bir yakalama -> encode -> FEC -> gönderim hattıdır.
+ * Grupta verilmeyen anahtarlar komut satırındaki değerlerden gelir; port
+ * verilmezse komut satırı portu akış sırasına göre STREAM_PORT_STRIDE artırılır.
+ * Anahtarlar: source, device, location, width, height, fps, loop, host, port,
+ * feedback-port, bitrate, cpus, numa-node.
+ */
+
+#define STREAM_PORT_STRIDE 10   /* akış başına port (RTP) ve port + 1 (RTCP) */
+
+typedef struct {
+    gchar             *name;
+    MediaSourceConfig  source;
+    gchar             *host;
+    gint               port;
+    gint               feedback_port;   /* 0 -> port + 1 */
+    gint               bitrate_kbps;    /* parity dahil gönderim bütçesi */
+    gchar             *cpus;            /* "0-3,8" biçiminde; NULL -> sabitlenmez */
+} StreamConfig;
+
+void stream_config_copy(StreamConfig *dst, const StreamConfig *src);
+void stream_config_clear(StreamConfig *cfg);
+
+/**
+ * Dosyadaki "stream" gruplarını dosyadaki sırayla okur.
+ *
+ * @param defaults  komut satırından gelen değerler (her akışa kopyalanır)
+ * @return GPtrArray* -> StreamConfig* dizisi, g_ptr_array_unref ile bırakılır
+ *                       NULL -> okunamadı ya da geçersiz değer (error dolu)
+ */
+GPtrArray* stream_config_load(const char *path, const StreamConfig *defaults,
+                              GError **error);
+
+/**
+ * NUMA düğümünün CPU listesini /sys/devices/system/node üzerinden okur.
+ * @return gchar* -> "0-7,16-23" gibi liste (g_free), NULL -> düğüm yok
+ */
+gchar* stream_config_numa_cpus(int node);
+
+/**
+ * Çağıran iş parçacığını cfg->cpus içindeki çekirdeklere sabitler.
+ * @return 0 -> sabitlendi ya da liste yok, -1 -> geçersiz liste / sistem hatası
+ */
+int stream_config_pin_thread(const StreamConfig *cfg);
+
+#endif // STREAM_CONFIG_H
@@ -0,0 +1,95 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+/*
+ * Sıcak yol ölçümleri ve dışa aktarım.
+ *
+ * TelHistogram HDR tarzı log-lineer bir histogramdır: her 2'nin kuvveti aralığı
+ * 2^TEL_HIST_SUB_BITS alt kutuya bölünür, değerler ~%6 hassasiyetle 1 ns'den
+ * ~68 s'ye kadar tutulur. Kayıt kilitsizdir (relaxed atomik toplama); okuyucu
+ * yazıcıları durdurmadan yaklaşık bir anlık görüntü alır.
+ *
+ * Dışa aktarım Prometheus metin biçimindedir (sürüm 0.0.4): toplayıcı geri
+ * çağırmalar her kazımada TelWriter'a aile aile yazar; sonuç 127.0.0.1 üzerindeki
+ * küçük bir HTTP uç noktasından (GET /metrics) ya da atomik olarak yeniden
+ * yazılan bir dosyadan okunur.
+ */
+
+#define TEL_HIST_SUB_BITS 4
+#define TEL_HIST_SUB      (1u << TEL_HIST_SUB_BITS)
+#define TEL_HIST_MAX_EXP  36                        /* 2^36 ns ~ 68 s; üstü son kutuda */
+#define TEL_HIST_BUCKETS  (TEL_HIST_SUB * (TEL_HIST_MAX_EXP - TEL_HIST_SUB_BITS + 2))
+
+typedef struct {
+    _Atomic uint64_t counts[TEL_HIST_BUCKETS];
+    _Atomic uint64_t count;
+    _Atomic uint64_t sum;
+    _Atomic uint64_t max;
+} TelHistogram;
+
+/* Histogramın okunmuş özeti (değerler kaydedildiği birimde, örn. ns) */
+typedef struct {
+    uint64_t count;
+    uint64_t sum;
+    uint64_t max;
+    uint64_t p50, p90, p99, p999;
+} TelSummary;
+
+void tel_hist_record(TelHistogram *h, uint64_t value);
+void tel_hist_summary(const TelHistogram *h, TelSummary *out);
+
+/* --- Prometheus metin yazıcısı --- */
+
+typedef struct {
+    char *data;
+    size_t len, cap;
+} TelWriter;
+
+/* "# HELP" ve "# TYPE" satırları; type: counter, gauge ya da summary */
+void tel_write_family(TelWriter *w, const char *name, const char *type, const char *help);
+
+/* labels: 'stream="cam0",stage="fec"' biçiminde ya da NULL */
+void tel_write_value(TelWriter *w, const char *name, const char *labels, double value);
+
+/* Özeti quantile satırları, _sum ve _count olarak yazar; scale ile çarpar (ns -> s: 1e-9) */
+void tel_write_summary(TelWriter *w, const char *name, const char *labels,
+                       const TelSummary *s, double scale);
+
+/* --- Dışa aktarıcı --- */
+
+/* Her kazımada sırayla çağrılır; aynı ailenin bütün örnekleri tek toplayıcıda yazılmalıdır */
+typedef void (*TelCollector)(void *user, TelWriter *w);
+
+typedef struct Telemetry Telemetry;
+
+Telemetry* telemetry_new(void);
+
+/* Uç noktayı durdurur ve serbest bırakır */
+void telemetry_free(Telemetry *tel);
+
+/* Toplayıcı ekler; uç nokta başlamadan önce çağrılmalıdır */
+int telemetry_add_collector(Telemetry *tel, TelCollector fn, void *user);
+
+/**
+ * Toplayıcıları çalıştırıp metni döndürür.
+ * @return char* -> NUL ile biten metin (free), NULL -> bellek yok
+ */
+char* telemetry_render(Telemetry *tel, size_t *len);
+
+/**
+ * 127.0.0.1:port üzerinde /metrics uç noktasını ayrı bir iş parçacığında açar.
+ * @return 0 -> dinleniyor, -1 -> soket/bind hatası
+ */
+int telemetry_serve(Telemetry *tel, int port);
+
+/**
+ * Metni path'e yazar; okuyucu yarım dosya görmesin diye geçici dosya + rename.
+ * @return 0 -> yazıldı, -1 -> dosya hatası
+ */
+int telemetry_write_file(Telemetry *tel, const char *path);
+
+#endif // TELEMETRY_H
@@ -0,0 +1,135 @@
+#include <gst/gst.h>
+#include <stdarg.h>
+#include <string.h>
+#include "encoder_profile.h"
+
+#define DEFAULT_SLICES 4
+
+void encoder_default_config(EncoderConfig *cfg) {
+    cfg->profile = ENCODER_PROFILE_LOW_LATENCY;
+    cfg->bitrate_kbps = 4000;
+    cfg->gop = 0;
+    cfg->slices = 0;
+    cfg->fps = 30;
+    cfg->intra_refresh = FALSE;
+}
+
+int encoder_profile_from_name(const char *name, EncoderProfile *out) {
+    if (!name || !strcmp(name, "low-latency") || !strcmp(name, "ultra-low-latency"))
+        *out = ENCODER_PROFILE_LOW_LATENCY;
+    else if (!strcmp(name, "quality"))
+        *out = ENCODER_PROFILE_QUALITY;
+    else
+        return -1;
+    return 0;
+}
+
+const char* encoder_profile_name(EncoderProfile profile) {
+    return profile == ENCODER_PROFILE_QUALITY ? "quality" : "low-latency";
+}
+
+/* Özellik varsa metin değerinden (enum/flags adları dahil) ayarlar */
+static gboolean set_arg(GstElement *enc, const char *prop, const char *fmt, ...) {
+    if (!g_object_class_find_property(G_OBJECT_GET_CLASS(enc), prop)) return FALSE;
+    va_list ap;
+    va_start(ap, fmt);
+    gchar *value = g_strdup_vprintf(fmt, ap);
+    va_end(ap);
+    gst_util_set_object_arg(G_OBJECT(enc), prop, value);
+    g_free(value);
+    return TRUE;
+}
+
+static void setup_x264(GstElement *enc, const EncoderConfig *c, guint gop, guint frame_ms) {
+    set_arg(enc, "bitrate", "%u", c->bitrate_kbps);
+    set_arg(enc, "key-int-max", "%u", gop);
+    if (c->profile == ENCODER_PROFILE_LOW_LATENCY) {
+        // zerolatency: lookahead ve kare tamponlama yok; sliced-threads kareyi slice'lara böler
+        set_arg(enc, "tune", "zerolatency");
+        set_arg(enc, "speed-preset", "ultrafast");
+        set_arg(enc, "bframes", "0");
+        set_arg(enc, "rc-lookahead", "0");
+        set_arg(enc, "sync-lookahead", "0");
+        set_arg(enc, "sliced-threads", "true");
+        // Intra-refresh'te x264 periyodik IDR üretmez: DROP politikası, IDR parity payı,
+        // yayına sonradan katılan alıcı ve simulcast katman geçişi IDR bekler
+        if (c->intra_refresh) set_arg(enc, "intra-refresh", "true");
+        set_arg(enc, "vbv-buf-capacity", "%u", frame_ms);
+    } else {
+        set_arg(enc, "speed-preset", "medium");
+        set_arg(enc, "bframes", "2");
+        set_arg(enc, "vbv-buf-capacity", "1000");
+    }
+}
+
+static void setup_vaapi(GstElement *enc, const EncoderConfig *c, guint gop, guint slices,
+                        guint frame_ms) {
+    set_arg(enc, "bitrate", "%u", c->bitrate_kbps);
+    set_arg(enc, "keyframe-period", "%u", gop);
+    if (c->profile == ENCODER_PROFILE_LOW_LATENCY) {
+        set_arg(enc, "rate-control", "cbr");
+        set_arg(enc, "max-bframes", "0");
+        set_arg(enc, "num-slices", "%u", slices);
+        set_arg(enc, "quality-level", "7");
+        set_arg(enc, "cpb-length", "%u", frame_ms);
+    } else {
+        set_arg(enc, "rate-control", "vbr");
+        set_arg(enc, "max-bframes", "2");
+        set_arg(enc, "quality-level", "2");
+        set_arg(enc, "cpb-length", "1000");
+    }
+}
+
+static void setup_nvenc(GstElement *enc, const EncoderConfig *c, guint gop, guint frame_ms) {
+    set_arg(enc, "bitrate", "%u", c->bitrate_kbps);
+    set_arg(enc, "gop-size", "%u", gop);
+    if (c->profile == ENCODER_PROFILE_LOW_LATENCY) {
+        set_arg(enc, "preset", "low-latency-hp");
+        set_arg(enc, "rc-mode", "cbr");
+        set_arg(enc, "bframes", "0");
+        set_arg(enc, "rc-lookahead", "0");
+        set_arg(enc, "zerolatency", "true");
+        // VBV kbit cinsinden: tek karelik tampon
+        set_arg(enc, "vbv-buffer-size", "%u", MAX(1u, c->bitrate_kbps * frame_ms / 1000));
+    } else {
+        set_arg(enc, "preset", "hq");
+        set_arg(enc, "rc-mode", "vbr");
+        set_arg(enc, "bframes", "2");
+    }
+}
+
+GstElement* encoder_new(const char *factory, const EncoderConfig *cfg, const char *name) {
+    GstElement *enc = gst_element_factory_make(factory ? factory : "x264enc", name);
+    if (!enc) return NULL;
+
+    gint fps = cfg->fps > 0 ? cfg->fps : 30;
+    guint frame_ms = MAX(1u, 1000u / (guint)fps);
+    guint gop = cfg->gop ? cfg->gop
+              : (guint)fps * (cfg->profile == ENCODER_PROFILE_LOW_LATENCY ? 1 : 2);
+    guint slices = cfg->slices ? cfg->slices : DEFAULT_SLICES;
+
+    if (!factory || !strcmp(factory, "x264enc"))
+        setup_x264(enc, cfg, gop, frame_ms);
+    else if (g_str_has_prefix(factory, "vaapi"))
+        setup_vaapi(enc, cfg, gop, slices, frame_ms);
+    else if (g_str_has_prefix(factory, "nv"))
+        setup_nvenc(enc, cfg, gop, frame_ms);
+    else
+        set_arg(enc, "bitrate", "%u", cfg->bitrate_kbps);
+    return enc;
+}
+
+gboolean encoder_set_bitrate(GstElement *enc, guint kbps) {
+    if (!enc || !g_object_class_find_property(G_OBJECT_GET_CLASS(enc), "bitrate")) return FALSE;
+    g_object_set(enc, "bitrate", kbps, NULL);
+    return TRUE;
+}
+
+gboolean encoder_force_keyframe(GstElement *enc) {
+    if (!enc) return FALSE;
+    GstStructure *st = gst_structure_new("GstForceKeyUnit",
+                                         "running-time", G_TYPE_UINT64, GST_CLOCK_TIME_NONE,
+                                         "all-headers", G_TYPE_BOOLEAN, TRUE,
+                                         "count", G_TYPE_UINT, 0u, NULL);
+    return gst_element_send_event(enc, gst_event_new_custom(GST_EVENT_CUSTOM_UPSTREAM, st));
+}
@@ -0,0 +1,269 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include "fec_aggregator.h"
+
+/* Slab'ın ilk satırında bloğun sahiplik kaydı, verisi hemen ardından */
+typedef struct {
+    ShardSlab *slab;
+    ShardPool *pool;
+} AggBatch;
+
+struct FecAggregator {
+    FecAggregatorConfig cfg;
+    ShardPool *pool;
+    FecAggregateEmit emit;
+    void *user;
+
+    /* lock bekleyen bloğu korur. emit bunun dışında, emit_lock altında çağrılır:
+       emit_lock lock bırakılmadan alındığı için işler sırayla ve tek tek gider, ama
+       geri basınçta bekleyen emit zamanlayıcıyı ve istatistik okuyucuyu durdurmaz */
+    pthread_mutex_t lock;
+    pthread_mutex_t emit_lock;
+    pthread_cond_t cond;
+    pthread_t timer;
+    int timer_started;
+    int stop;
+
+    /* Bekleyen blok */
+    AggBatch *batch;
+    unsigned char *data;
+    size_t len;
+    int units;
+    uint32_t first_ts;
+    uint64_t first_ns;
+
+    FecAggregatorStats stats;
+};
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void put_be32(unsigned char *p, uint32_t v) {
+    p[0] = v >> 24; p[1] = (unsigned char)(v >> 16); p[2] = (unsigned char)(v >> 8); p[3] = (unsigned char)v;
+}
+static uint32_t get_be32(const unsigned char *p) {
+    return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+}
+
+static void batch_release(void *owner) {
+    AggBatch *b = owner;
+    shard_pool_release(b->pool, b->slab);
+}
+
+/* emit'e gidecek bir iş; bir push en fazla iki iş üretir */
+typedef struct {
+    const unsigned char *data;
+    size_t len;
+    void *owner;
+    void (*release_owner)(void *owner);
+    uint32_t rtp_timestamp;
+    int keyframe;
+    int aggregated;
+} AggEmit;
+
+/* Kilit tutulurken: bekleyen bloğu kurucudan ayırıp out'a ekler */
+static void take_locked(FecAggregator *agg, AggEmit *out, int *n) {
+    if (!agg->batch) return;
+    AggBatch *b = agg->batch;
+    out[(*n)++] = (AggEmit){ (const unsigned char *)b + SHARD_POOL_ALIGN, agg->len,
+                             b, batch_release, agg->first_ts, 0, 1 };
+    agg->batch = NULL;
+    agg->data = NULL;
+    agg->len = 0;
+    agg->units = 0;
+    agg->stats.blocks_out++;
+}
+
+/* lock tutulurken çağrılır ve onu bırakır; işler emit'e lock dışında, sırayla gider */
+static void unlock_and_emit(FecAggregator *agg, const AggEmit *out, int n) {
+    if (!n) {
+        pthread_mutex_unlock(&agg->lock);
+        return;
+    }
+    pthread_mutex_lock(&agg->emit_lock);
+    pthread_mutex_unlock(&agg->lock);
+    for (int i = 0; i < n; i++)
+        agg->emit(agg->user, out[i].data, out[i].len, out[i].owner, out[i].release_owner,
+                  out[i].rtp_timestamp, out[i].keyframe, out[i].aggregated);
+    pthread_mutex_unlock(&agg->emit_lock);
+}
+
+static int batch_open(FecAggregator *agg, uint32_t rtp_ts) {
+    ShardSlab *slab = shard_pool_acquire(agg->pool, SHARD_POOL_ALIGN + agg->cfg.capacity);
+    if (!slab) return -1;
+    AggBatch *b = (AggBatch *)slab->base;
+    b->slab = slab;
+    b->pool = agg->pool;
+    agg->batch = b;
+    agg->data = slab->base + SHARD_POOL_ALIGN;
+    agg->len = 0;
+    agg->units = 0;
+    agg->first_ts = rtp_ts;
+    agg->first_ns = now_ns();
+    pthread_cond_signal(&agg->cond);
+    return 0;
+}
+
+/* Gecikme sınırını bekleyen iş parçacığı; yeni blok açılınca uyanır */
+static void* timer_main(void *arg) {
+    FecAggregator *agg = arg;
+    pthread_mutex_lock(&agg->lock);
+    while (!agg->stop) {
+        if (!agg->batch) {
+            pthread_cond_wait(&agg->cond, &agg->lock);
+            continue;
+        }
+        uint64_t deadline = agg->first_ns + (uint64_t)agg->cfg.deadline_us * 1000u;
+        if (now_ns() >= deadline) {
+            AggEmit out[1];
+            int n = 0;
+            agg->stats.flush_deadline++;
+            take_locked(agg, out, &n);
+            unlock_and_emit(agg, out, n);
+            pthread_mutex_lock(&agg->lock);
+            continue;
+        }
+        struct timespec ts = {
+            .tv_sec = (time_t)(deadline / 1000000000ull),
+            .tv_nsec = (long)(deadline % 1000000000ull),
+        };
+        pthread_cond_timedwait(&agg->cond, &agg->lock, &ts);
+    }
+    pthread_mutex_unlock(&agg->lock);
+    return NULL;
+}
+
+FecAggregator* fec_aggregator_new(const FecAggregatorConfig *cfg, ShardPool *pool,
+                                  FecAggregateEmit emit, void *user) {
+    FecAggregator *agg = calloc(1, sizeof(*agg));
+    if (!agg) return NULL;
+    agg->cfg = *cfg;
+    agg->pool = pool;
+    agg->emit = emit;
+    agg->user = user;
+    pthread_mutex_init(&agg->lock, NULL);
+    pthread_mutex_init(&agg->emit_lock, NULL);
+
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&agg->cond, &attr);
+    pthread_condattr_destroy(&attr);
+
+    if (agg->cfg.deadline_us > 0 && agg->cfg.capacity > FEC_AGG_RECORD_HEADER) {
+        if (pthread_create(&agg->timer, NULL, timer_main, agg) != 0) {
+            fec_aggregator_free(agg);
+            return NULL;
+        }
+        agg->timer_started = 1;
+    }
+    return agg;
+}
+
+void fec_aggregator_free(FecAggregator *agg) {
+    if (!agg) return;
+    AggEmit out[1];
+    int n = 0;
+    pthread_mutex_lock(&agg->lock);
+    take_locked(agg, out, &n);
+    agg->stop = 1;
+    pthread_cond_signal(&agg->cond);
+    unlock_and_emit(agg, out, n);
+    if (agg->timer_started) pthread_join(agg->timer, NULL);
+    pthread_cond_destroy(&agg->cond);
+    pthread_mutex_destroy(&agg->emit_lock);
+    pthread_mutex_destroy(&agg->lock);
+    free(agg);
+}
+
+void fec_aggregator_push(FecAggregator *agg, const unsigned char *data, size_t len,
+                         void *owner, void (*release_owner)(void *owner),
+                         uint32_t rtp_timestamp, int keyframe) {
+    size_t need = FEC_AGG_RECORD_HEADER + len;
+    const AggEmit unit = { data, len, owner, release_owner, rtp_timestamp, keyframe, 0 };
+    AggEmit out[2];
+    int n = 0;
+
+    pthread_mutex_lock(&agg->lock);
+    agg->stats.units_in++;
+
+    // IDR ve büyük birimler kendi bloklarını alır; sıra korunsun diye önce bekleyen gider
+    if (!agg->timer_started || keyframe || need > agg->cfg.capacity / 2) {
+        if (agg->batch) agg->stats.flush_bypass++;
+        take_locked(agg, out, &n);
+        out[n++] = unit;
+        unlock_and_emit(agg, out, n);
+        return;
+    }
+
+    if (agg->batch && agg->len + need > agg->cfg.capacity) {
+        agg->stats.flush_full++;
+        take_locked(agg, out, &n);
+    }
+    if (!agg->batch && batch_open(agg, rtp_timestamp) < 0) {
+        // Slab alınamadı: birimi toplamadan gönder
+        out[n++] = unit;
+        unlock_and_emit(agg, out, n);
+        return;
+    }
+
+    unsigned char *rec = agg->data + agg->len;
+    put_be32(rec, (uint32_t)len);
+    put_be32(rec + 4, rtp_timestamp);
+    memcpy(rec + FEC_AGG_RECORD_HEADER, data, len);
+    agg->len += need;
+    agg->units++;
+    agg->stats.units_aggregated++;
+
+    // Bir kayıt başlığı bile sığmıyorsa beklemenin anlamı yok
+    if (agg->len + FEC_AGG_RECORD_HEADER >= agg->cfg.capacity) {
+        agg->stats.flush_full++;
+        take_locked(agg, out, &n);
+    }
+    unlock_and_emit(agg, out, n);
+
+    if (release_owner) release_owner(owner);
+}
+
+void fec_aggregator_flush(FecAggregator *agg) {
+    AggEmit out[1];
+    int n = 0;
+    pthread_mutex_lock(&agg->lock);
+    take_locked(agg, out, &n);
+    unlock_and_emit(agg, out, n);
+}
+
+void fec_aggregator_get_stats(FecAggregator *agg, FecAggregatorStats *out) {
+    pthread_mutex_lock(&agg->lock);
+    *out = agg->stats;
+    pthread_mutex_unlock(&agg->lock);
+}
+
+int fec_aggregate_parse(const unsigned char *buf, size_t len,
+                        void (*record)(void *user, const unsigned char *data, size_t len,
+                                       uint32_t rtp_timestamp),
+                        void *user) {
+    // Önce tüm kayıtları doğrula: bozuk blokta yarım teslim yapılmaz
+    int count = 0;
+    size_t off = 0;
+    while (off < len) {
+        if (len - off < FEC_AGG_RECORD_HEADER) return -1;
+        size_t rlen = get_be32(buf + off);
+        if (rlen > len - off - FEC_AGG_RECORD_HEADER) return -1;
+        off += FEC_AGG_RECORD_HEADER + rlen;
+        count++;
+    }
+    for (off = 0; off < len; ) {
+        size_t rlen = get_be32(buf + off);
+        if (record) record(user, buf + off + FEC_AGG_RECORD_HEADER, rlen, get_be32(buf + off + 4));
+        off += FEC_AGG_RECORD_HEADER + rlen;
+    }
+    return count;
+}
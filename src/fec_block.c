@@ -0,0 +1,87 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fec_block.h"
+
+int fec_block_prepare(FecBlock *blk, ShardPool *pool, int k, int r,
+                      const unsigned char *data, size_t len, int zero_copy) {
+    if (k < 1 || k > FEC_MAX_DATA_SHARDS || r < 1 || r > FEC_MAX_PARITY_SHARDS || len == 0)
+        return -1;
+
+    memset(blk, 0, sizeof(*blk));
+    blk->k = k;
+    blk->r = r;
+    blk->payload_len = len;
+    blk->zero_copy = zero_copy;
+
+    // Shard boyutu: veriyi k parçaya böl, slab içinde hizalı kalsın diye 64'ün katına yuvarla
+    size_t shard_size = (len + k - 1) / k;
+    shard_size = (shard_size + SHARD_POOL_ALIGN - 1) & ~(size_t)(SHARD_POOL_ALIGN - 1);
+    blk->shard_size = (int)shard_size;
+
+    size_t full = len / shard_size;     // kaynağı tamamen dolduran shard sayısı
+    size_t tail = len % shard_size;     // son shard'daki veri
+
+    // Sıfır kopya: slab = r parity + 1 kuyruk + 1 ortak sıfır shard
+    // Kopya modu:   slab = k veri + r parity
+    int slab_shards = zero_copy ? r + 2 : k + r;
+    blk->slab = shard_pool_acquire(pool, (size_t)slab_shards * shard_size);
+    if (!blk->slab) return -1;
+    unsigned char *base = blk->slab->base;
+
+    if (zero_copy) {
+        unsigned char *tail_shard = base + (size_t)r * shard_size;
+        unsigned char *zero_shard = base + (size_t)(r + 1) * shard_size;
+
+        for (size_t i = 0; i < full; i++)
+            blk->shards[i] = (unsigned char *)data + i * shard_size;
+
+        size_t next = full;
+        if (tail) {
+            memcpy(tail_shard, data + full * shard_size, tail);
+            memset(tail_shard + tail, 0, shard_size - tail);
+            blk->shards[next++] = tail_shard;
+        }
+        if (next < (size_t)k) {
+            // Veri taşımayan shard'lar aynı sıfır bloğu paylaşır (yalnızca okunur)
+            memset(zero_shard, 0, shard_size);
+            for (; next < (size_t)k; next++)
+                blk->shards[next] = zero_shard;
+        }
+        for (int i = 0; i < r; i++)
+            blk->shards[k + i] = base + (size_t)i * shard_size;
+    } else {
+        for (int i = 0; i < k + r; i++)
+            blk->shards[i] = base + (size_t)i * shard_size;
+
+        size_t copied = full * shard_size;
+        memcpy(base, data, copied);
+        if (tail) {
+            memcpy(base + copied, data + copied, tail);
+            copied += tail;
+        }
+        // Veri sonrasını (kısmi shard + boş shard'lar) sıfırla
+        memset(base + copied, 0, (size_t)k * shard_size - copied);
+    }
+    return 0;
+}
+
+void fec_block_set_owner(FecBlock *blk, void *owner, void (*release_owner)(void *owner)) {
+    blk->owner = owner;
+    blk->release_owner = release_owner;
+}
+
+void fec_block_encode(FecBlock *blk, const FecEncoder *enc) {
+    fec_encode(enc, blk->shard_size, blk->shards);
+}
+
+void fec_block_release(FecBlock *blk, ShardPool *pool) {
+    if (blk->slab) {
+        shard_pool_release(pool, blk->slab);
+        blk->slab = NULL;
+    }
+    if (blk->release_owner)
+        blk->release_owner(blk->owner);
+    blk->owner = NULL;
+    blk->release_owner = NULL;
+}
@@ -0,0 +1,253 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <isa-l.h>
+#include "fec_codec.h"
+
+/* (k, r) -> bağlam önbelleği. Okuma kilitsiz, ekleme mutex altında yapılır. */
+static _Atomic(FecEncoder *) enc_cache[FEC_MAX_DATA_SHARDS + 1][FEC_MAX_PARITY_SHARDS + 1];
+static pthread_mutex_t enc_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void fec_encoder_free(FecEncoder *enc) {
+    if (!enc) return;
+    free(enc->encode_matrix);
+    free(enc->gftbls);
+    free(enc);
+}
+
+static FecEncoder* fec_encoder_build(int k, int r) {
+    FecEncoder *enc = calloc(1, sizeof(*enc));
+    if (!enc) return NULL;
+    enc->k = k;
+    enc->r = r;
+    enc->encode_matrix = malloc((size_t)(k + r) * k);
+    enc->gftbls = malloc((size_t)k * r * 32);
+    if (!enc->encode_matrix || !enc->gftbls) {
+        fec_encoder_free(enc);
+        return NULL;
+    }
+
+    // Önce matris üretilmeli, tablolar parity satırlarından türetilir.
+    // gf_gen_rs_matrix'in ilk iki parity satırı 1, 1, 1, ... ve 1, 2, 4, ...'tür:
+    // xor_gen / pq_gen'in ürettiği P ve Q ile aynı; r > 2 için Cauchy (her k için MDS)
+    if (r <= 2) {
+        gf_gen_rs_matrix(enc->encode_matrix, k + r, k);
+        // xor_gen en az iki kaynak, pq_gen en az iki kaynak ister
+        if (k >= 2) enc->code = r == 1 ? FEC_CODE_XOR : FEC_CODE_PQ;
+    } else {
+        gf_gen_cauchy1_matrix(enc->encode_matrix, k + r, k);
+    }
+    ec_init_tables(k, r, &enc->encode_matrix[k * k], enc->gftbls);
+    return enc;
+}
+
+const FecEncoder* fec_encoder_get(int k, int r) {
+    if (k < 1 || k > FEC_MAX_DATA_SHARDS || r < 1 || r > FEC_MAX_PARITY_SHARDS)
+        return NULL;
+
+    FecEncoder *enc = atomic_load_explicit(&enc_cache[k][r], memory_order_acquire);
+    if (enc) return enc;
+
+    pthread_mutex_lock(&enc_cache_lock);
+    enc = atomic_load_explicit(&enc_cache[k][r], memory_order_relaxed);
+    if (!enc) {
+        enc = fec_encoder_build(k, r);
+        if (enc) atomic_store_explicit(&enc_cache[k][r], enc, memory_order_release);
+    }
+    pthread_mutex_unlock(&enc_cache_lock);
+    return enc;
+}
+
+/*
+ * xor_gen / pq_gen'in SIMD sürümleri hizalı yükleme kullanır: hizasız bir işaretçide
+ * hata dönmek yerine çökerler. Sıfır kopya veri shard'ları GstBuffer belleğinin
+ * herhangi bir yerini gösterebildiği için her işaretçi ve len önceden denetlenir.
+ */
+static int simd_aligned(void *const *vects, int n, int len) {
+    if (len <= 0 || len % FEC_SIMD_ALIGN) return 0;
+    for (int i = 0; i < n; i++)
+        if ((uintptr_t)vects[i] % FEC_SIMD_ALIGN) return 0;
+    return 1;
+}
+
+void fec_encode(const FecEncoder *enc, int len, unsigned char **shards) {
+    if (enc->code != FEC_CODE_RS && simd_aligned((void **)shards, enc->k + enc->r, len)) {
+        // Hızlı yollar kabul etmedikleri girdide (vektör sayısı) yine de hata dönebilir
+        if (enc->code == FEC_CODE_XOR && xor_gen(enc->k + 1, len, (void **)shards) == 0) return;
+        if (enc->code == FEC_CODE_PQ && pq_gen(enc->k + 2, len, (void **)shards) == 0) return;
+    }
+    ec_encode_data(len, enc->k, enc->r, enc->gftbls, shards, &shards[enc->k]);
+}
+
+/* --- Çözme --- */
+
+#define FEC_DECODER_DEFAULT_SLOTS 64
+
+typedef struct {
+    int valid;
+    int k, r;
+    unsigned long long mask;                        /* alınan shard'ların bit maskesi */
+    int nerrs;                                      /* eksik veri shard sayısı */
+    unsigned char src_idx[FEC_MAX_DATA_SHARDS];     /* kullanılan ilk k sağlam shard */
+    unsigned char err_idx[FEC_MAX_DATA_SHARDS];     /* yeniden üretilecek veri shard'ları */
+    unsigned char *gftbls;                          /* 32 * k * nerrs byte */
+} FecDecodeEntry;
+
+struct FecDecoder {
+    FecDecodeEntry *slots;
+    unsigned int nslots;
+    FecDecoderStats stats;
+};
+
+FecDecoder* fec_decoder_new(unsigned int cache_slots) {
+    FecDecoder *dec = calloc(1, sizeof(*dec));
+    if (!dec) return NULL;
+    dec->nslots = cache_slots ? cache_slots : FEC_DECODER_DEFAULT_SLOTS;
+    dec->slots = calloc(dec->nslots, sizeof(FecDecodeEntry));
+    if (!dec->slots) {
+        free(dec);
+        return NULL;
+    }
+    return dec;
+}
+
+void fec_decoder_free(FecDecoder *dec) {
+    if (!dec) return;
+    for (unsigned int i = 0; i < dec->nslots; i++)
+        free(dec->slots[i].gftbls);
+    free(dec->slots);
+    free(dec);
+}
+
+/* Desen için çözme tablolarını üretir; tekil matriste -1 döner */
+static int fec_decode_entry_build(FecDecodeEntry *e, int k, int r, unsigned long long mask) {
+    const FecEncoder *enc = fec_encoder_get(k, r);
+    if (!enc) return -1;
+
+    unsigned char b[FEC_MAX_DATA_SHARDS * FEC_MAX_DATA_SHARDS];
+    unsigned char d[FEC_MAX_DATA_SHARDS * FEC_MAX_DATA_SHARDS];
+    unsigned char rows[FEC_MAX_DATA_SHARDS * FEC_MAX_DATA_SHARDS];
+
+    int nsrc = 0, nerrs = 0;
+    for (int i = 0; i < k + r && nsrc < k; i++)
+        if (mask & (1ULL << i)) e->src_idx[nsrc++] = (unsigned char)i;
+    if (nsrc < k) return -1;
+    for (int i = 0; i < k; i++)
+        if (!(mask & (1ULL << i))) e->err_idx[nerrs++] = (unsigned char)i;
+
+    // Sağlam shard'lara karşılık gelen satırlardan k x k matris kur ve tersini al
+    for (int i = 0; i < k; i++)
+        memcpy(&b[k * i], &enc->encode_matrix[k * e->src_idx[i]], k);
+    if (gf_invert_matrix(b, d, k) < 0) return -1;
+
+    // Ters matrisin eksik veri shard'larına ait satırları çözme katsayılarıdır
+    for (int i = 0; i < nerrs; i++)
+        memcpy(&rows[k * i], &d[k * e->err_idx[i]], k);
+
+    unsigned char *tbls = realloc(e->gftbls, (size_t)k * nerrs * 32);
+    if (!tbls) return -1;
+    e->gftbls = tbls;
+    ec_init_tables(k, nerrs, rows, e->gftbls);
+
+    e->k = k;
+    e->r = r;
+    e->mask = mask;
+    e->nerrs = nerrs;
+    e->valid = 1;
+    return 0;
+}
+
+/*
+ * XOR / P+Q kodunda P = D0 ^ ... ^ Dk-1 olduğu için tek eksik veri shard'ı
+ * kalanların ve P'nin XOR'udur; matris ve tablo gerekmez.
+ * @return 0 -> çözüldü, -1 -> desen uygun değil (genel yola düşülür)
+ */
+static int reconstruct_xor(FecDecoder *dec, int k, int r, int len,
+                           unsigned char **shards, const unsigned char *present) {
+    if (r > 2 || !present[k]) return -1;
+    const FecEncoder *enc = fec_encoder_get(k, r);
+    if (!enc || enc->code == FEC_CODE_RS) return -1;
+
+    int missing = -1;
+    for (int i = 0; i < k; i++) {
+        if (present[i]) continue;
+        if (missing >= 0) return -1;
+        missing = i;
+    }
+    void *vects[FEC_MAX_DATA_SHARDS + 1];
+    int n = 0;
+    for (int i = 0; i < k; i++)
+        if (i != missing) vects[n++] = shards[i];
+    vects[n++] = shards[k];
+    vects[n++] = shards[missing];
+    if (!simd_aligned(vects, n, len) || xor_gen(n, len, vects) != 0) return -1;
+    dec->stats.decodes++;
+    dec->stats.xor_decodes++;
+    return 0;
+}
+
+int fec_decoder_reconstruct(FecDecoder *dec, int k, int r, int len,
+                            unsigned char **shards, const unsigned char *present) {
+    if (k < 1 || k > FEC_MAX_DATA_SHARDS || r < 0 || r > FEC_MAX_PARITY_SHARDS)
+        return -1;
+
+    unsigned long long mask = 0;
+    int have = 0, data_missing = 0;
+    for (int i = 0; i < k + r; i++) {
+        if (present[i]) {
+            mask |= 1ULL << i;
+            have++;
+        } else if (i < k) {
+            data_missing = 1;
+        }
+    }
+    if (!data_missing) return 0;
+    if (have < k || r == 0) {
+        dec->stats.failures++;
+        return -1;
+    }
+    if (reconstruct_xor(dec, k, r, len, shards, present) == 0) return 0;
+
+    // Yalnızca kararı etkileyen kısım anahtar olur: ilk k sağlam shard
+    unsigned long long key = 0;
+    for (int i = 0, n = 0; i < k + r && n < k; i++)
+        if (mask & (1ULL << i)) { key |= 1ULL << i; n++; }
+
+    unsigned long long h = key * 0x9E3779B97F4A7C15ULL ^ (unsigned long long)(k << 8 | r);
+    FecDecodeEntry *e = &dec->slots[(h >> 32) % dec->nslots];
+    if (e->valid && e->k == k && e->r == r && e->mask == key) {
+        dec->stats.cache_hits++;
+    } else {
+        e->valid = 0;
+        if (fec_decode_entry_build(e, k, r, key) < 0) {
+            dec->stats.failures++;
+            return -1;
+        }
+        dec->stats.cache_misses++;
+    }
+
+    unsigned char *src[FEC_MAX_DATA_SHARDS];
+    unsigned char *out[FEC_MAX_DATA_SHARDS];
+    for (int i = 0; i < k; i++) src[i] = shards[e->src_idx[i]];
+    for (int i = 0; i < e->nerrs; i++) out[i] = shards[e->err_idx[i]];
+    ec_encode_data(len, k, e->nerrs, e->gftbls, src, out);
+    dec->stats.decodes++;
+    return 0;
+}
+
+void fec_decoder_get_stats(const FecDecoder *dec, FecDecoderStats *out) {
+    *out = dec->stats;
+}
+
+void fec_codec_shutdown(void) {
+    pthread_mutex_lock(&enc_cache_lock);
+    for (int k = 0; k <= FEC_MAX_DATA_SHARDS; k++) {
+        for (int r = 0; r <= FEC_MAX_PARITY_SHARDS; r++) {
+            fec_encoder_free(atomic_exchange(&enc_cache[k][r], NULL));
+        }
+    }
+    pthread_mutex_unlock(&enc_cache_lock);
+}
@@ -0,0 +1,163 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "fec_controller.h"
+#include "fec_codec.h"
+
+/* Sıfır kayıpta bile tahmin bu değerin altına inmez (ölçüm aralığı sonlu) */
+#define LOSS_FLOOR 1e-4
+
+/* Bit hızı AIMD adımları: tıkanıklıkta çarpımsal düşüş, temiz raporda toplamsal artış */
+#define RATE_DECREASE 0.85
+#define RATE_INCREASE 0.05
+#define RATE_SCALE_MIN 0.1     /* uzun tıkanıklıktan sonra da birkaç raporda toparlanabilsin */
+
+struct FecController {
+    FecControllerConfig cfg;
+    pthread_mutex_t lock;           /* yalnızca rapor tarafı için */
+    double loss;
+    double rate_scale;              /* bütçenin tıkanıklıktan sonra kalan kısmı */
+    unsigned long long reports;
+
+    /* Akış iş parçacığının okuduğu seçimler */
+    _Atomic int r_delta;
+    _Atomic int r_keyframe;
+    _Atomic int target_kbps;
+};
+
+void fec_controller_default_config(FecControllerConfig *cfg) {
+    cfg->k = 10;
+    cfg->r_min = 1;
+    cfg->r_max = 4;
+    cfg->target_block_loss = 1e-3;
+    cfg->keyframe_block_loss = 1e-5;
+    cfg->alpha_up = 0.5;
+    cfg->alpha_down = 0.1;
+    cfg->adaptive = 1;
+    cfg->bitrate_kbps = 0;
+    cfg->min_bitrate_kbps = 0;
+    cfg->congestion_loss = 0.05;
+}
+
+/* n paketlik blokta r'den fazla kayıp olasılığı (bağımsız kayıp varsayımı) */
+static double block_loss_probability(int n, int r, double p) {
+    if (p <= 0.0) return 0.0;
+    if (p >= 1.0) return 1.0;
+    double q = 1.0 - p;
+    double term = 1.0;              // C(n,0) p^0 q^n
+    for (int i = 0; i < n; i++) term *= q;
+    double below = 0.0;
+    for (int i = 0; i <= r && i <= n; i++) {
+        below += term;
+        term *= (double)(n - i) / (double)(i + 1) * p / q;
+    }
+    double tail = 1.0 - below;
+    return tail < 0.0 ? 0.0 : tail;
+}
+
+static int pick_parity(const FecControllerConfig *cfg, double p, double target) {
+    for (int r = cfg->r_min; r < cfg->r_max; r++) {
+        if (block_loss_probability(cfg->k + r, r, p) <= target) return r;
+    }
+    return cfg->r_max;
+}
+
+/* Bütçeden parity payını ayırıp tıkanıklık katsayısını uygular */
+static int media_bitrate(const FecControllerConfig *cfg, int r, double scale) {
+    if (cfg->bitrate_kbps <= 0) return 0;
+    int kbps = (int)(cfg->bitrate_kbps * (double)cfg->k / (cfg->k + r) * scale);
+    return kbps < cfg->min_bitrate_kbps ? cfg->min_bitrate_kbps : kbps;
+}
+
+FecController* fec_controller_new(const FecControllerConfig *cfg) {
+    FecController *ctl = calloc(1, sizeof(*ctl));
+    if (!ctl) return NULL;
+    ctl->cfg = *cfg;
+
+    FecControllerConfig *c = &ctl->cfg;
+    if (c->k < 1) c->k = 1;
+    if (c->k > FEC_MAX_DATA_SHARDS) c->k = FEC_MAX_DATA_SHARDS;
+    if (c->r_min < 1) c->r_min = 1;
+    if (c->r_max > FEC_MAX_PARITY_SHARDS) c->r_max = FEC_MAX_PARITY_SHARDS;
+    if (c->r_max < c->r_min) c->r_max = c->r_min;
+    if (c->bitrate_kbps < 0) c->bitrate_kbps = 0;
+    if (c->min_bitrate_kbps < 0) c->min_bitrate_kbps = 0;
+    if (c->min_bitrate_kbps > c->bitrate_kbps) c->min_bitrate_kbps = c->bitrate_kbps;
+
+    pthread_mutex_init(&ctl->lock, NULL);
+    ctl->loss = LOSS_FLOOR;
+    ctl->rate_scale = 1.0;
+
+    // Geri bildirim gelene kadar en korumalı ayarla başla
+    atomic_store(&ctl->r_delta, c->r_max);
+    atomic_store(&ctl->r_keyframe, c->r_max);
+    atomic_store(&ctl->target_kbps, media_bitrate(c, c->r_max, 1.0));
+    return ctl;
+}
+
+void fec_controller_free(FecController *ctl) {
+    if (!ctl) return;
+    pthread_mutex_destroy(&ctl->lock);
+    free(ctl);
+}
+
+void fec_controller_get_config(const FecController *ctl, FecControllerConfig *out) {
+    *out = ctl->cfg;
+}
+
+void fec_controller_report_loss(FecController *ctl, double loss_fraction) {
+    if (loss_fraction < 0.0) loss_fraction = 0.0;
+    if (loss_fraction > 1.0) loss_fraction = 1.0;
+
+    pthread_mutex_lock(&ctl->lock);
+    double a = loss_fraction > ctl->loss ? ctl->cfg.alpha_up : ctl->cfg.alpha_down;
+    ctl->loss = a * loss_fraction + (1.0 - a) * ctl->loss;
+    if (ctl->loss < LOSS_FLOOR) ctl->loss = LOSS_FLOOR;
+    ctl->reports++;
+
+    if (ctl->cfg.adaptive) {
+        atomic_store_explicit(&ctl->r_delta,
+                              pick_parity(&ctl->cfg, ctl->loss, ctl->cfg.target_block_loss),
+                              memory_order_relaxed);
+        atomic_store_explicit(&ctl->r_keyframe,
+                              pick_parity(&ctl->cfg, ctl->loss, ctl->cfg.keyframe_block_loss),
+                              memory_order_relaxed);
+    }
+    if (ctl->cfg.bitrate_kbps > 0) {
+        // Ham kayıp (süzülmemiş) kullanılır: tıkanıklığa bir rapor içinde tepki verilir
+        if (loss_fraction > ctl->cfg.congestion_loss) ctl->rate_scale *= RATE_DECREASE;
+        else ctl->rate_scale += RATE_INCREASE;
+        if (ctl->rate_scale > 1.0) ctl->rate_scale = 1.0;
+        if (ctl->rate_scale < RATE_SCALE_MIN) ctl->rate_scale = RATE_SCALE_MIN;
+        int r = atomic_load_explicit(&ctl->r_delta, memory_order_relaxed);
+        atomic_store_explicit(&ctl->target_kbps, media_bitrate(&ctl->cfg, r, ctl->rate_scale),
+                              memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&ctl->lock);
+}
+
+void fec_controller_select(FecController *ctl, int keyframe, int *k, int *r) {
+    *k = ctl->cfg.k;
+    if (!ctl->cfg.adaptive) {
+        *r = ctl->cfg.r_max;
+        return;
+    }
+    *r = atomic_load_explicit(keyframe ? &ctl->r_keyframe : &ctl->r_delta,
+                              memory_order_relaxed);
+}
+
+int fec_controller_target_bitrate(FecController *ctl) {
+    return atomic_load_explicit(&ctl->target_kbps, memory_order_relaxed);
+}
+
+void fec_controller_get_state(FecController *ctl, FecControllerState *out) {
+    pthread_mutex_lock(&ctl->lock);
+    out->loss_estimate = ctl->loss;
+    out->reports = ctl->reports;
+    pthread_mutex_unlock(&ctl->lock);
+    out->r_delta = atomic_load(&ctl->r_delta);
+    out->r_keyframe = atomic_load(&ctl->r_keyframe);
+    out->target_kbps = atomic_load(&ctl->target_kbps);
+}
@@ -0,0 +1,408 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdatomic.h>
+#include "fec_pipeline.h"
+
+/*
+ * İşçi başına halka. Her indeks tek bir iş parçacığına aittir:
+ * head -> üretici, work -> işçi, tail -> sıralayıcı.
+ * Semaforlar hem uyandırmayı hem de bellek sıralamasını sağlar.
+ */
+typedef struct {
+    FecJob *slots;
+    unsigned int depth;
+    unsigned int head;
+    unsigned int work;
+    unsigned int tail;
+    sem_t items;        /* üretici -> işçi */
+    sem_t done;         /* işçi -> sıralayıcı */
+    sem_t space;        /* sıralayıcı -> üretici */
+    pthread_t thread;
+    int started;
+    struct FecPipeline *pipeline;
+} JobRing;
+
+struct FecPipeline {
+    FecPipelineConfig cfg;
+    ShardPool *pool;
+    FecJobEmit emit;
+    void *user;
+
+    JobRing *rings;
+    pthread_t sequencer;
+    int sequencer_started;
+    int stopped;
+
+    /* Gönderimleri sıralar; next_seq ve üretici durumları bu kilitle korunur */
+    pthread_mutex_t submit_lock;
+    uint64_t next_seq;
+    FecProducer default_src;
+
+    _Atomic uint64_t submitted;
+    _Atomic uint64_t dropped;
+    _Atomic uint64_t blocked;
+    _Atomic uint64_t failed;        /* completed'ın alt kümesi */
+    _Atomic uint64_t completed;     /* sıralayıcının bitirdiği her iş, başarısızlar dahil */
+    _Atomic uint64_t bytes_in;
+    _Atomic uint64_t blocks;
+    _Atomic uint64_t data_shards;
+    _Atomic uint64_t parity_shards;
+    _Atomic uint64_t padding_bytes;
+    TelHistogram st_queue, st_shard, st_encode, st_reorder, st_emit, st_total;
+};
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void stage_add(TelHistogram *h, uint64_t from, uint64_t to) {
+    tel_hist_record(h, to > from ? to - from : 0);
+}
+
+static void counter_add(_Atomic uint64_t *c, uint64_t v) {
+    atomic_fetch_add_explicit(c, v, memory_order_relaxed);
+}
+
+static uint64_t counter_get(_Atomic uint64_t *c) {
+    return atomic_load_explicit(c, memory_order_relaxed);
+}
+
+static void sem_wait_nointr(sem_t *s) {
+    while (sem_wait(s) != 0 && errno == EINTR) {
+    }
+}
+
+void fec_producer_init(FecProducer *src, void *tag) {
+    memset(src, 0, sizeof(*src));
+    src->tag = tag;
+}
+
+void fec_pipeline_default_config(FecPipelineConfig *cfg) {
+    cfg->workers = 2;
+    cfg->queue_depth = 8;
+    cfg->policy = FEC_QUEUE_BLOCK;
+    cfg->zero_copy = 1;
+    cfg->max_shard_size = 1408;
+}
+
+/* İşçi: erişim birimini MTU'ya sığan bloklara böler ve parity üretir */
+static void process_job(FecPipeline *p, FecJob *job) {
+    job->t_fec_start = now_ns();
+    job->nblocks = 0;
+    job->failed = 0;
+    job->shard_ns = 0;
+
+    const FecEncoder *enc = fec_encoder_get(job->k, job->r);
+    size_t block_max = (size_t)job->k * p->cfg.max_shard_size;
+    int need = (int)((job->len + block_max - 1) / block_max);
+    if (!enc || need < 1) {
+        job->failed = 1;
+        job->t_fec_end = now_ns();
+        return;
+    }
+    if (need > job->blocks_cap) {
+        FecBlock *b = realloc(job->blocks, sizeof(FecBlock) * need);
+        if (!b) {
+            job->failed = 1;
+            job->t_fec_end = now_ns();
+            return;
+        }
+        job->blocks = b;
+        job->blocks_cap = need;
+    }
+
+    for (size_t off = 0; off < job->len; off += block_max) {
+        size_t len = job->len - off < block_max ? job->len - off : block_max;
+        FecBlock *blk = &job->blocks[job->nblocks];
+        uint64_t t0 = now_ns();
+        int rc = fec_block_prepare(blk, p->pool, job->k, job->r, job->data + off, len,
+                                   p->cfg.zero_copy);
+        job->shard_ns += now_ns() - t0;
+        if (rc < 0) {
+            job->failed = 1;
+            break;
+        }
+        job->nblocks++;
+        fec_block_encode(blk, enc);
+    }
+    job->t_fec_end = now_ns();
+}
+
+static void* worker_main(void *arg) {
+    JobRing *ring = arg;
+    FecPipeline *p = ring->pipeline;
+    for (;;) {
+        sem_wait_nointr(&ring->items);
+        FecJob *job = &ring->slots[ring->work++ % ring->depth];
+        if (!job->stop) process_job(p, job);
+        int stop = job->stop;
+        sem_post(&ring->done);
+        if (stop) break;
+    }
+    return NULL;
+}
+
+/* Sıralayıcı: halkaları üreticinin dağıttığı sırayla okur, emit eder ve belleği bırakır */
+static void* sequencer_main(void *arg) {
+    FecPipeline *p = arg;
+    unsigned int w = 0, stops = 0;
+    while (stops < p->cfg.workers) {
+        JobRing *ring = &p->rings[w];
+        w = (w + 1) % p->cfg.workers;
+        sem_wait_nointr(&ring->done);
+        FecJob *job = &ring->slots[ring->tail++ % ring->depth];
+
+        if (job->stop) {
+            stops++;
+            sem_post(&ring->space);
+            continue;
+        }
+
+        job->t_emit = now_ns();
+        if (job->failed) {
+            counter_add(&p->failed, 1);
+        } else if (p->emit) {
+            p->emit(p->user, job);
+        }
+        uint64_t t_done = now_ns();
+
+        if (!job->failed) {
+            uint64_t data = 0, parity = 0, padding = 0;
+            for (int i = 0; i < job->nblocks; i++) {
+                const FecBlock *blk = &job->blocks[i];
+                data += (uint64_t)blk->k;
+                parity += (uint64_t)blk->r;
+                padding += (uint64_t)blk->k * (uint64_t)blk->shard_size - blk->payload_len;
+            }
+            counter_add(&p->bytes_in, job->len);
+            counter_add(&p->blocks, (uint64_t)job->nblocks);
+            counter_add(&p->data_shards, data);
+            counter_add(&p->parity_shards, parity);
+            counter_add(&p->padding_bytes, padding);
+        }
+
+        for (int i = 0; i < job->nblocks; i++)
+            fec_block_release(&job->blocks[i], p->pool);
+        job->nblocks = 0;
+        if (job->release_owner) job->release_owner(job->owner);
+        job->owner = NULL;
+        job->release_owner = NULL;
+
+        stage_add(&p->st_queue, job->t_enqueue, job->t_fec_start);
+        stage_add(&p->st_shard, 0, job->shard_ns);
+        stage_add(&p->st_encode, job->t_fec_start + job->shard_ns, job->t_fec_end);
+        stage_add(&p->st_reorder, job->t_fec_end, job->t_emit);
+        stage_add(&p->st_emit, job->t_emit, t_done);
+        stage_add(&p->st_total, job->t_enqueue, t_done);
+        counter_add(&p->completed, 1);
+
+        sem_post(&ring->space);
+    }
+    return NULL;
+}
+
+FecPipeline* fec_pipeline_new(const FecPipelineConfig *cfg, ShardPool *pool,
+                              FecJobEmit emit, void *user) {
+    FecPipeline *p = calloc(1, sizeof(*p));
+    if (!p) return NULL;
+    p->cfg = *cfg;
+    if (p->cfg.workers < 1) p->cfg.workers = 1;
+    if (p->cfg.queue_depth < 1) p->cfg.queue_depth = 1;
+    if (p->cfg.max_shard_size < SHARD_POOL_ALIGN) p->cfg.max_shard_size = SHARD_POOL_ALIGN;
+    p->pool = pool;
+    p->emit = emit;
+    p->user = user;
+    pthread_mutex_init(&p->submit_lock, NULL);
+    fec_producer_init(&p->default_src, NULL);
+
+    p->rings = calloc(p->cfg.workers, sizeof(JobRing));
+    if (!p->rings) {
+        free(p);
+        return NULL;
+    }
+    for (unsigned int i = 0; i < p->cfg.workers; i++) {
+        JobRing *ring = &p->rings[i];
+        ring->depth = p->cfg.queue_depth;
+        ring->pipeline = p;
+        ring->slots = calloc(ring->depth, sizeof(FecJob));
+        if (!ring->slots) goto fail;
+        sem_init(&ring->items, 0, 0);
+        sem_init(&ring->done, 0, 0);
+        sem_init(&ring->space, 0, ring->depth);
+        if (pthread_create(&ring->thread, NULL, worker_main, ring) != 0) goto fail;
+        ring->started = 1;
+    }
+    if (pthread_create(&p->sequencer, NULL, sequencer_main, p) != 0) goto fail;
+    p->sequencer_started = 1;
+    return p;
+
+fail:
+    fec_pipeline_stop(p);
+    fec_pipeline_free(p);
+    return NULL;
+}
+
+/*
+ * submit_lock tutulurken, sıradaki halkada yer yokken çağrılır. Yer kilit bırakılarak
+ * beklenir (geri basınç diğer üreticileri ve kapanışı kilitte bekletmesin); kilit yeniden
+ * alındığında sıra başka bir halkaya geçtiyse alınan yer geri bırakılır ve yeni sıradaki
+ * halka denenir. Kilit tutulur ve halkada bir yer ayrılmış olarak döner.
+ */
+static JobRing* ring_wait(FecPipeline *p, JobRing *ring) {
+    for (;;) {
+        pthread_mutex_unlock(&p->submit_lock);
+        sem_wait_nointr(&ring->space);
+        pthread_mutex_lock(&p->submit_lock);
+        JobRing *next = &p->rings[p->next_seq % p->cfg.workers];
+        if (next == ring) return ring;
+        sem_post(&ring->space);
+        ring = next;
+        if (sem_trywait(&ring->space) == 0) return ring;
+    }
+}
+
+/* Üretici tarafı: sıradaki halkaya bir slot yazar */
+static void ring_push(FecPipeline *p, JobRing *ring, const FecJob *src) {
+    FecJob *job = &ring->slots[ring->head++ % ring->depth];
+    FecBlock *blocks = job->blocks;
+    int cap = job->blocks_cap;
+    *job = *src;
+    job->blocks = blocks;
+    job->blocks_cap = cap;
+    job->nblocks = 0;
+    sem_post(&ring->items);
+    p->next_seq++;
+}
+
+int fec_pipeline_submit(FecPipeline *p, FecProducer *src,
+                        const unsigned char *data, size_t len,
+                        void *owner, void (*release_owner)(void *owner),
+                        uint32_t rtp_timestamp, int keyframe, int job_flags, int k, int r) {
+    if (!src) src = &p->default_src;
+
+    // Halka seçimi ve yazımı tek sırada olmalı: sıralayıcı halkaları aynı sırayla okur.
+    // Geri basınçta yer kilit dışında beklenir (ring_wait); sıra yine kilit altında yazılır.
+    pthread_mutex_lock(&p->submit_lock);
+    if (keyframe) src->skipping_gop = 0;
+
+    JobRing *ring = &p->rings[p->next_seq % p->cfg.workers];
+    int drop = p->stopped || len == 0;
+    if (!drop && !keyframe && src->skipping_gop) drop = 1;
+
+    if (!drop) {
+        if (sem_trywait(&ring->space) != 0) {
+            if (p->cfg.policy == FEC_QUEUE_DROP && !keyframe) {
+                // Referans zinciri kırıldı: IDR gelene kadar P-frame gönderme
+                src->skipping_gop = 1;
+                drop = 1;
+            } else {
+                counter_add(&p->blocked, 1);
+                ring = ring_wait(p, ring);
+                // Beklerken durdurulduysa yer kapanış işine kalır
+                if (p->stopped) {
+                    sem_post(&ring->space);
+                    drop = 1;
+                }
+            }
+        }
+    }
+    if (drop) {
+        src->dropped++;
+        pthread_mutex_unlock(&p->submit_lock);
+        counter_add(&p->dropped, 1);
+        if (release_owner) release_owner(owner);
+        return 1;
+    }
+
+    FecJob job = {
+        .seq = p->next_seq,
+        .tag = src->tag,
+        .data = data,
+        .len = len,
+        .owner = owner,
+        .release_owner = release_owner,
+        .rtp_timestamp = rtp_timestamp,
+        .keyframe = keyframe,
+        .flags = job_flags,
+        .k = k,
+        .r = r,
+        .t_enqueue = now_ns(),
+    };
+    ring_push(p, ring, &job);
+    src->submitted++;
+    pthread_mutex_unlock(&p->submit_lock);
+    counter_add(&p->submitted, 1);
+    return 0;
+}
+
+void fec_pipeline_stop(FecPipeline *p) {
+    if (!p) return;
+    pthread_mutex_lock(&p->submit_lock);
+    if (p->stopped) {
+        pthread_mutex_unlock(&p->submit_lock);
+        return;
+    }
+    p->stopped = 1;
+
+    // Her işçiye, dağıtım sırasını bozmadan birer kapanış işi gönder
+    for (unsigned int i = 0; i < p->cfg.workers; i++) {
+        JobRing *ring = &p->rings[p->next_seq % p->cfg.workers];
+        if (!ring->started) {
+            p->next_seq++;
+            continue;
+        }
+        // stopped kurulduğu için bekleyen üreticiler yer ayırmadan çıkar; sıra ilerlemez
+        if (sem_trywait(&ring->space) != 0) ring = ring_wait(p, ring);
+        FecJob stop = { .seq = p->next_seq, .stop = 1 };
+        ring_push(p, ring, &stop);
+    }
+    pthread_mutex_unlock(&p->submit_lock);
+    for (unsigned int i = 0; i < p->cfg.workers; i++) {
+        if (p->rings[i].started) pthread_join(p->rings[i].thread, NULL);
+    }
+    if (p->sequencer_started) pthread_join(p->sequencer, NULL);
+}
+
+void fec_pipeline_free(FecPipeline *p) {
+    if (!p) return;
+    for (unsigned int i = 0; i < p->cfg.workers; i++) {
+        JobRing *ring = &p->rings[i];
+        if (!ring->slots) continue;
+        for (unsigned int j = 0; j < ring->depth; j++)
+            free(ring->slots[j].blocks);
+        free(ring->slots);
+        sem_destroy(&ring->items);
+        sem_destroy(&ring->done);
+        sem_destroy(&ring->space);
+    }
+    free(p->rings);
+    pthread_mutex_destroy(&p->submit_lock);
+    free(p);
+}
+
+void fec_pipeline_get_stats(FecPipeline *p, FecPipelineStats *out) {
+    out->submitted = counter_get(&p->submitted);
+    out->dropped = counter_get(&p->dropped);
+    out->blocked = counter_get(&p->blocked);
+    out->failed = counter_get(&p->failed);
+    uint64_t completed = counter_get(&p->completed);
+    out->in_flight = out->submitted > completed ? out->submitted - completed : 0;
+    out->bytes_in = counter_get(&p->bytes_in);
+    out->blocks = counter_get(&p->blocks);
+    out->data_shards = counter_get(&p->data_shards);
+    out->parity_shards = counter_get(&p->parity_shards);
+    out->padding_bytes = counter_get(&p->padding_bytes);
+    tel_hist_summary(&p->st_queue, &out->queue);
+    tel_hist_summary(&p->st_shard, &out->shard);
+    tel_hist_summary(&p->st_encode, &out->encode);
+    tel_hist_summary(&p->st_reorder, &out->reorder);
+    tel_hist_summary(&p->st_emit, &out->emit);
+    tel_hist_summary(&p->st_total, &out->total);
+}
@@ -0,0 +1,584 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fec_reassembler.h"
+#include "fec_aggregator.h"
+
+/* Blok içi yayılım tahmini: srtt/rttvar benzeri EWMA, son tarih = ortalama + 4 sapma */
+#define SPREAD_GAIN_SHIFT 3
+#define SPREAD_DEV_SHIFT  2
+#define SPREAD_DEV_MULT   4
+/* Varış jitter'ının son tarihe katkısı */
+#define JITTER_MULT       2
+/* Son tarihten sonra gelen shard'ın kaçırdığı süre payı eklenir; zamanında tamamlanan her blokta 1/256 söner */
+#define LATE_MARGIN_DECAY_SHIFT 8
+
+/* Pencere içindeki tek bir FEC bloğunun alım durumu */
+typedef struct {
+    int used;
+    int ready;                                      /* tüm veri shard'ları hazır */
+    uint32_t block_id;
+    uint32_t timestamp;
+    int k, r, flags, shard_size;
+    uint32_t payload_len;
+    int received;
+    int retransmitted;                              /* yeniden gönderilen shard alındı */
+    int expired;                                    /* son tarih geçince bırakıldı */
+    int timed;                                      /* first_us geçerli */
+    int64_t first_us;                               /* ilk shard (ya da boşluğun fark edildiği) an */
+    int64_t ready_us;
+    unsigned char present[FEC_MAX_TOTAL_SHARDS];
+    unsigned char *buf;                             /* shard i -> buf + i * shard_size */
+    size_t cap;
+} BlockSlot;
+
+struct FecReassembler {
+    BlockSlot *slots;
+    unsigned int window;
+    unsigned int reorder;
+    int started;
+    uint32_t next_block;                            /* sıradaki teslim edilecek blok */
+    uint32_t newest_block;                          /* görülen en yeni blok */
+    FecDecoder *dec;
+
+    FecFrameCallback cb;
+    FecSliceCallback slice_cb;
+    FecRepairCallback repair_cb;
+    void *user;
+    unsigned int nack_after;
+    uint32_t nack_next;                             /* NACK kararı verilecek sıradaki blok */
+
+    /* Birleştirilmekte olan erişim birimi */
+    unsigned char *frame;
+    size_t frame_len, frame_cap;
+    int in_frame, frame_corrupt, frame_key;
+    int frame_damaged;                              /* slice çıkışı: bir grup atıldı */
+    uint32_t frame_ts;
+
+    /* Uyarlanır jitter tamponu: eksik blok için bekleme süresi zamana bağlı */
+    int jb;
+    FecJitterConfig jb_cfg;
+    int64_t now_us;
+    int have_transit;
+    uint32_t last_transit;                          /* 90 kHz: varış - RTP zaman damgası */
+    uint32_t jitter90_x16;                          /* RFC 3550 J, 16 katı */
+    int64_t spread_avg_us, spread_dev_us;
+    uint64_t spread_samples;
+    int64_t late_margin_us;                         /* geç shard'lardan öğrenilen ek bekleme */
+
+    /* Simulcast: pencereye giren SSRC; başlangıç bloğu beklenen yabancı SSRC */
+    int have_ssrc;
+    uint32_t ssrc;
+    int have_foreign;
+    uint32_t foreign_ssrc;
+    int64_t foreign_since_us, foreign_last_us, foreign_request_us;
+
+    FecReassemblerStats stats;
+    FecJitterStats jb_stats;
+};
+
+static unsigned int round_pow2(unsigned int v) {
+    unsigned int p = 1;
+    while (p < v) p <<= 1;
+    return p;
+}
+
+FecReassembler* fec_reassembler_new(unsigned int window, unsigned int reorder,
+                                    FecFrameCallback cb, void *user) {
+    FecReassembler *ra = calloc(1, sizeof(*ra));
+    if (!ra) return NULL;
+    ra->window = round_pow2(window < 2 ? 2 : window);
+    ra->reorder = reorder < 1 ? 1 : reorder;
+    if (ra->reorder >= ra->window) ra->reorder = ra->window - 1;
+    ra->slots = calloc(ra->window, sizeof(BlockSlot));
+    ra->dec = fec_decoder_new(0);
+    if (!ra->slots || !ra->dec) {
+        fec_reassembler_free(ra);
+        return NULL;
+    }
+    ra->cb = cb;
+    ra->user = user;
+    return ra;
+}
+
+void fec_reassembler_free(FecReassembler *ra) {
+    if (!ra) return;
+    if (ra->slots) {
+        for (unsigned int i = 0; i < ra->window; i++)
+            free(ra->slots[i].buf);
+    }
+    free(ra->slots);
+    fec_decoder_free(ra->dec);
+    free(ra->frame);
+    free(ra);
+}
+
+void fec_reassembler_set_slice_callback(FecReassembler *ra, FecSliceCallback cb) {
+    ra->slice_cb = cb;
+}
+
+void fec_reassembler_set_repair_callback(FecReassembler *ra, unsigned int nack_after,
+                                         FecRepairCallback cb) {
+    ra->repair_cb = cb;
+    ra->nack_after = nack_after < ra->reorder ? nack_after : ra->reorder - 1;
+    ra->nack_next = ra->next_block;
+}
+
+static void frame_reset(FecReassembler *ra) {
+    ra->in_frame = 0;
+    ra->frame_corrupt = 0;
+    ra->frame_damaged = 0;
+    ra->frame_len = 0;
+}
+
+static void deliver(FecReassembler *ra, const unsigned char *data, size_t len,
+                    uint32_t rtp_timestamp, int keyframe, int end_of_frame) {
+    if (ra->slice_cb)
+        ra->slice_cb(ra->user, data, len, rtp_timestamp, keyframe, end_of_frame);
+    else if (ra->cb)
+        ra->cb(ra->user, data, len, rtp_timestamp, keyframe);
+}
+
+/* SLICE_END: grubu hemen teslim et; bozuksa yalnızca grubu at ve NAL sınırından devam et */
+static void slice_ready(FecReassembler *ra) {
+    if (ra->frame_corrupt) {
+        ra->stats.slices_dropped++;
+        ra->frame_damaged = 1;
+        ra->frame_corrupt = 0;
+    } else if (ra->frame_len) {
+        ra->stats.slices_out++;
+        deliver(ra, ra->frame, ra->frame_len, ra->frame_ts, ra->frame_key, 0);
+    }
+    ra->frame_len = 0;
+}
+
+static int frame_append(FecReassembler *ra, const unsigned char *data, size_t len) {
+    if (ra->frame_len + len > ra->frame_cap) {
+        size_t cap = ra->frame_cap ? ra->frame_cap : 64 * 1024;
+        while (cap < ra->frame_len + len) cap *= 2;
+        unsigned char *p = realloc(ra->frame, cap);
+        if (!p) return -1;
+        ra->frame = p;
+        ra->frame_cap = cap;
+    }
+    memcpy(ra->frame + ra->frame_len, data, len);
+    ra->frame_len += len;
+    return 0;
+}
+
+/* Sıradaki blok çözülemedi: içinde bulunduğu erişim birimi kullanılamaz */
+static void on_block_lost(FecReassembler *ra, uint32_t block_id) {
+    ra->stats.blocks_lost++;
+    if (ra->in_frame) ra->frame_corrupt = 1;
+    if (ra->repair_cb) ra->repair_cb(ra->user, FEC_REPAIR_LOST, block_id, 0);
+}
+
+static void on_aggregate_record(void *user, const unsigned char *data, size_t len,
+                                uint32_t rtp_timestamp) {
+    FecReassembler *ra = user;
+    ra->stats.frames_out++;
+    deliver(ra, data, len, rtp_timestamp, 0, 1);
+}
+
+/* Hazır bir bloğun payload'unu erişim birimine ekler, son bloksa teslim eder */
+static void on_block_ready(FecReassembler *ra, BlockSlot *s) {
+    if (s->flags & RTP_FEC_FLAG_AGGREGATE) {
+        // Kendi içinde tam bloklar: birimler doğrudan bloğun tamponundan teslim edilir
+        if (ra->in_frame) ra->stats.frames_dropped++;
+        frame_reset(ra);
+        if (fec_aggregate_parse(s->buf, s->payload_len, on_aggregate_record, ra) < 0)
+            ra->stats.frames_dropped++;
+        return;
+    }
+    if (s->flags & RTP_FEC_FLAG_START_OF_FRAME) {
+        // Önceki birimin son bloğu hiç gelmedi
+        if (ra->in_frame) ra->stats.frames_dropped++;
+        frame_reset(ra);
+        ra->in_frame = 1;
+        ra->frame_ts = s->timestamp;
+        ra->frame_key = (s->flags & RTP_FEC_FLAG_KEYFRAME) != 0;
+    } else if (!ra->in_frame || s->timestamp != ra->frame_ts) {
+        // Başı kaybolmuş bir birimin devamı: sonuna kadar atılır
+        if (ra->in_frame) ra->stats.frames_dropped++;
+        frame_reset(ra);
+        if (s->flags & RTP_FEC_FLAG_END_OF_FRAME) ra->stats.frames_dropped++;
+        return;
+    }
+
+    if (!ra->frame_corrupt && frame_append(ra, s->buf, s->payload_len) < 0)
+        ra->frame_corrupt = 1;
+
+    if (s->flags & RTP_FEC_FLAG_END_OF_FRAME) {
+        if (ra->slice_cb && ra->frame_corrupt) {
+            // Önceki gruplar zaten decoder'da; yalnızca son grup kayıp
+            ra->stats.slices_dropped++;
+            ra->stats.frames_dropped++;
+        } else if (ra->frame_corrupt) {
+            ra->stats.frames_dropped++;
+        } else {
+            if (ra->frame_damaged) ra->stats.frames_dropped++;
+            else                   ra->stats.frames_out++;
+            deliver(ra, ra->frame, ra->frame_len, ra->frame_ts, ra->frame_key, 1);
+        }
+        frame_reset(ra);
+    } else if (ra->slice_cb && (s->flags & RTP_FEC_FLAG_SLICE_END)) {
+        slice_ready(ra);
+    }
+}
+
+/* Eksik bir bloğun ilk shard'ından (ya da boşluğun fark edilmesinden) sonra bekleme süresi */
+static int64_t jb_wait_us(const FecReassembler *ra) {
+    if (!ra->spread_samples) return ra->jb_cfg.max_wait_us;
+    int64_t jitter_us = (int64_t)(ra->jitter90_x16 >> 4) * 1000000 / RTP_FEC_CLOCK_RATE;
+    int64_t wait = ra->spread_avg_us + SPREAD_DEV_MULT * ra->spread_dev_us + JITTER_MULT * jitter_us +
+                   ra->late_margin_us;
+    if (wait < ra->jb_cfg.min_wait_us) wait = ra->jb_cfg.min_wait_us;
+    if (wait > ra->jb_cfg.max_wait_us) wait = ra->jb_cfg.max_wait_us;
+    return wait;
+}
+
+/* İlk shard -> k. shard süresi; seyrek gecikmeler ortalamada kaybolur, onları geç payı karşılar */
+static void jb_spread_sample(FecReassembler *ra, int64_t sample) {
+    if (sample < 0) sample = 0;
+    ra->late_margin_us -= ra->late_margin_us >> LATE_MARGIN_DECAY_SHIFT;
+    if (!ra->spread_samples++) {
+        ra->spread_avg_us = sample;
+        ra->spread_dev_us = sample / 2;
+        return;
+    }
+    int64_t err = sample - ra->spread_avg_us;
+    ra->spread_avg_us += err / (1 << SPREAD_GAIN_SHIFT);
+    ra->spread_dev_us += ((err < 0 ? -err : err) - ra->spread_dev_us) / (1 << SPREAD_DEV_SHIFT);
+}
+
+/* RFC 3550 varış jitter'ı: ardışık paketlerin geçiş süresi farkının EWMA'sı */
+static void jb_transit_sample(FecReassembler *ra, uint32_t rtp_timestamp) {
+    uint32_t now90 = (uint32_t)((uint64_t)ra->now_us * RTP_FEC_CLOCK_RATE / 1000000);
+    uint32_t transit = now90 - rtp_timestamp;
+    if (ra->have_transit) {
+        int32_t d = (int32_t)(transit - ra->last_transit);
+        uint32_t ad = d < 0 ? (uint32_t)-d : (uint32_t)d;
+        ra->jitter90_x16 += ad - ((ra->jitter90_x16 + 8) >> 4);
+    }
+    ra->last_transit = transit;
+    ra->have_transit = 1;
+}
+
+/* Sıradaki eksik bloğun son tarihi; bilgi yoksa (boşluk henüz görülmedi) şimdi */
+static int64_t head_deadline(const FecReassembler *ra) {
+    const BlockSlot *s = &ra->slots[ra->next_block & (ra->window - 1)];
+    if (s->block_id != ra->next_block || !s->timed) return ra->now_us;
+    return s->first_us + jb_wait_us(ra);
+}
+
+/* next_block'u teslim eder ya da kayıp sayar ve pencereyi bir ilerletir */
+static void resolve_next(FecReassembler *ra) {
+    BlockSlot *s = &ra->slots[ra->next_block & (ra->window - 1)];
+    if (s->used && s->block_id == ra->next_block && s->ready) {
+        if (ra->jb && ra->now_us > s->ready_us) {
+            // Hazır blok, öndeki eksik bloğun son tarihini bekledi
+            uint64_t held = (uint64_t)(ra->now_us - s->ready_us);
+            ra->jb_stats.hold_us_total += held;
+            if (held > ra->jb_stats.hold_max_us) ra->jb_stats.hold_max_us = held;
+        }
+        on_block_ready(ra, s);
+    } else {
+        on_block_lost(ra, ra->next_block);
+    }
+    s->used = 0;
+    ra->next_block++;
+}
+
+/*
+ * En yeniden nack_after kadar geride kalan blokları bir kez değerlendirir: k'dan
+ * az shard'ı olanlar için eksik shard'ları ister. Parity'yle zaten çözülebilen
+ * bloklar sorulmaz; istenen shard sayısı bloğu tamamlamaya yetecek kadardır.
+ */
+static void request_repairs(FecReassembler *ra) {
+    if (!ra->repair_cb || !ra->nack_after) return;
+    if ((int32_t)(ra->nack_next - ra->next_block) < 0) ra->nack_next = ra->next_block;
+    while ((int32_t)(ra->newest_block - ra->nack_next) >= (int32_t)ra->nack_after) {
+        uint32_t id = ra->nack_next++;
+        BlockSlot *s = &ra->slots[id & (ra->window - 1)];
+        uint64_t missing = UINT64_MAX;
+        if (s->used && s->block_id == id) {
+            if (s->ready || s->received >= s->k) continue;
+            int need = s->k - s->received;
+            missing = 0;
+            for (int i = 0; i < s->k + s->r && need > 0; i++) {
+                if (s->present[i]) continue;
+                missing |= 1ull << i;
+                need--;
+            }
+        }
+        ra->stats.nacks++;
+        ra->repair_cb(ra->user, FEC_REPAIR_NACK, id, missing);
+    }
+}
+
+/*
+ * Sıradaki bloklar hazırsa ya da yeniden sıralama derinliği aşıldıysa sonuçlandırır.
+ * Jitter tamponunda derinlik yerine bloğun son tarihi belirler; hazır bloklar
+ * (k shard) son tarihi beklemeden, blok sırasıyla çıkar.
+ */
+static void deliver_ready(FecReassembler *ra) {
+    while ((int32_t)(ra->newest_block - ra->next_block) >= 0) {
+        BlockSlot *s = &ra->slots[ra->next_block & (ra->window - 1)];
+        int ready = s->used && s->block_id == ra->next_block && s->ready;
+        if (!ready) {
+            if (ra->jb) {
+                if (ra->now_us < head_deadline(ra)) break;
+                ra->jb_stats.blocks_expired++;
+                s->block_id = ra->next_block;
+                s->expired = 1;
+            } else if (ra->newest_block - ra->next_block < ra->reorder) {
+                break;
+            }
+        }
+        resolve_next(ra);
+    }
+}
+
+static int slot_init(BlockSlot *s, const RtpFecPacket *pkt, int64_t now_us) {
+    const RtpFecHeader *h = &pkt->hdr;
+    // Boşluk olarak işaretlenmiş blok: bekleme, boşluğun fark edildiği andan sayılır
+    int64_t first_us = !s->used && s->block_id == h->block_id && s->timed ? s->first_us : now_us;
+    size_t need = (size_t)(h->k + h->r) * h->shard_size;
+    if (need > s->cap) {
+        free(s->buf);
+        s->buf = NULL;
+        s->cap = 0;
+        if (posix_memalign((void **)&s->buf, SHARD_POOL_ALIGN, need)) {
+            s->buf = NULL;
+            return -1;
+        }
+        s->cap = need;
+    }
+    s->used = 1;
+    s->ready = 0;
+    s->block_id = h->block_id;
+    s->timestamp = h->timestamp;
+    s->k = h->k;
+    s->r = h->r;
+    s->flags = h->flags & ~RTP_FEC_FLAG_RETRANSMIT;
+    s->shard_size = h->shard_size;
+    s->payload_len = h->payload_len;
+    s->received = 0;
+    s->retransmitted = 0;
+    s->expired = 0;
+    s->timed = 1;
+    s->first_us = first_us;
+    memset(s->present, 0, sizeof(s->present));
+    return 0;
+}
+
+/* k shard toplandı: eksik veri shard'larını parity'den üret */
+static void slot_complete(FecReassembler *ra, BlockSlot *s) {
+    unsigned char *shards[FEC_MAX_TOTAL_SHARDS];
+    int data_missing = 0;
+    for (int i = 0; i < s->k + s->r; i++) {
+        shards[i] = s->buf + (size_t)i * s->shard_size;
+        if (i < s->k && !s->present[i]) data_missing = 1;
+    }
+    if (ra->jb && !s->retransmitted) jb_spread_sample(ra, ra->now_us - s->first_us);
+    s->ready_us = ra->now_us;
+    if (!data_missing) {
+        s->ready = 1;
+        if (s->retransmitted) ra->stats.blocks_repaired++;
+        else                  ra->stats.blocks_intact++;
+        return;
+    }
+    if (fec_decoder_reconstruct(ra->dec, s->k, s->r, s->shard_size, shards, s->present) == 0) {
+        s->ready = 1;
+        if (s->retransmitted) ra->stats.blocks_repaired++;
+        else                  ra->stats.blocks_recovered++;
+    }
+}
+
+/*
+ * Blok numarası pencereden uzağa sıçradı (gönderici yeniden başladı ya da uzun bir
+ * kesinti): bekleyen bloklar atılır, bu paket pencereyi yeniden başlatır. Yeni dizi
+ * bir IDR gerektirdiği için LOST bildirilir.
+ */
+static void resync(FecReassembler *ra) {
+    ra->stats.resyncs++;
+    if (ra->repair_cb) ra->repair_cb(ra->user, FEC_REPAIR_LOST, ra->next_block, 0);
+    fec_reassembler_reset(ra);
+}
+
+void fec_reassembler_push(FecReassembler *ra, const RtpFecPacket *pkt) {
+    const RtpFecHeader *h = &pkt->hdr;
+    if (ra->started) {
+        // Pencere kadar geride ya da ilerideki blok bu dizinin parçası değildir; geride
+        // kalan yeniden gönderim ise yalnızca gecikmiştir
+        int32_t behind = (int32_t)(ra->next_block - h->block_id);
+        int32_t ahead = (int32_t)(h->block_id - ra->newest_block);
+        if (ahead > (int32_t)ra->window ||
+            (behind > (int32_t)ra->window && !(h->flags & RTP_FEC_FLAG_RETRANSMIT)))
+            resync(ra);
+    }
+    if (!ra->started) {
+        ra->started = 1;
+        ra->next_block = ra->newest_block = ra->nack_next = h->block_id;
+    }
+    if (ra->jb && !(h->flags & RTP_FEC_FLAG_RETRANSMIT))
+        jb_transit_sample(ra, h->timestamp);
+    if ((int32_t)(h->block_id - ra->next_block) < 0) {
+        ra->stats.late++;
+        BlockSlot *s = &ra->slots[h->block_id & (ra->window - 1)];
+        if (ra->jb && s->expired && s->block_id == h->block_id) {
+            // Son tarih kısa kaldı: kaçırılan süre kadar pay eklenir (blok başına bir kez)
+            int64_t missed = ra->now_us - (s->first_us + jb_wait_us(ra));
+            if (missed > 0) ra->late_margin_us += missed;
+            ra->jb_stats.shards_after_deadline++;
+            s->expired = 0;
+        }
+        return;
+    }
+    uint32_t prev_newest = ra->newest_block;
+    if ((int32_t)(h->block_id - ra->newest_block) > 0)
+        ra->newest_block = h->block_id;
+
+    // Pencereye sığmayan eski blokları sonuçlandır
+    while (ra->newest_block - ra->next_block >= ra->window)
+        resolve_next(ra);
+
+    // Atlanan bloklar boşluk: son tarihleri bu andan sayılır
+    if (ra->jb && ra->newest_block != prev_newest) {
+        uint32_t from = (int32_t)(prev_newest + 1 - ra->next_block) > 0 ? prev_newest + 1 : ra->next_block;
+        for (uint32_t id = from; id != ra->newest_block; id++) {
+            BlockSlot *g = &ra->slots[id & (ra->window - 1)];
+            if (g->used && g->block_id == id) continue;
+            g->used = 0;
+            g->block_id = id;
+            g->expired = 0;
+            g->timed = 1;
+            g->first_us = ra->now_us;
+        }
+    }
+
+    BlockSlot *s = &ra->slots[h->block_id & (ra->window - 1)];
+    if (!s->used || s->block_id != h->block_id) {
+        if (slot_init(s, pkt, ra->now_us) < 0) return;
+    } else if (s->k != h->k || s->r != h->r || s->shard_size != h->shard_size ||
+               s->payload_len != h->payload_len) {
+        return;
+    }
+
+    if (s->present[h->shard_index]) {
+        ra->stats.duplicates++;
+        return;
+    }
+    memcpy(s->buf + (size_t)h->shard_index * s->shard_size, pkt->payload, s->shard_size);
+    s->present[h->shard_index] = 1;
+    s->received++;
+    ra->stats.packets++;
+    if (h->flags & RTP_FEC_FLAG_RETRANSMIT) {
+        s->retransmitted = 1;
+        ra->stats.retransmits++;
+    }
+
+    if (!s->ready && s->received >= s->k)
+        slot_complete(ra, s);
+    request_repairs(ra);
+    deliver_ready(ra);
+}
+
+void fec_reassembler_set_jitter_buffer(FecReassembler *ra, const FecJitterConfig *cfg) {
+    ra->jb = 1;
+    ra->jb_cfg = *cfg;
+    if (ra->jb_cfg.max_wait_us < ra->jb_cfg.min_wait_us) ra->jb_cfg.max_wait_us = ra->jb_cfg.min_wait_us;
+    // Derinlik sınırı yalnızca pencere; NACK kararı hâlâ blok sayısıyla verilir
+    ra->reorder = ra->window - 1;
+}
+
+void fec_reassembler_advance(FecReassembler *ra, int64_t now_us) {
+    ra->now_us = now_us;
+    if (ra->jb && ra->started) deliver_ready(ra);
+}
+
+int64_t fec_reassembler_next_deadline(const FecReassembler *ra) {
+    if (!ra->jb || !ra->started || (int32_t)(ra->newest_block - ra->next_block) < 0) return -1;
+    const BlockSlot *s = &ra->slots[ra->next_block & (ra->window - 1)];
+    if (s->used && s->block_id == ra->next_block && s->ready) return -1;
+    return head_deadline(ra);
+}
+
+void fec_reassembler_get_jitter_stats(const FecReassembler *ra, FecJitterStats *out) {
+    *out = ra->jb_stats;
+    out->jitter_us = (uint32_t)((uint64_t)(ra->jitter90_x16 >> 4) * 1000000 / RTP_FEC_CLOCK_RATE);
+    out->spread_us = (uint32_t)(ra->spread_avg_us + SPREAD_DEV_MULT * ra->spread_dev_us);
+    out->wait_us = ra->jb ? (uint32_t)jb_wait_us(ra) : 0;
+}
+
+void fec_reassembler_flush(FecReassembler *ra) {
+    if (!ra->started) return;
+    while ((int32_t)(ra->newest_block - ra->next_block) >= 0)
+        resolve_next(ra);
+    if (ra->in_frame) ra->stats.frames_dropped++;
+    frame_reset(ra);
+}
+
+void fec_reassembler_reset(FecReassembler *ra) {
+    for (unsigned int i = 0; i < ra->window; i++) {
+        ra->slots[i].used = 0;
+        ra->slots[i].expired = 0;
+        ra->slots[i].timed = 0;
+    }
+    // Yeni dizinin geçiş süresi farklı (başka kodlayıcı gecikmesi): jitter yeniden ölçülür
+    ra->have_transit = 0;
+    ra->late_margin_us = 0;
+    if (ra->in_frame) ra->stats.frames_dropped++;
+    frame_reset(ra);
+    ra->started = 0;
+}
+
+/*
+ * Başlangıç bloğu olmadan gelen SSRC: geçişte yoldaki eski katman kısa sürer, yeniden
+ * başlayan gönderici ise IDR'ını GOP sonuna kadar göndermez (intra refresh'te hiç)
+ */
+static int foreign_packet(FecReassembler *ra, uint32_t ssrc) {
+    int64_t now = ra->now_us;
+    if (!ra->have_foreign || ssrc != ra->foreign_ssrc ||
+        now - ra->foreign_last_us > FEC_SSRC_ORPHAN_US) {
+        ra->have_foreign = 1;
+        ra->foreign_ssrc = ssrc;
+        ra->foreign_since_us = now;
+        ra->foreign_request_us = 0;
+    }
+    ra->foreign_last_us = now;
+    if (now - ra->foreign_since_us < FEC_SSRC_ORPHAN_US ||
+        (ra->foreign_request_us && now - ra->foreign_request_us < FEC_SSRC_ORPHAN_US))
+        return FEC_SSRC_STALE;
+    ra->foreign_request_us = now;
+    ra->stats.orphan_requests++;
+    return FEC_SSRC_ORPHAN;
+}
+
+int fec_reassembler_accept_ssrc(FecReassembler *ra, const RtpFecHeader *h) {
+    if (ra->have_ssrc && h->ssrc == ra->ssrc) return FEC_SSRC_ACCEPT;
+    const uint8_t start = RTP_FEC_FLAG_KEYFRAME | RTP_FEC_FLAG_START_OF_FRAME;
+    int rc = FEC_SSRC_ACCEPT;
+    if (ra->have_ssrc) {
+        if ((h->flags & start) != start || (h->flags & RTP_FEC_FLAG_RETRANSMIT)) {
+            ra->stats.stale_packets++;
+            return foreign_packet(ra, h->ssrc);
+        }
+        ra->have_foreign = 0;
+        // Eski katmanın bekleyen blokları artık tamamlanmaz
+        fec_reassembler_reset(ra);
+        ra->stats.layer_switches++;
+        rc = FEC_SSRC_SWITCHED;
+    }
+    ra->ssrc = h->ssrc;
+    ra->have_ssrc = 1;
+    return rc;
+}
+
+void fec_reassembler_get_stats(const FecReassembler *ra, FecReassemblerStats *out) {
+    *out = ra->stats;
+}
+
+void fec_reassembler_get_decoder_stats(const FecReassembler *ra, FecDecoderStats *out) {
+    fec_decoder_get_stats(ra->dec, out);
+}
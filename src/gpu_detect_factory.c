@@ -1,19 +1,48 @@
+
 #include <gst/gst.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/utsname.h>
+#include <unistd.h>
 #include "gpu_detect_factory.h"
 
-static GpuVendor detect_gpu_vendor_lspci(void) {
-    FILE *fp = popen("lspci -nn | grep -i 'vga\\|3d\\|display'", "r");
-    if (!fp) return GPU_UNKNOWN;
-    char line[512]; GpuVendor v = GPU_UNKNOWN;
-    while (fgets(line, sizeof(line), fp)) {
-        if (strstr(line, "8086")) v = GPU_INTEL; // Intel
-        else if (strstr(line, "10de")) v = GPU_NVIDIA; // NVIDIA
-        else if (strstr(line, "1002") || strstr(line, "1022")) v = GPU_AMD; // AMD
+#define PCI_DEVICES_DIR "/sys/bus/pci/devices"
+#define PCI_CLASS_DISPLAY 0x03  /* VGA, 3D, diğer ekran denetleyicileri */
+
+static GpuCapabilities caps;
+
+static int read_hex_file(const char *dir, const char *name, unsigned long *out) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s/%s", PCI_DEVICES_DIR, dir, name);
+    FILE *fp = fopen(path, "r");
+    if (!fp) return -1;
+    int ok = fscanf(fp, "%lx", out) == 1;
+    fclose(fp);
+    return ok ? 0 : -1;
+}
+
+/* lspci sırasıyla (bus adresine göre) ekran denetleyicilerini tarar; sonuncusu kazanır */
+static GpuVendor detect_gpu_vendor_sysfs(void) {
+    struct dirent **list = NULL;
+    int n = scandir(PCI_DEVICES_DIR, &list, NULL, alphasort);
+    if (n < 0) return GPU_UNKNOWN;
+    GpuVendor v = GPU_UNKNOWN;
+    for (int i = 0; i < n; i++) {
+        unsigned long cls, vendor;
+        if (list[i]->d_name[0] != '.' &&
+            read_hex_file(list[i]->d_name, "class", &cls) == 0 &&
+            (cls >> 16) == PCI_CLASS_DISPLAY &&
+            read_hex_file(list[i]->d_name, "vendor", &vendor) == 0) {
+            if (vendor == 0x8086) v = GPU_INTEL; // Intel
+            else if (vendor == 0x10de) v = GPU_NVIDIA; // NVIDIA
+            else if (vendor == 0x1002 || vendor == 0x1022) v = GPU_AMD; // AMD
+        }
+        free(list[i]);
     }
-    pclose(fp);
+    free(list);
     return v;
 }
 
@@ -23,35 +52,158 @@ static int has_elem(const char *name) {
     return 0;
 }
 
-/* 
-   role:
-     "decoder"  -> GPU decode elementi
-     "encoder"  -> GPU encode elementi
-     "sink"     -> GPU sink elementi
-     "postproc" -> GPU postprocess elementi
-*/
-const char* gpu_detect_and_find_factory(const char *role) {
-    GpuVendor v = detect_gpu_vendor_lspci();
+static int str_contains(const char *s, const char *needle) {
+    return s && needle && strstr(s, needle) != NULL;
+}
 
+/* Kayıt defteri sorguları: her rol için tek seferlik seçim */
+static void probe_factories(GpuCapabilities *c) {
     // VAAPI (Intel/AMD)
-    if ((v == GPU_INTEL || v == GPU_AMD) && has_elem("vaapidecodebin")) {
-        if (!strcmp(role,"decoder"))  return "vaapidecodebin";
-        if (!strcmp(role,"encoder"))  return "vaapih264enc";
-        if (!strcmp(role,"sink"))     return "vaapisink";
-        if (!strcmp(role,"postproc")) return "vaapipostproc";
+    if ((c->vendor == GPU_INTEL || c->vendor == GPU_AMD) && has_elem("vaapidecodebin")) {
+        c->decoder  = "vaapidecodebin";
+        c->encoder  = "vaapih264enc";
+        c->sink     = "vaapisink";
+        c->postproc = "vaapipostproc";
     }
 
     // NVIDIA
-    if (v == GPU_NVIDIA && has_elem("nvv4l2decoder")) {
-        if (!strcmp(role,"decoder"))  return "nvv4l2decoder";
-        if (!strcmp(role,"encoder"))  return "nvh264enc";
-        if (!strcmp(role,"sink")) {
-            if (has_elem("nveglglessink")) return "nveglglessink";
-            else if (has_elem("nv3dsink")) return "nv3dsink";
+    if (c->vendor == GPU_NVIDIA && has_elem("nvv4l2decoder")) {
+        c->decoder  = "nvv4l2decoder";
+        c->encoder  = "nvh264enc";
+        if (has_elem("nveglglessink")) c->sink = "nveglglessink";
+        else if (has_elem("nv3dsink")) c->sink = "nv3dsink";
+        c->postproc = "nvvideoconvert";
+    }
+
+    // MJPG kamera için JPEG çözücü: GPU hattıyla aynı aileden, yoksa CPU
+    if (str_contains(c->postproc, "vaapi") || str_contains(c->encoder, "vaapi") ||
+        has_elem("vaapijpegdec")) {
+        c->jpeg_decoder = "vaapijpegdec";
+    } else if (str_contains(c->postproc, "nv") || str_contains(c->encoder, "nv") ||
+               has_elem("nvjpegdec")) {
+        c->jpeg_decoder = "nvjpegdec";
+    } else {
+        c->jpeg_decoder = "jpegdec";
+    }
+}
+
+/* Kayıt defteri dosyalarının en yeni değişiklik zamanı: eklenti kurulunca değişir */
+static long long registry_stamp(void) {
+    const char *env = g_getenv("GST_REGISTRY_1_0");
+    if (!env) env = g_getenv("GST_REGISTRY");
+    struct stat st;
+    if (env) return stat(env, &st) == 0 ? (long long)st.st_mtime ^ (long long)st.st_size : 0;
+
+    char dir[512];
+    const char *xdg = g_getenv("XDG_CACHE_HOME");
+    const char *home = g_getenv("HOME");
+    if (xdg) snprintf(dir, sizeof(dir), "%s/gstreamer-1.0", xdg);
+    else     snprintf(dir, sizeof(dir), "%s/.cache/gstreamer-1.0", home ? home : "");
+    DIR *d = opendir(dir);
+    if (!d) return 0;
+    long long stamp = 0;
+    struct dirent *e;
+    while ((e = readdir(d))) {
+        if (strncmp(e->d_name, "registry.", 9) != 0) continue;
+        char path[1024];
+        snprintf(path, sizeof(path), "%s/%s", dir, e->d_name);
+        if (stat(path, &st) == 0 && (long long)st.st_mtime > stamp) stamp = st.st_mtime;
+    }
+    closedir(d);
+    return stamp;
+}
+
+static void cache_key(char *buf, size_t cap) {
+    struct utsname u;
+    guint major, minor, micro, nano;
+    if (uname(&u) < 0) u.release[0] = '\0';
+    gst_version(&major, &minor, &micro, &nano);
+    snprintf(buf, cap, "%s|%u.%u.%u.%u|%lld", u.release, major, minor, micro, nano,
+             registry_stamp());
+}
+
+/* Boş değer NULL demektir; okunan adlar süreç boyunca tutulur */
+static const char* cache_value(const char *v) {
+    return *v ? g_strdup(v) : NULL;
+}
+
+static int cache_load(const char *path, const char *key, GpuCapabilities *c) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) return -1;
+    char line[512];
+    int key_ok = 0, vendor = -1;
+    GpuCapabilities tmp = { 0 };
+    while (fgets(line, sizeof(line), fp)) {
+        line[strcspn(line, "\n")] = '\0';
+        char *eq = strchr(line, '=');
+        if (!eq) continue;
+        *eq = '\0';
+        const char *v = eq + 1;
+        if (!strcmp(line, "key"))               key_ok = !strcmp(v, key);
+        else if (!strcmp(line, "vendor"))       vendor = atoi(v);
+        else if (!strcmp(line, "decoder"))      tmp.decoder = cache_value(v);
+        else if (!strcmp(line, "encoder"))      tmp.encoder = cache_value(v);
+        else if (!strcmp(line, "postproc"))     tmp.postproc = cache_value(v);
+        else if (!strcmp(line, "sink"))         tmp.sink = cache_value(v);
+        else if (!strcmp(line, "jpeg_decoder")) tmp.jpeg_decoder = cache_value(v);
+    }
+    fclose(fp);
+    // Anahtar tutmuyor ya da GPU değişmiş: yeniden sorgulanacak
+    if (!key_ok || vendor != (int)c->vendor || !tmp.jpeg_decoder) {
+        g_free((gpointer)tmp.decoder);
+        g_free((gpointer)tmp.encoder);
+        g_free((gpointer)tmp.postproc);
+        g_free((gpointer)tmp.sink);
+        g_free((gpointer)tmp.jpeg_decoder);
+        return -1;
+    }
+    tmp.vendor = c->vendor;
+    tmp.from_cache = 1;
+    *c = tmp;
+    return 0;
+}
+
+/* Geçici dosyaya yazıp rename: aynı anda başlayan süreçler yarım dosya görmez */
+static void cache_store(const char *path, const char *key, const GpuCapabilities *c) {
+    char tmp[1024];
+    snprintf(tmp, sizeof(tmp), "%s.%d.tmp", path, (int)getpid());
+    FILE *fp = fopen(tmp, "w");
+    if (!fp) return;
+    fprintf(fp, "key=%s\nvendor=%d\ndecoder=%s\nencoder=%s\npostproc=%s\nsink=%s\njpeg_decoder=%s\n",
+            key, (int)c->vendor, c->decoder ? c->decoder : "", c->encoder ? c->encoder : "",
+            c->postproc ? c->postproc : "", c->sink ? c->sink : "", c->jpeg_decoder);
+    if (fclose(fp) != 0 || rename(tmp, path) != 0) remove(tmp);
+}
+
+const GpuCapabilities* gpu_detect_capabilities(void) {
+    static gsize once = 0;
+    if (g_once_init_enter(&once)) {
+        caps.vendor = detect_gpu_vendor_sysfs();
+
+        const char *cache = g_getenv("GPU_CAPS_CACHE");
+        char key[512];
+        if (cache && *cache) cache_key(key, sizeof(key));
+        if (!cache || !*cache || cache_load(cache, key, &caps) < 0) {
+            probe_factories(&caps);
+            if (cache && *cache) cache_store(cache, key, &caps);
         }
-        if (!strcmp(role,"postproc")) return "nvvideoconvert";
+        g_once_init_leave(&once, 1);
     }
+    return &caps;
+}
 
+/*
+   role:
+     "decoder"  -> GPU decode elementi
+     "encoder"  -> GPU encode elementi
+     "sink"     -> GPU sink elementi
+     "postproc" -> GPU postprocess elementi
+*/
+const char* gpu_detect_and_find_factory(const char *role) {
+    const GpuCapabilities *c = gpu_detect_capabilities();
+    if (!strcmp(role,"decoder"))  return c->decoder;
+    if (!strcmp(role,"encoder"))  return c->encoder;
+    if (!strcmp(role,"sink"))     return c->sink;
+    if (!strcmp(role,"postproc")) return c->postproc;
     return NULL; // hızlandırma yok
 }
-
@@ -0,0 +1,82 @@
+#include <gst/gst.h>
+#include <string.h>
+#include "gpu_memory.h"
+
+#define SYSTEM_MEMORY "SystemMemory"
+
+const char* gpu_memory_caps_for(const char *factory) {
+    if (!factory) return NULL;
+    if (g_str_has_prefix(factory, "vaapi")) return "video/x-raw(memory:VASurface)";
+    return "video/x-raw(memory:DMABuf)";
+}
+
+gboolean gpu_memory_accepts(GstElement *element, const char *caps_str) {
+    GstElementFactory *f = element ? gst_element_get_factory(element) : NULL;
+    if (!f || !caps_str) return FALSE;
+    GstCaps *caps = gst_caps_from_string(caps_str);
+    if (!caps) return FALSE;
+    gboolean ok = gst_element_factory_can_sink_any_caps(f, caps);
+    gst_caps_unref(caps);
+    return ok;
+}
+
+gchar* gpu_memory_pad_kind(GstPad *pad) {
+    GstCaps *caps = pad ? gst_pad_get_current_caps(pad) : NULL;
+    if (!caps) return NULL;
+    const gchar *name = NULL;
+    GstCapsFeatures *f = gst_caps_get_size(caps) ? gst_caps_get_features(caps, 0) : NULL;
+    if (f && !gst_caps_features_is_any(f) && gst_caps_features_get_size(f) > 0)
+        name = gst_caps_features_get_nth(f, 0);
+    // "memory:" önekini at; özelliksiz caps sistem belleğidir
+    if (name && g_str_has_prefix(name, "memory:")) name += 7;
+    gchar *kind = g_strdup(name ? name : SYSTEM_MEMORY);
+    gst_caps_unref(caps);
+    return kind;
+}
+
+gboolean gpu_memory_add_download(GstElement *pipeline, const char *post_name, const char *branch,
+                                 GstElement **chain, int *n) {
+    gchar *conv_name = g_strdup_printf("%s_download", branch);
+    gchar *cf_name = g_strdup_printf("%s_sysmem", branch);
+    GstElement *conv = gst_element_factory_make(post_name, conv_name);
+    GstElement *cf = gst_element_factory_make("capsfilter", cf_name);
+    g_free(conv_name);
+    g_free(cf_name);
+    if (!conv || !cf) {
+        g_printerr("Failed to create %s branch download elements\n", branch);
+        if (conv) gst_object_unref(gst_object_ref_sink(conv));
+        if (cf)   gst_object_unref(gst_object_ref_sink(cf));
+        return FALSE;
+    }
+    GstCaps *sys_caps = gst_caps_from_string("video/x-raw");
+    g_object_set(cf, "caps", sys_caps, NULL);
+    gst_caps_unref(sys_caps);
+    gst_bin_add_many(GST_BIN(pipeline), conv, cf, NULL);
+    chain[(*n)++] = conv;
+    chain[(*n)++] = cf;
+    return TRUE;
+}
+
+int gpu_memory_report_branch(const char *prefix, const char *branch,
+                             GstElement **chain, int n) {
+    GString *path = g_string_new(NULL);
+    int downloads = 0, device = 0;
+    for (int i = 0; i < n; i++) {
+        GstPad *pad = gst_element_get_static_pad(chain[i], i == 0 ? "src" : "sink");
+        gchar *kind = gpu_memory_pad_kind(pad);
+        if (pad) gst_object_unref(pad);
+        if (!kind) {
+            g_string_free(path, TRUE);
+            return -1;
+        }
+        gboolean sys = strcmp(kind, SYSTEM_MEMORY) == 0;
+        if (sys && device) downloads++;
+        device = !sys;
+        g_string_append_printf(path, "%s%s %s", i ? " -> " : "", GST_ELEMENT_NAME(chain[i]), kind);
+        g_free(kind);
+    }
+    g_print(" > %sMemory path (%s): %s: %s\n", prefix, branch, path->str,
+            downloads ? "system-memory download" : device ? "zero-copy GPU memory" : "system memory");
+    g_string_free(path, TRUE);
+    return downloads;
+}
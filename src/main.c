@@ -3,6 +3,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include "gpu_detect_factory.h"
+#include "media_source.h"
+#include "gpu_memory.h"
 
 static gboolean bus_call(GstBus *bus, GstMessage *msg, gpointer data) {
     GMainLoop *loop = (GMainLoop *)data;
@@ -25,12 +27,22 @@ static gboolean bus_call(GstBus *bus, GstMessage *msg, gpointer data) {
     return TRUE;
 }
 
-static gboolean str_contains(const char *s, const char *needle) {
-    return s && needle && strstr(s, needle) != NULL;
-}
-
 int main(int argc, char **argv)
 {
+    MediaSourceConfig src_cfg;
+    media_source_default_config(&src_cfg);
+    GError *opt_err = NULL;
+    GOptionContext *opt_ctx = g_option_context_new("- camera preview");
+    media_source_add_options(opt_ctx, &src_cfg);
+    g_option_context_add_group(opt_ctx, gst_init_get_option_group());
+    if (!g_option_context_parse(opt_ctx, &argc, &argv, &opt_err)) {
+        g_printerr("Option parsing failed: %s\n", opt_err->message);
+        g_clear_error(&opt_err);
+        g_option_context_free(opt_ctx);
+        return 1;
+    }
+    g_option_context_free(opt_ctx);
+
     gst_init(&argc, &argv);
     GMainLoop *loop = g_main_loop_new(NULL, FALSE);
 
@@ -38,39 +50,20 @@ int main(int argc, char **argv)
     const char *sink_name = gpu_detect_and_find_factory("sink");     //  "vaapisink", "nveglglessink", "glimagesink"
 
     GstElement *pipeline = gst_pipeline_new("Cam720p_FPS_Test");
-    GstElement *src      = gst_element_factory_make("v4l2src", "src");
-    GstElement *mjpg_cf  = gst_element_factory_make("capsfilter", "mjpg_caps");
    
-    const char *dec_name = NULL;
-    if (strstr(sink_name, "vaapi") || strstr(post_name, "vaapi")) {
-        dec_name = "vaapijpegdec";
-    } else if (strstr(sink_name, "nv") || strstr(post_name, "nv")) {
-        dec_name = "nvjpegdec";
-    } else {
-        dec_name = "jpegdec"; // Fallback
-    }
+    const char *dec_name = gpu_detect_capabilities()->jpeg_decoder; // GPU ailesinden, yoksa jpegdec
 
-    GstElement *dec      = gst_element_factory_make(dec_name, "dec");
+    // Kamera (v4l2src + MJPG caps + JPEG decoder), test deseni ya da MJPEG dosyası
+    GstElement *src      = media_source_new(&src_cfg, dec_name, "src");
     GstElement *post     = NULL;
     GstElement *sink     = NULL;
     
-    if (!pipeline || !src || !mjpg_cf || !dec) {
+    if (!pipeline || !src) {
         g_printerr("Failed to create base or decoder elements\n");
         return 1;
     }
-
-    g_object_set(src, "device", "/dev/video0", NULL);
     // g_object_set(src, "extra-controls", "c,compression_quality=95", NULL);
 
-    //  MJPG veriyor → src den JPEG caps iste
-    GstCaps *mjpg_caps = gst_caps_new_simple("image/jpeg",
-        "width",  G_TYPE_INT, 1280,
-        "height", G_TYPE_INT, 720,
-        "framerate", GST_TYPE_FRACTION, 30, 1,
-        NULL);
-    g_object_set(mjpg_cf, "caps", mjpg_caps, NULL);
-    gst_caps_unref(mjpg_caps);
-
     if (post_name) post = gst_element_factory_make(post_name, "gpu_post");
 
     if (sink_name) sink = gst_element_factory_make(sink_name, "gpu_sink");
@@ -87,23 +80,20 @@ int main(int argc, char **argv)
         GstElement *gpu_cf = gst_element_factory_make("capsfilter", "gpu_caps");
         if (!gpu_cf) { g_printerr("Failed to create gpu capsfilter\n"); return 1; }
 
-        GstCaps *gpu_caps = gst_caps_from_string("video/x-raw(memory:DMABuf)");
-        if (post_name && strstr(post_name, "vaapi")) {
-            gst_caps_unref(gpu_caps);
-            gpu_caps = gst_caps_from_string("video/x-raw(memory:VASurface)");
-        }
+        // vaapi* -> VASurface, diğer GPU post-proc'lar -> DMABuf
+        GstCaps *gpu_caps = gst_caps_from_string(gpu_memory_caps_for(post_name));
         g_object_set(gpu_cf, "caps", gpu_caps, NULL);
         gst_caps_unref(gpu_caps);
 
-        gst_bin_add_many(GST_BIN(pipeline), src, mjpg_cf, dec, post, gpu_cf, sink, NULL);
-        gboolean linked = gst_element_link_many(src, mjpg_cf, dec, post, gpu_cf, sink, NULL);
+        gst_bin_add_many(GST_BIN(pipeline), src, post, gpu_cf, sink, NULL);
+        gboolean linked = gst_element_link_many(src, post, gpu_cf, sink, NULL);
         if (!linked) {
             g_printerr("Failed to link elements with GPU memory caps\n");
             return 1;
         }
     } else {
-        gst_bin_add_many(GST_BIN(pipeline), src, mjpg_cf, dec, sink, NULL);
-        gboolean linked = gst_element_link_many(src, mjpg_cf, dec, sink, NULL);
+        gst_bin_add_many(GST_BIN(pipeline), src, sink, NULL);
+        gboolean linked = gst_element_link_many(src, sink, NULL);
         if (!linked) {
             g_printerr("Failed to link elements (simple)\n");
             return 1;
@@ -122,5 +112,6 @@ int main(int argc, char **argv)
     gst_element_set_state(pipeline, GST_STATE_NULL);
     gst_object_unref(pipeline);
     g_main_loop_unref(loop);
+    media_source_config_clear(&src_cfg);
     return 0;
 }
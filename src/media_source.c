@@ -0,0 +1,146 @@
+#include <gst/gst.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "media_source.h"
+
+void media_source_default_config(MediaSourceConfig *cfg) {
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->width = 1280;
+    cfg->height = 720;
+    cfg->fps = 30;
+}
+
+void media_source_config_clear(MediaSourceConfig *cfg) {
+    g_clear_pointer(&cfg->kind_name, g_free);
+    g_clear_pointer(&cfg->device, g_free);
+    g_clear_pointer(&cfg->location, g_free);
+}
+
+void media_source_add_options(GOptionContext *ctx, MediaSourceConfig *cfg) {
+    GOptionEntry entries[] = {
+        { "source", 0, 0, G_OPTION_ARG_STRING, &cfg->kind_name,
+          "Video input: camera, test or file (default camera)", "KIND" },
+        { "device", 0, 0, G_OPTION_ARG_STRING, &cfg->device,
+          "V4L2 device for the camera source (default /dev/video0)", "DEV" },
+        { "location", 0, 0, G_OPTION_ARG_STRING, &cfg->location,
+          "MJPEG file (concatenated JPEG frames) for the file source", "FILE" },
+        { "width", 0, 0, G_OPTION_ARG_INT, &cfg->width,
+          "Capture width (default 1280)", "PX" },
+        { "height", 0, 0, G_OPTION_ARG_INT, &cfg->height,
+          "Capture height (default 720)", "PX" },
+        { "fps", 0, 0, G_OPTION_ARG_INT, &cfg->fps,
+          "Capture / replay frame rate (default 30)", "FPS" },
+        { "loop", 0, 0, G_OPTION_ARG_NONE, &cfg->loop,
+          "Restart the file source at end of file", NULL },
+        G_OPTION_ENTRY_NULL
+    };
+    GOptionGroup *group = g_option_group_new("source", "Video input options:",
+                                             "Show video input options", NULL, NULL);
+    g_option_group_add_entries(group, entries);
+    g_option_context_add_group(ctx, group);
+}
+
+int media_source_get_kind(const MediaSourceConfig *cfg, MediaSourceKind *out) {
+    const char *name = cfg->kind_name ? cfg->kind_name : "camera";
+    if (!strcmp(name, "camera") || !strcmp(name, "v4l2")) *out = MEDIA_SOURCE_CAMERA;
+    else if (!strcmp(name, "test"))                         *out = MEDIA_SOURCE_TEST;
+    else if (!strcmp(name, "file") && cfg->location)        *out = MEDIA_SOURCE_FILE;
+    else return -1;
+    return 0;
+}
+
+/* Elemanları bin'e ekleyip sırayla bağlar, son elemanın çıkışını ghost pad yapar */
+static GstElement* finish_bin(GstElement *bin, GstElement **chain, int n) {
+    for (int i = 0; i < n; i++) {
+        if (!chain[i]) {
+            g_printerr("Failed to create source element %d\n", i);
+            for (int j = 0; j < n; j++)
+                if (chain[j]) gst_object_unref(chain[j]);
+            gst_object_unref(bin);
+            return NULL;
+        }
+    }
+    for (int i = 0; i < n; i++) gst_bin_add(GST_BIN(bin), chain[i]);
+    for (int i = 0; i + 1 < n; i++) {
+        if (!gst_element_link(chain[i], chain[i + 1])) {
+            g_printerr("Failed to link source elements\n");
+            gst_object_unref(bin);
+            return NULL;
+        }
+    }
+    GstPad *pad = gst_element_get_static_pad(chain[n - 1], "src");
+    gst_element_add_pad(bin, gst_ghost_pad_new("src", pad));
+    gst_object_unref(pad);
+    return bin;
+}
+
+GstElement* media_source_new(const MediaSourceConfig *cfg, const char *jpeg_dec,
+                             const char *name) {
+    MediaSourceKind kind;
+    if (media_source_get_kind(cfg, &kind) < 0) {
+        g_printerr("Unknown video source '%s' (use camera, test or file with --location)\n",
+                   cfg->kind_name ? cfg->kind_name : "");
+        return NULL;
+    }
+    int fps = cfg->fps > 0 ? cfg->fps : 30;
+    GstElement *bin = gst_bin_new(name);
+    GstElement *chain[5] = { NULL };
+    GstCaps *caps;
+
+    switch (kind) {
+    case MEDIA_SOURCE_CAMERA:
+        // Kamera MJPG veriyor → src'den JPEG caps iste
+        chain[0] = gst_element_factory_make("v4l2src", NULL);
+        chain[1] = gst_element_factory_make("capsfilter", NULL);
+        chain[2] = gst_element_factory_make(jpeg_dec ? jpeg_dec : "jpegdec", NULL);
+        if (chain[0])
+            g_object_set(chain[0], "device", cfg->device ? cfg->device : "/dev/video0", NULL);
+        caps = gst_caps_new_simple("image/jpeg",
+            "width",  G_TYPE_INT, cfg->width,
+            "height", G_TYPE_INT, cfg->height,
+            "framerate", GST_TYPE_FRACTION, fps, 1,
+            NULL);
+        if (chain[1]) g_object_set(chain[1], "caps", caps, NULL);
+        gst_caps_unref(caps);
+        return finish_bin(bin, chain, 3);
+
+    case MEDIA_SOURCE_TEST:
+        // Hareketli desen: kodlayıcı her karede gerçek P-frame üretir
+        chain[0] = gst_element_factory_make("videotestsrc", NULL);
+        chain[1] = gst_element_factory_make("capsfilter", NULL);
+        if (chain[0]) {
+            g_object_set(chain[0], "is-live", TRUE, NULL);
+            gst_util_set_object_arg(G_OBJECT(chain[0]), "pattern", "ball");
+        }
+        caps = gst_caps_new_simple("video/x-raw",
+            "width",  G_TYPE_INT, cfg->width,
+            "height", G_TYPE_INT, cfg->height,
+            "framerate", GST_TYPE_FRACTION, fps, 1,
+            NULL);
+        if (chain[1]) g_object_set(chain[1], "caps", caps, NULL);
+        gst_caps_unref(caps);
+        return finish_bin(bin, chain, 2);
+
+    case MEDIA_SOURCE_FILE:
+        // jpegparse kareleri ayırıp framerate'e göre zaman damgalar, identity gerçek zamanlı hızlar
+        chain[0] = gst_element_factory_make(cfg->loop ? "multifilesrc" : "filesrc", NULL);
+        chain[1] = gst_element_factory_make("capsfilter", NULL);
+        chain[2] = gst_element_factory_make("jpegparse", NULL);
+        chain[3] = gst_element_factory_make("identity", NULL);
+        chain[4] = gst_element_factory_make(jpeg_dec ? jpeg_dec : "jpegdec", NULL);
+        if (chain[0]) {
+            g_object_set(chain[0], "location", cfg->location, NULL);
+            if (cfg->loop) g_object_set(chain[0], "loop", TRUE, NULL);
+        }
+        caps = gst_caps_new_simple("image/jpeg",
+            "framerate", GST_TYPE_FRACTION, fps, 1,
+            NULL);
+        if (chain[1]) g_object_set(chain[1], "caps", caps, NULL);
+        gst_caps_unref(caps);
+        if (chain[3]) g_object_set(chain[3], "sync", TRUE, NULL);
+        return finish_bin(bin, chain, 5);
+    }
+    gst_object_unref(bin);
+    return NULL;
+}
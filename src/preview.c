@@ -0,0 +1,168 @@
+#include <gst/gst.h>
+#include <stdio.h>
+#include <string.h>
+#include "preview.h"
+
+#define DEFAULT_QUEUE_FRAMES 2
+
+struct PreviewBranch {
+    PreviewConfig cfg;
+    GstElement *queue;
+    GstElement *sink;
+    gboolean attached;              /* elemanlar pipeline'a geçti */
+
+    GstClockTime interval;          /* --preview-fps; GST_CLOCK_TIME_NONE -> seyreltme yok */
+    GstClockTime next_pts;
+
+    gint frames;
+    gint dropped;
+    gint decimated;
+};
+
+void preview_default_config(PreviewConfig *cfg) {
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->queue_frames = DEFAULT_QUEUE_FRAMES;
+}
+
+void preview_add_options(GOptionContext *ctx, PreviewConfig *cfg) {
+    GOptionEntry entries[] = {
+        { "preview-queue", 0, 0, G_OPTION_ARG_INT, &cfg->queue_frames,
+          "Frames the preview queue holds before dropping the oldest (default 2)", "N" },
+        { "preview-width", 0, 0, G_OPTION_ARG_INT, &cfg->width,
+          "Downscale the preview to this width (default 0, source size)", "PX" },
+        { "preview-height", 0, 0, G_OPTION_ARG_INT, &cfg->height,
+          "Downscale the preview to this height (default 0, source size)", "PX" },
+        { "preview-fps", 0, 0, G_OPTION_ARG_INT, &cfg->fps,
+          "Show at most this many preview frames per second (default 0, source rate)", "FPS" },
+        G_OPTION_ENTRY_NULL
+    };
+    GOptionGroup *group = g_option_group_new("preview", "Local preview options:",
+                                             "Show local preview options", NULL, NULL);
+    g_option_group_add_entries(group, entries);
+    g_option_context_add_group(ctx, group);
+}
+
+// Sızdıran kuyrukta "overrun" en eski karenin atılmasından hemen önce gelir
+static void on_overrun(GstElement *queue, gpointer data) {
+    PreviewBranch *p = data;
+    g_atomic_int_inc(&p->dropped);
+}
+
+// Kuyruk girişi (tee iş parçacığı): kareler PTS'e göre seyreltilir; ortalama hız korunur
+static GstPadProbeReturn on_queue_input(GstPad *pad, GstPadProbeInfo *info, gpointer data) {
+    PreviewBranch *p = data;
+    GstClockTime pts = GST_BUFFER_PTS(GST_PAD_PROBE_INFO_BUFFER(info));
+    if (!GST_CLOCK_TIME_IS_VALID(pts)) return GST_PAD_PROBE_OK;
+    if (GST_CLOCK_TIME_IS_VALID(p->next_pts) && pts < p->next_pts) {
+        g_atomic_int_inc(&p->decimated);
+        return GST_PAD_PROBE_DROP;
+    }
+    // Takılma ya da atlama sonrası birikmiş açığı kapatmaya çalışma
+    if (!GST_CLOCK_TIME_IS_VALID(p->next_pts) || pts - p->next_pts >= p->interval)
+        p->next_pts = pts;
+    p->next_pts += p->interval;
+    return GST_PAD_PROBE_OK;
+}
+
+static GstPadProbeReturn on_queue_output(GstPad *pad, GstPadProbeInfo *info, gpointer data) {
+    PreviewBranch *p = data;
+    g_atomic_int_inc(&p->frames);
+    return GST_PAD_PROBE_OK;
+}
+
+PreviewBranch* preview_branch_new(const PreviewConfig *cfg, const char *sink_name) {
+    PreviewBranch *p = g_new0(PreviewBranch, 1);
+    p->cfg = *cfg;
+    if (p->cfg.queue_frames < 1) p->cfg.queue_frames = 1;
+    p->interval = cfg->fps > 0 ? gst_util_uint64_scale_int(GST_SECOND, 1, cfg->fps)
+                               : GST_CLOCK_TIME_NONE;
+    p->next_pts = GST_CLOCK_TIME_NONE;
+
+    p->queue = gst_element_factory_make("queue", "q_disp");
+    if (sink_name) p->sink = gst_element_factory_make(sink_name, "gpu_sink");
+    if (!p->sink)  p->sink = gst_element_factory_make("autovideosink", "cpu_sink");
+    if (!p->queue || !p->sink) {
+        g_printerr("Failed to create preview %s\n", p->queue ? "sink" : "queue");
+        preview_branch_free(p);
+        return NULL;
+    }
+
+    // Yalnızca kare sayısı sınırlı; byte ve süre sınırı büyük karelerde erken sızdırmasın
+    g_object_set(p->queue, "max-size-buffers", (guint)p->cfg.queue_frames,
+                 "max-size-bytes", 0u, "max-size-time", (guint64)0, NULL);
+    gst_util_set_object_arg(G_OBJECT(p->queue), "leaky", "downstream");
+    g_signal_connect(p->queue, "overrun", G_CALLBACK(on_overrun), p);
+
+    GstPad *in = gst_element_get_static_pad(p->queue, "sink");
+    GstPad *out = gst_element_get_static_pad(p->queue, "src");
+    if (GST_CLOCK_TIME_IS_VALID(p->interval))
+        gst_pad_add_probe(in, GST_PAD_PROBE_TYPE_BUFFER, on_queue_input, p, NULL);
+    gst_pad_add_probe(out, GST_PAD_PROBE_TYPE_BUFFER, on_queue_output, p, NULL);
+    gst_object_unref(in);
+    gst_object_unref(out);
+    return p;
+}
+
+GstElement* preview_branch_sink(PreviewBranch *p) {
+    return p->sink;
+}
+
+GstElement* preview_branch_attach(PreviewBranch *p, GstElement *pipeline, const char *converter,
+                                  const char *mem_caps, gboolean download,
+                                  GstElement **path, int *path_len) {
+    gboolean scale = p->cfg.width > 0 && p->cfg.height > 0;
+    gst_bin_add_many(GST_BIN(pipeline), p->queue, p->sink, NULL);
+    p->attached = TRUE;
+
+    GstElement *chain[4];
+    int n = 0;
+    chain[n++] = p->queue;
+    if (scale || download) {
+        // Post-proc varsa ölçekleme cihaz belleğinde yapılır; indirme gerekiyorsa aynı adımda
+        GstElement *conv = gst_element_factory_make(converter ? converter : "videoscale",
+                                                    "preview_convert");
+        GstElement *cf = gst_element_factory_make("capsfilter", "preview_caps");
+        if (!conv || !cf) {
+            g_printerr("Failed to create preview %s\n", conv ? "capsfilter" : "converter");
+            if (conv) gst_object_unref(gst_object_ref_sink(conv));
+            if (cf)   gst_object_unref(gst_object_ref_sink(cf));
+            return NULL;
+        }
+        const char *base = mem_caps && !download ? mem_caps : "video/x-raw";
+        gchar *caps_str = scale ? g_strdup_printf("%s,width=%d,height=%d", base,
+                                                  p->cfg.width, p->cfg.height)
+                                : g_strdup(base);
+        GstCaps *caps = gst_caps_from_string(caps_str);
+        g_free(caps_str);
+        g_object_set(cf, "caps", caps, NULL);
+        gst_caps_unref(caps);
+        gst_bin_add_many(GST_BIN(pipeline), conv, cf, NULL);
+        chain[n++] = conv;
+        chain[n++] = cf;
+    }
+    chain[n++] = p->sink;
+    for (int i = 0; i < n - 1; i++) {
+        if (!gst_element_link(chain[i], chain[i + 1])) {
+            g_printerr("Failed to link preview branch (%s -> %s)\n",
+                       GST_ELEMENT_NAME(chain[i]), GST_ELEMENT_NAME(chain[i + 1]));
+            return NULL;
+        }
+    }
+    for (int i = 0; i < n; i++) path[(*path_len)++] = chain[i];
+    return p->queue;
+}
+
+void preview_branch_get_stats(PreviewBranch *p, PreviewStats *out) {
+    out->frames = (guint64)g_atomic_int_get(&p->frames);
+    out->dropped = (guint64)g_atomic_int_get(&p->dropped);
+    out->decimated = (guint64)g_atomic_int_get(&p->decimated);
+}
+
+void preview_branch_free(PreviewBranch *p) {
+    if (!p) return;
+    if (!p->attached) {
+        if (p->queue) gst_object_unref(gst_object_ref_sink(p->queue));
+        if (p->sink)  gst_object_unref(gst_object_ref_sink(p->sink));
+    }
+    g_free(p);
+}
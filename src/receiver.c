@@ -0,0 +1,671 @@
+#define _GNU_SOURCE /* recvmmsg */
+#include <gst/gst.h>
+#include <gst/app/gstappsrc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include "gpu_detect_factory.h"
+#include "rtp_fec.h"
+#include "fec_reassembler.h"
+#include "rtcp_feedback.h"
+#include "telemetry.h"
+
+// Tek recvmmsg çağrısında okunacak en fazla datagram
+#define RECV_BATCH 64
+#define RECV_MAX_DATAGRAM 2048
+
+// Yanıtsız kalan PLI bu süreden sonra yinelenir (IDR'ın kendisi de kaybolmuş olabilir)
+#define PLI_RETRY_US 300000
+
+// Gecikme histogramı: 100 µs'lik kutular, 1 s'ye kadar (üstü son kutuda)
+#define LATENCY_BIN_US 100
+#define LATENCY_BINS   10000
+
+// Jitter tamponu bekleyen blok yokken de en geç bu aralıkla uyanır (RR, kapanış)
+#define IDLE_WAKE_US 100000
+
+typedef struct {
+    int fd;
+    GstElement *appsrc;
+    FecReassembler *ra;
+    gint running;
+
+    /* Göndericiye RTCP RR ile kayıp bildirimi (yalnızca ağ iş parçacığı kullanır) */
+    RtcpLossTracker loss;
+    guint32 ssrc;
+    int feedback_port;
+    gint64 report_interval_us;
+    gint64 last_report_us;
+    struct sockaddr_in sender_addr;
+    int have_sender;
+
+    /* crc32c tutmayan, silinme olarak atılan shard paketleri (ağ iş parçacığı) */
+    guint64 checksum_errors;
+    /* FEC başlık sürümü tutmayan paketler (gönderici başka parity düzeni kullanıyor) */
+    guint64 version_errors;
+
+    /* PLI/NACK geri bildirimi (yalnızca ağ iş parçacığı); NACK'ler toplu okuma sonunda gider */
+    gboolean send_pli;
+    RtcpBlockNack nacks[RTCP_NACK_MAX_BLOCKS];
+    int nack_count;
+    guint64 nack_messages;
+    guint64 plis_sent;
+    gint64 pli_pending_us;          /* yanıt beklenen ilk PLI, 0 -> yok */
+    gint64 last_pli_us;
+    guint64 recoveries;             /* PLI -> keyframe */
+    guint64 recovery_sum_us;
+    guint64 recovery_max_us;
+
+    /* --latency: yakalama -> yeniden kurma gecikmesi (yalnızca ağ iş parçacığı yazar) */
+    int measure_latency;
+    guint32 *latency_hist;
+    guint64 latency_samples;
+    guint64 latency_sum_us;
+
+    /* --jitter-buffer: son tarihler ağ iş parçacığında ppoll zaman aşımıyla işlenir */
+    int jitter_buffer;
+
+    /* --metrics-port: ağ iş parçacığı her toplu okumadan sonra kopyalar, kazıma kilitle okur */
+    GMutex stats_lock;
+    FecReassemblerStats ra_snap;
+    FecJitterStats jb_snap;
+    guint64 checksum_errors_snap;
+
+    /* Sink'e ulaşan çözülmüş kareler (akış iş parçacığı) */
+    gint64 first_frame_us;
+    gint64 last_frame_us;
+    guint64 frames_decoded;
+} ReceiverEngine;
+
+static gboolean bus_call(GstBus *bus, GstMessage *msg, gpointer data) {
+    GMainLoop *loop = (GMainLoop *)data;
+    switch (GST_MESSAGE_TYPE(msg)) {
+        case GST_MESSAGE_ERROR: {
+            GError *err = NULL; gchar *dbg = NULL;
+            gst_message_parse_error(msg, &err, &dbg);
+            g_printerr("ERROR: %s\n", err->message);
+            if (dbg) g_printerr("Debug: %s\n", dbg);
+            g_clear_error(&err); g_free(dbg);
+            g_main_loop_quit(loop);
+            break;
+        }
+        case GST_MESSAGE_EOS:
+            g_print("EOS\n");
+            g_main_loop_quit(loop);
+            break;
+        default: break;
+    }
+    return TRUE;
+}
+
+// Yeniden kurulan H.264 verisini appsrc'ye iter; gecikme yalnızca birimin sonunda ölçülür.
+// NAL hizalı girişte (--slices) MARKER h264parse'a erişim biriminin bittiğini söyler.
+static void push_h264(ReceiverEngine *eng, const unsigned char *data, size_t len,
+                      uint32_t rtp_timestamp, int keyframe, int end_of_frame) {
+    if (keyframe && eng->pli_pending_us) {
+        // Kurtarma süresi: ilk PLI'dan IDR'ın ilk parçasının decoder'a girişine
+        guint64 us = (guint64)(g_get_monotonic_time() - eng->pli_pending_us);
+        eng->recoveries++;
+        eng->recovery_sum_us += us;
+        if (us > eng->recovery_max_us) eng->recovery_max_us = us;
+        eng->pli_pending_us = 0;
+    }
+    if (eng->measure_latency && end_of_frame) {
+        // Gönderici RTP zaman damgasını CLOCK_MONOTONIC yakalama anından üretir (aynı makine)
+        guint32 now90 = (guint32)((guint64)g_get_monotonic_time() * RTP_FEC_CLOCK_RATE / G_USEC_PER_SEC);
+        guint32 ticks = now90 - rtp_timestamp;
+        if (ticks < 0x80000000u) {
+            guint64 us = (guint64)ticks * G_USEC_PER_SEC / RTP_FEC_CLOCK_RATE;
+            guint64 bin = us / LATENCY_BIN_US;
+            eng->latency_hist[bin < LATENCY_BINS ? bin : LATENCY_BINS - 1]++;
+            eng->latency_samples++;
+            eng->latency_sum_us += us;
+        }
+    }
+    GstBuffer *buf = gst_buffer_new_allocate(NULL, len, NULL);
+    if (!buf) return;
+    gst_buffer_fill(buf, 0, data, len);
+    if (!keyframe) GST_BUFFER_FLAG_SET(buf, GST_BUFFER_FLAG_DELTA_UNIT);
+    if (end_of_frame) GST_BUFFER_FLAG_SET(buf, GST_BUFFER_FLAG_MARKER);
+    gst_app_src_push_buffer(GST_APP_SRC(eng->appsrc), buf);
+}
+
+// Yeniden kurulan her H.264 erişim birimini appsrc'ye iter
+static void on_frame_reassembled(void *user, const unsigned char *data, size_t len,
+                                 uint32_t rtp_timestamp, int keyframe) {
+    push_h264(user, data, len, rtp_timestamp, keyframe, 1);
+}
+
+// --slices: slice grupları birim tamamlanmadan parser ve decoder'a gider
+static void on_slice_reassembled(void *user, const unsigned char *data, size_t len,
+                                 uint32_t rtp_timestamp, int keyframe, int end_of_frame) {
+    push_h264(user, data, len, rtp_timestamp, keyframe, end_of_frame);
+}
+
+// Sink'e giren her çözülmüş kare: fps ölçümü
+static GstPadProbeReturn on_decoded_frame(GstPad *pad, GstPadProbeInfo *info, gpointer data) {
+    ReceiverEngine *eng = data;
+    gint64 now = g_get_monotonic_time();
+    if (!eng->frames_decoded) eng->first_frame_us = now;
+    eng->last_frame_us = now;
+    eng->frames_decoded++;
+    return GST_PAD_PROBE_OK;
+}
+
+static double latency_percentile_ms(const ReceiverEngine *eng, double q) {
+    guint64 target = (guint64)(q * eng->latency_samples), seen = 0;
+    for (int i = 0; i < LATENCY_BINS; i++) {
+        seen += eng->latency_hist[i];
+        if (seen > target) return (i + 1) * LATENCY_BIN_US / 1000.0;
+    }
+    return LATENCY_BINS * LATENCY_BIN_US / 1000.0;
+}
+
+// --duration dolduğunda ana döngüyü bitirir
+static gboolean on_duration_elapsed(gpointer data) {
+    g_main_loop_quit((GMainLoop *)data);
+    return G_SOURCE_REMOVE;
+}
+
+static void send_feedback(ReceiverEngine *eng, const guint8 *buf, size_t len) {
+    if (!eng->have_sender || !len) return;
+    struct sockaddr_in dst = eng->sender_addr;
+    dst.sin_port = htons(eng->feedback_port);
+    sendto(eng->fd, buf, len, MSG_DONTWAIT, (struct sockaddr *)&dst, sizeof(dst));
+}
+
+static void flush_nacks(ReceiverEngine *eng) {
+    if (!eng->nack_count) return;
+    guint8 buf[12 + RTCP_NACK_MAX_BLOCKS * RTCP_NACK_FCI_SIZE];
+    send_feedback(eng, buf, rtcp_build_block_nack(eng->ssrc, eng->loss.media_ssrc, eng->nacks,
+                                                  eng->nack_count, buf, sizeof(buf)));
+    eng->nack_messages++;
+    eng->nack_count = 0;
+}
+
+// Birleştiriciden (ağ iş parçacığı): NACK'ler biriktirilir, kayıp blok PLI ister.
+// Bir PLI yanıt beklerken sonraki kayıplar yeni PLI üretmez; IDR gelmezse yinelenir.
+static void on_repair_request(void *user, FecRepairKind kind, uint32_t block_id,
+                              uint64_t missing) {
+    ReceiverEngine *eng = user;
+    if (kind == FEC_REPAIR_NACK) {
+        eng->nacks[eng->nack_count].block_id = block_id;
+        eng->nacks[eng->nack_count].missing = missing;
+        if (++eng->nack_count == RTCP_NACK_MAX_BLOCKS) flush_nacks(eng);
+        return;
+    }
+    if (!eng->send_pli) return;
+    gint64 now = g_get_monotonic_time();
+    if (eng->pli_pending_us && now - eng->last_pli_us < PLI_RETRY_US) return;
+    guint8 pli[RTCP_PLI_SIZE];
+    send_feedback(eng, pli, rtcp_build_pli(eng->ssrc, eng->loss.media_ssrc, pli, sizeof(pli)));
+    eng->plis_sent++;
+    eng->last_pli_us = now;
+    if (!eng->pli_pending_us) eng->pli_pending_us = now;
+}
+
+// Rapor aralığı dolduysa göndericinin geri bildirim portuna RR yollar
+static void maybe_send_report(ReceiverEngine *eng) {
+    gint64 now = g_get_monotonic_time();
+    if (!eng->have_sender || now - eng->last_report_us < eng->report_interval_us) return;
+    eng->last_report_us = now;
+
+    guint8 rr[RTCP_RR_SIZE];
+    send_feedback(eng, rr, rtcp_build_receiver_report(&eng->loss, eng->ssrc, rr, sizeof(rr)));
+}
+
+// Kazıma için sayaçların kopyası (ağ iş parçacığı)
+static void publish_stats(ReceiverEngine *eng) {
+    g_mutex_lock(&eng->stats_lock);
+    fec_reassembler_get_stats(eng->ra, &eng->ra_snap);
+    fec_reassembler_get_jitter_stats(eng->ra, &eng->jb_snap);
+    eng->checksum_errors_snap = eng->checksum_errors;
+    g_mutex_unlock(&eng->stats_lock);
+}
+
+static void write_counter(TelWriter *w, const char *name, const char *help, guint64 value) {
+    tel_write_family(w, name, "counter", help);
+    tel_write_value(w, name, NULL, (double)value);
+}
+
+static void write_gauge(TelWriter *w, const char *name, const char *help, double value) {
+    tel_write_family(w, name, "gauge", help);
+    tel_write_value(w, name, NULL, value);
+}
+
+// Telemetri iş parçacığı: yalnızca publish_stats'ın kopyası okunur
+static void collect_receiver_metrics(void *user, TelWriter *w) {
+    ReceiverEngine *eng = user;
+    g_mutex_lock(&eng->stats_lock);
+    FecReassemblerStats st = eng->ra_snap;
+    FecJitterStats js = eng->jb_snap;
+    guint64 checksum_errors = eng->checksum_errors_snap;
+    g_mutex_unlock(&eng->stats_lock);
+
+    tel_write_family(w, "nova_receiver_blocks_total", "counter", "FEC blocks by outcome");
+    tel_write_value(w, "nova_receiver_blocks_total", "state=\"intact\"", (double)st.blocks_intact);
+    tel_write_value(w, "nova_receiver_blocks_total", "state=\"recovered\"", (double)st.blocks_recovered);
+    tel_write_value(w, "nova_receiver_blocks_total", "state=\"repaired\"", (double)st.blocks_repaired);
+    tel_write_value(w, "nova_receiver_blocks_total", "state=\"lost\"", (double)st.blocks_lost);
+    tel_write_family(w, "nova_receiver_frames_total", "counter", "Access units by outcome");
+    tel_write_value(w, "nova_receiver_frames_total", "state=\"out\"", (double)st.frames_out);
+    tel_write_value(w, "nova_receiver_frames_total", "state=\"dropped\"", (double)st.frames_dropped);
+    tel_write_family(w, "nova_receiver_packets_total", "counter", "Shard packets by outcome");
+    tel_write_value(w, "nova_receiver_packets_total", "state=\"accepted\"", (double)st.packets);
+    tel_write_value(w, "nova_receiver_packets_total", "state=\"duplicate\"", (double)st.duplicates);
+    tel_write_value(w, "nova_receiver_packets_total", "state=\"late\"", (double)st.late);
+    tel_write_value(w, "nova_receiver_packets_total", "state=\"checksum\"", (double)checksum_errors);
+    if (!eng->jitter_buffer) return;
+    write_gauge(w, "nova_receiver_jitter_seconds", "RFC 3550 interarrival jitter", js.jitter_us / 1e6);
+    write_gauge(w, "nova_receiver_block_spread_seconds",
+                "First to k-th shard arrival time of a block (mean + 4 deviations)", js.spread_us / 1e6);
+    write_gauge(w, "nova_receiver_block_wait_seconds",
+                "Current wait for an incomplete block after its first shard", js.wait_us / 1e6);
+    write_counter(w, "nova_receiver_blocks_expired_total", "Blocks given up at their deadline",
+                  js.blocks_expired);
+    write_counter(w, "nova_receiver_shards_after_deadline_total",
+                  "Expired blocks that received a shard later (wait was too short)",
+                  js.shards_after_deadline);
+    tel_write_family(w, "nova_receiver_hold_seconds_total", "counter",
+                     "Time complete blocks waited for an earlier incomplete block");
+    tel_write_value(w, "nova_receiver_hold_seconds_total", NULL, js.hold_us_total / 1e6);
+    write_gauge(w, "nova_receiver_hold_max_seconds", "Longest head-of-line wait of a complete block",
+                js.hold_max_us / 1e6);
+}
+
+// Simulcast göndericisi katman değiştirince yeni SSRC kendi blok dizisiyle gelir; geçiş
+// yeni katmanın IDR'ında birleştiricide yapılır. Eski katmanın NACK'leri artık yanıtlanmaz.
+// Yeniden başlayan göndericinin yeni SSRC'si başlangıç bloğu olmadan sürerse ona PLI gider.
+static int accept_media_ssrc(ReceiverEngine *eng, const RtpFecHeader *h,
+                             const struct sockaddr_in *from) {
+    int rc = fec_reassembler_accept_ssrc(eng->ra, h);
+    if (rc == FEC_SSRC_SWITCHED) eng->nack_count = 0;
+    if (rc == FEC_SSRC_ORPHAN && eng->send_pli) {
+        // Geri bildirim o SSRC'nin adresine gider; kapı isteği zaten seyreltir
+        eng->sender_addr = *from;
+        eng->have_sender = 1;
+        guint8 pli[RTCP_PLI_SIZE];
+        send_feedback(eng, pli, rtcp_build_pli(eng->ssrc, h->ssrc, pli, sizeof(pli)));
+        eng->plis_sent++;
+    }
+    return rc == FEC_SSRC_ACCEPT || rc == FEC_SSRC_SWITCHED;
+}
+
+// Jitter tamponu: sıradaki eksik bloğun son tarihine kadar bekler.
+// @return 1 -> okunacak datagram var, 0 -> zaman aşımı, -1 -> hata
+static int wait_readable(ReceiverEngine *eng) {
+    gint64 now = g_get_monotonic_time();
+    gint64 deadline = fec_reassembler_next_deadline(eng->ra);
+    gint64 wait = deadline < 0 ? IDLE_WAKE_US : MAX(deadline - now, 0);
+    if (wait > IDLE_WAKE_US) wait = IDLE_WAKE_US;
+    struct pollfd pfd = { .fd = eng->fd, .events = POLLIN };
+    struct timespec ts = { .tv_sec = wait / G_USEC_PER_SEC, .tv_nsec = (wait % G_USEC_PER_SEC) * 1000 };
+    int rc = ppoll(&pfd, 1, &ts, NULL);
+    if (rc < 0 && errno == EINTR) return 0;
+    return rc < 0 ? -1 : rc > 0;
+}
+
+// Ağ iş parçacığı: datagramları toplu okur, FEC bloklarına dağıtır
+static gpointer receive_thread(gpointer data) {
+    ReceiverEngine *eng = data;
+    static unsigned char bufs[RECV_BATCH][RECV_MAX_DATAGRAM];
+    struct mmsghdr msgs[RECV_BATCH];
+    struct iovec iov[RECV_BATCH];
+    struct sockaddr_in from[RECV_BATCH];
+
+    while (g_atomic_int_get(&eng->running)) {
+        memset(msgs, 0, sizeof(msgs));
+        for (int i = 0; i < RECV_BATCH; i++) {
+            iov[i].iov_base = bufs[i];
+            iov[i].iov_len = RECV_MAX_DATAGRAM;
+            msgs[i].msg_hdr.msg_iov = &iov[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+            msgs[i].msg_hdr.msg_name = &from[i];
+            msgs[i].msg_hdr.msg_namelen = sizeof(from[i]);
+        }
+        if (eng->jitter_buffer) {
+            int rc = wait_readable(eng);
+            // Son tarihi geçen bloklar okuma beklemeden bırakılır
+            fec_reassembler_advance(eng->ra, g_get_monotonic_time());
+            if (rc <= 0) {
+                if (rc < 0) {
+                    g_printerr("ppoll failed: %s\n", strerror(errno));
+                    break;
+                }
+                flush_nacks(eng);
+                maybe_send_report(eng);
+                publish_stats(eng);
+                continue;
+            }
+        }
+        int n = recvmmsg(eng->fd, msgs, RECV_BATCH, MSG_WAITFORONE, NULL);
+        // Saat SSRC kapısı için her modda, jitter tamponunda ayrıca son tarihler için ilerler
+        if (n > 0) fec_reassembler_advance(eng->ra, g_get_monotonic_time());
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                maybe_send_report(eng);
+                continue;
+            }
+            g_printerr("recvmmsg failed: %s\n", strerror(errno));
+            break;
+        }
+        for (int i = 0; i < n; i++) {
+            RtpFecPacket pkt;
+            int rc = rtp_fec_parse(bufs[i], msgs[i].msg_len, &pkt);
+            if (rc == RTP_FEC_PARSE_CHECKSUM) eng->checksum_errors++;
+            if (rc == RTP_FEC_PARSE_VERSION && !eng->version_errors++)
+                g_printerr("Dropping FEC packets with wire version %u (expected %d); "
+                           "sender and receiver builds differ\n",
+                           bufs[i][RTP_HEADER_SIZE + 10], RTP_FEC_WIRE_VERSION);
+            if (rc < 0 || !accept_media_ssrc(eng, &pkt.hdr, &from[i])) continue;
+            // Yeniden gönderimler sıra numarası taşımaz; kayıp oranı ilk gönderimden ölçülür
+            if (!(pkt.hdr.flags & RTP_FEC_FLAG_RETRANSMIT))
+                rtcp_loss_tracker_update(&eng->loss, pkt.hdr.ssrc, pkt.hdr.seq);
+            eng->sender_addr = from[i];
+            eng->have_sender = 1;
+            fec_reassembler_push(eng->ra, &pkt);
+        }
+        flush_nacks(eng);
+        maybe_send_report(eng);
+        publish_stats(eng);
+    }
+    return NULL;
+}
+
+static int open_udp_socket(const char *bind_addr, int port) {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) return -1;
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, bind_addr, &addr.sin_addr) != 1 ||
+        bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+
+    // IDR patlamaları için alım tamponu; kapanışta döngünün uyanması için zaman aşımı
+    int rcvbuf = 8 * 1024 * 1024;
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    struct timeval tv = { .tv_sec = 0, .tv_usec = 100000 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    return fd;
+}
+
+int main(int argc, char **argv)
+{
+    gchar *bind_addr = NULL;
+    gint port = 5004;
+    gint window = 64;
+    gint reorder = 4;
+    gint feedback_port = 0;
+    gint report_ms = 250;
+    gboolean headless = FALSE;
+    gboolean measure_latency = FALSE;
+    gboolean slices = FALSE;
+    gint duration = 0;
+    gboolean nack = FALSE;
+    gint nack_after = 1;
+    gboolean no_pli = FALSE;
+    gboolean jitter_buffer = FALSE;
+    gint jitter_min_ms = 2;
+    gint jitter_max_ms = 100;
+    gint metrics_port = 0;
+    GOptionEntry entries[] = {
+        { "bind", 'b', 0, G_OPTION_ARG_STRING, &bind_addr,
+          "Local address to listen on (default 0.0.0.0)", "ADDR" },
+        { "port", 'p', 0, G_OPTION_ARG_INT, &port,
+          "UDP port (default 5004)", "PORT" },
+        { "window", 0, 0, G_OPTION_ARG_INT, &window,
+          "FEC blocks kept open at once (default 64)", "BLOCKS" },
+        { "reorder", 0, 0, G_OPTION_ARG_INT, &reorder,
+          "Give up on an incomplete block this many blocks behind the newest (default 4)", "BLOCKS" },
+        { "feedback-port", 0, 0, G_OPTION_ARG_INT, &feedback_port,
+          "Sender port for RTCP loss reports (default port + 1)", "PORT" },
+        { "report-ms", 0, 0, G_OPTION_ARG_INT, &report_ms,
+          "Interval between loss reports in milliseconds (default 250)", "MS" },
+        { "nack", 0, 0, G_OPTION_ARG_NONE, &nack,
+          "Ask the sender to resend missing shards (sender --nack-history)", NULL },
+        { "nack-after", 0, 0, G_OPTION_ARG_INT, &nack_after,
+          "NACK an incomplete block this many blocks behind the newest (default 1, below --reorder)",
+          "BLOCKS" },
+        { "jitter-buffer", 0, 0, G_OPTION_ARG_NONE, &jitter_buffer,
+          "Give up on an incomplete block at an adaptive per-block deadline instead of --reorder", NULL },
+        { "jitter-min-ms", 0, 0, G_OPTION_ARG_INT, &jitter_min_ms,
+          "Shortest wait for an incomplete block (default 2)", "MS" },
+        { "jitter-max-ms", 0, 0, G_OPTION_ARG_INT, &jitter_max_ms,
+          "Longest wait for an incomplete block (default 100)", "MS" },
+        { "metrics-port", 0, 0, G_OPTION_ARG_INT, &metrics_port,
+          "Serve Prometheus metrics on 127.0.0.1:PORT/metrics (default 0, off)", "PORT" },
+        { "no-pli", 0, 0, G_OPTION_ARG_NONE, &no_pli,
+          "Do not request a keyframe when a block cannot be recovered", NULL },
+        { "headless", 0, 0, G_OPTION_ARG_NONE, &headless,
+          "Decode without a window (fakesink)", NULL },
+        { "latency", 0, 0, G_OPTION_ARG_NONE, &measure_latency,
+          "Measure capture-to-reassembly latency (sender on the same host)", NULL },
+        { "slices", 0, 0, G_OPTION_ARG_NONE, &slices,
+          "Feed slice groups to the decoder before the frame is complete (sender --slice-mode)", NULL },
+        { "duration", 0, 0, G_OPTION_ARG_INT, &duration,
+          "Stop after this many seconds (default 0, run until interrupted)", "SEC" },
+        G_OPTION_ENTRY_NULL
+    };
+    GError *opt_err = NULL;
+    GOptionContext *opt_ctx = g_option_context_new("- FEC receiver");
+    g_option_context_add_main_entries(opt_ctx, entries, NULL);
+    g_option_context_add_group(opt_ctx, gst_init_get_option_group());
+    if (!g_option_context_parse(opt_ctx, &argc, &argv, &opt_err)) {
+        g_printerr("Option parsing failed: %s\n", opt_err->message);
+        g_clear_error(&opt_err);
+        g_option_context_free(opt_ctx);
+        return 1;
+    }
+    g_option_context_free(opt_ctx);
+
+    gst_init(&argc, &argv);
+    GMainLoop *loop = g_main_loop_new(NULL, FALSE);
+
+    // Gönderici ile aynı GPU seçimi: H.264 decode, postproc ve sink
+    const char *dec_name  = gpu_detect_and_find_factory("decoder");
+    const char *post_name = gpu_detect_and_find_factory("postproc");
+    const char *sink_name = gpu_detect_and_find_factory("sink");
+
+    GstElement *pipeline = gst_pipeline_new("ReceiverEngine");
+    GstElement *appsrc   = gst_element_factory_make("appsrc", "fec_input");
+    GstElement *parse    = gst_element_factory_make("h264parse", "parse");
+    GstElement *dec      = NULL;
+    GstElement *post     = NULL;
+    GstElement *sink     = NULL;
+
+    if (!pipeline || !appsrc || !parse) {
+        g_printerr("Failed to create base elements\n");
+        return 1;
+    }
+
+    if (dec_name) dec = gst_element_factory_make(dec_name, "gpu_dec");
+    if (!dec)     dec = gst_element_factory_make("avdec_h264", "cpu_dec");
+    if (!dec)   { g_printerr("Failed to create H.264 decoder\n"); return 1; }
+
+    if (post_name) post = gst_element_factory_make(post_name, "gpu_post");
+
+    if (headless) {
+        sink = gst_element_factory_make("fakesink", "null_sink");
+    } else {
+        if (sink_name) sink = gst_element_factory_make(sink_name, "gpu_sink");
+        if (!sink)     sink = gst_element_factory_make("autovideosink", "cpu_sink");
+    }
+    if (!sink)   { g_printerr("Failed to create sink\n"); return 1; }
+    g_object_set(sink, "sync", FALSE, NULL);
+
+    // appsrc: AU hizalı (--slices ile NAL hizalı) byte-stream H.264, canlı kaynak
+    GstCaps *h264_caps = gst_caps_from_string(slices
+        ? "video/x-h264,stream-format=byte-stream,alignment=nal"
+        : "video/x-h264,stream-format=byte-stream,alignment=au");
+    g_object_set(appsrc, "caps", h264_caps, "is-live", TRUE, "do-timestamp", TRUE,
+                 "format", GST_FORMAT_TIME, NULL);
+    gst_caps_unref(h264_caps);
+
+    gboolean linked;
+    if (post) {
+        gst_bin_add_many(GST_BIN(pipeline), appsrc, parse, dec, post, sink, NULL);
+        linked = gst_element_link_many(appsrc, parse, dec, post, sink, NULL);
+    } else {
+        gst_bin_add_many(GST_BIN(pipeline), appsrc, parse, dec, sink, NULL);
+        linked = gst_element_link_many(appsrc, parse, dec, sink, NULL);
+    }
+    if (!linked) { g_printerr("Failed to link receiver pipeline\n"); return 1; }
+
+    ReceiverEngine eng = { 0 };
+    eng.appsrc = appsrc;
+    eng.measure_latency = measure_latency;
+    if (measure_latency) eng.latency_hist = g_new0(guint32, LATENCY_BINS);
+    GstPad *sink_pad = gst_element_get_static_pad(sink, "sink");
+    if (sink_pad) {
+        gst_pad_add_probe(sink_pad, GST_PAD_PROBE_TYPE_BUFFER, on_decoded_frame, &eng, NULL);
+        gst_object_unref(sink_pad);
+    }
+    eng.fd = open_udp_socket(bind_addr ? bind_addr : "0.0.0.0", port);
+    if (eng.fd < 0) {
+        g_printerr("Failed to bind UDP port %d\n", port);
+        return 1;
+    }
+    rtcp_loss_tracker_init(&eng.loss);
+    eng.ssrc = g_random_int();
+    eng.feedback_port = feedback_port > 0 ? feedback_port : port + 1;
+    eng.report_interval_us = (gint64)MAX(report_ms, 10) * 1000;
+    eng.ra = fec_reassembler_new(window, reorder, on_frame_reassembled, &eng);
+    if (!eng.ra) { g_printerr("Failed to create FEC reassembler\n"); return 1; }
+    if (slices) fec_reassembler_set_slice_callback(eng.ra, on_slice_reassembled);
+    if (jitter_buffer) {
+        FecJitterConfig jb = { .min_wait_us = (guint32)MAX(jitter_min_ms, 0) * 1000,
+                               .max_wait_us = (guint32)MAX(jitter_max_ms, 1) * 1000 };
+        fec_reassembler_set_jitter_buffer(eng.ra, &jb);
+        eng.jitter_buffer = 1;
+    }
+    g_mutex_init(&eng.stats_lock);
+    Telemetry *telemetry = NULL;
+    if (metrics_port > 0) {
+        telemetry = telemetry_new();
+        if (!telemetry || telemetry_add_collector(telemetry, collect_receiver_metrics, &eng) < 0 ||
+            telemetry_serve(telemetry, metrics_port) < 0) {
+            g_printerr("Failed to listen for metrics on 127.0.0.1:%d\n", metrics_port);
+            return 1;
+        }
+    }
+    eng.send_pli = !no_pli;
+    if (nack || !no_pli)
+        fec_reassembler_set_repair_callback(eng.ra, nack ? (unsigned int)MAX(nack_after, 1) : 0,
+                                            on_repair_request);
+
+    GstBus *bus = gst_element_get_bus(pipeline);
+    gst_bus_add_watch(bus, bus_call, loop);
+    gst_object_unref(bus);
+    if (duration > 0) g_timeout_add_seconds(duration, on_duration_elapsed, loop);
+
+    gst_element_set_state(pipeline, GST_STATE_PLAYING);
+    g_atomic_int_set(&eng.running, 1);
+    GThread *net = g_thread_new("fec-recv", receive_thread, &eng);
+
+    g_print("Listening for RTP/FEC on %s:%d...\n", bind_addr ? bind_addr : "0.0.0.0", port);
+    g_print(" > Loss reports every %d ms to sender port %d\n", report_ms, eng.feedback_port);
+    if (!no_pli || nack)
+        g_print(" > Feedback: %s%s%s\n", no_pli ? "" : "PLI on unrecoverable blocks",
+                !no_pli && nack ? ", " : "", nack ? "NACK for incomplete blocks" : "");
+    if (slices) g_print(" > Slice groups fed to the decoder as they are recovered\n");
+    if (jitter_buffer)
+        g_print(" > Jitter buffer: per-block deadline between %d and %d ms\n",
+                MAX(jitter_min_ms, 0), MAX(jitter_max_ms, 1));
+    if (metrics_port > 0) g_print(" > Metrics: http://127.0.0.1:%d/metrics\n", metrics_port);
+    g_print(" > Decode on: %s\n", dec_name ? dec_name : "avdec_h264 (CPU fallback)");
+    g_print(" > Selected postproc: %s\n", post_name ? post_name : "none");
+    g_print(" > Selected sink: %s\n", sink_name ? sink_name : "autovideosink (fallback)");
+    g_main_loop_run(loop);
+
+    g_atomic_int_set(&eng.running, 0);
+    g_thread_join(net);
+    // Kazıma ağ iş parçacığının kopyasını okur; birleştirici bundan sonra bu iş parçacığında
+    telemetry_free(telemetry);
+    // Akış sonunda kalan bloklar için gönderici artık dinlemiyor olabilir
+    fec_reassembler_set_repair_callback(eng.ra, 0, NULL);
+    fec_reassembler_flush(eng.ra);
+
+    FecReassemblerStats st;
+    FecDecoderStats ds;
+    fec_reassembler_get_stats(eng.ra, &st);
+    fec_reassembler_get_decoder_stats(eng.ra, &ds);
+    g_print(" > Blocks: %llu intact, %llu recovered, %llu repaired by resend, %llu lost\n",
+            (unsigned long long)st.blocks_intact, (unsigned long long)st.blocks_recovered,
+            (unsigned long long)st.blocks_repaired, (unsigned long long)st.blocks_lost);
+    if (st.nacks)
+        g_print(" > NACK: %llu blocks in %llu messages, %llu shards resent\n",
+                (unsigned long long)st.nacks, (unsigned long long)eng.nack_messages,
+                (unsigned long long)st.retransmits);
+    if (eng.plis_sent)
+        g_print(" > PLI: %llu sent, %llu keyframes recovered, avg %.1f ms, max %.1f ms\n",
+                (unsigned long long)eng.plis_sent, (unsigned long long)eng.recoveries,
+                eng.recoveries ? eng.recovery_sum_us / 1000.0 / eng.recoveries : 0.0,
+                eng.recovery_max_us / 1000.0);
+    g_print(" > Frames: %llu out, %llu dropped; decode patterns %llu cached / %llu built\n",
+            (unsigned long long)st.frames_out, (unsigned long long)st.frames_dropped,
+            ds.cache_hits, ds.cache_misses);
+    if (slices)
+        g_print(" > Slices: %llu delivered early, %llu dropped\n",
+                (unsigned long long)st.slices_out, (unsigned long long)st.slices_dropped);
+    if (jitter_buffer) {
+        FecJitterStats js;
+        fec_reassembler_get_jitter_stats(eng.ra, &js);
+        g_print(" > Jitter buffer: wait %.1f ms (jitter %.1f ms, block spread %.1f ms), "
+                "%llu blocks expired, %llu too early, head-of-line hold %.1f ms max\n",
+                js.wait_us / 1000.0, js.jitter_us / 1000.0, js.spread_us / 1000.0,
+                (unsigned long long)js.blocks_expired, (unsigned long long)js.shards_after_deadline,
+                js.hold_max_us / 1000.0);
+    }
+    if (st.layer_switches || st.stale_packets)
+        g_print(" > Simulcast: %llu layer switches, %llu packets outside the active layer dropped, "
+                "%llu keyframe requests to a new SSRC\n",
+                (unsigned long long)st.layer_switches, (unsigned long long)st.stale_packets,
+                (unsigned long long)st.orphan_requests);
+    if (st.resyncs)
+        g_print(" > Resync: block numbering jumped %llu times (sender restart?)\n",
+                (unsigned long long)st.resyncs);
+    if (eng.version_errors)
+        g_print(" > Wire version mismatch: %llu packets dropped\n",
+                (unsigned long long)eng.version_errors);
+    if (eng.checksum_errors)
+        g_print(" > Checksum failures: %llu shards discarded as erasures\n",
+                (unsigned long long)eng.checksum_errors);
+
+    g_print("Stopping receiver pipeline.\n");
+    gst_app_src_end_of_stream(GST_APP_SRC(appsrc));
+    gst_element_set_state(pipeline, GST_STATE_NULL);
+
+    // Tek satırlık, makinece okunur özet (tests/e2e_harness bunu ayrıştırır)
+    double span = (eng.last_frame_us - eng.first_frame_us) / 1e6;
+    double fps = eng.frames_decoded > 1 && span > 0 ? (eng.frames_decoded - 1) / span : 0.0;
+    if (measure_latency && eng.latency_samples) {
+        g_print("stats: frames=%llu fps=%.2f latency_avg_ms=%.3f latency_p50_ms=%.3f latency_p99_ms=%.3f\n",
+                (unsigned long long)eng.frames_decoded, fps,
+                eng.latency_sum_us / 1000.0 / eng.latency_samples,
+                latency_percentile_ms(&eng, 0.50), latency_percentile_ms(&eng, 0.99));
+    } else {
+        g_print("stats: frames=%llu fps=%.2f\n", (unsigned long long)eng.frames_decoded, fps);
+    }
+    gst_object_unref(pipeline);
+    g_main_loop_unref(loop);
+    fec_reassembler_free(eng.ra);
+    g_mutex_clear(&eng.stats_lock);
+    g_free(eng.latency_hist);
+    close(eng.fd);
+    g_free(bind_addr);
+    fec_codec_shutdown();
+    return 0;
+}
@@ -0,0 +1,159 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "rtcp_feedback.h"
+
+#define RTP_SEQ_MOD      (1u << 16)
+#define MAX_DROPOUT      3000
+#define MAX_MISORDER     100
+
+static void put_be16(uint8_t *p, uint16_t v) { p[0] = v >> 8; p[1] = (uint8_t)v; }
+static void put_be32(uint8_t *p, uint32_t v) {
+    p[0] = v >> 24; p[1] = (uint8_t)(v >> 16); p[2] = (uint8_t)(v >> 8); p[3] = (uint8_t)v;
+}
+static uint16_t get_be16(const uint8_t *p) { return (uint16_t)(p[0] << 8 | p[1]); }
+static uint32_t get_be32(const uint8_t *p) {
+    return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+}
+
+void rtcp_loss_tracker_init(RtcpLossTracker *t) {
+    memset(t, 0, sizeof(*t));
+}
+
+static void tracker_restart(RtcpLossTracker *t, uint32_t ssrc, uint16_t seq) {
+    memset(t, 0, sizeof(*t));
+    t->started = 1;
+    t->media_ssrc = ssrc;
+    t->base_seq = seq;
+    t->max_seq = seq;
+    t->received = 1;
+}
+
+void rtcp_loss_tracker_update(RtcpLossTracker *t, uint32_t ssrc, uint16_t seq) {
+    if (!t->started || t->media_ssrc != ssrc) {
+        tracker_restart(t, ssrc, seq);
+        return;
+    }
+
+    uint16_t udelta = (uint16_t)(seq - t->max_seq);
+    if (udelta < MAX_DROPOUT) {
+        // Sıralı (aradaki boşluklar kayıp): 16 bit taşmayı say
+        if (seq < t->max_seq) t->cycles += RTP_SEQ_MOD;
+        t->max_seq = seq;
+    } else if (udelta <= RTP_SEQ_MOD - MAX_MISORDER) {
+        // Büyük sıçrama: gönderici yeniden başlamış, sayaçları sıfırla
+        tracker_restart(t, ssrc, seq);
+        return;
+    }
+    // Aksi halde geç gelen/yinelenen paket: yalnızca alınan sayısına eklenir
+    t->received++;
+}
+
+size_t rtcp_build_receiver_report(RtcpLossTracker *t, uint32_t reporter_ssrc,
+                                  uint8_t *buf, size_t cap) {
+    if (!t->started || cap < RTCP_RR_SIZE) return 0;
+
+    uint32_t ext_max = t->cycles + t->max_seq;
+    uint32_t expected = ext_max - t->base_seq + 1;
+    int64_t lost = (int64_t)expected - t->received;
+    if (lost > 0x7fffff) lost = 0x7fffff;
+    if (lost < -0x800000) lost = -0x800000;
+
+    uint32_t expected_interval = expected - t->expected_prior;
+    uint32_t received_interval = t->received - t->received_prior;
+    int64_t lost_interval = (int64_t)expected_interval - received_interval;
+    uint8_t fraction = 0;
+    if (expected_interval > 0 && lost_interval > 0)
+        fraction = (uint8_t)((lost_interval << 8) / expected_interval > 255
+                             ? 255 : (lost_interval << 8) / expected_interval);
+    t->expected_prior = expected;
+    t->received_prior = t->received;
+
+    // Başlık: V=2, P=0, RC=1 | PT=RR | uzunluk (32 bit kelime - 1)
+    buf[0] = (2 << 6) | 1;
+    buf[1] = RTCP_PT_RR;
+    put_be16(buf + 2, RTCP_RR_SIZE / 4 - 1);
+    put_be32(buf + 4, reporter_ssrc);
+
+    uint8_t *rb = buf + 8;
+    put_be32(rb, t->media_ssrc);
+    put_be32(rb + 4, (uint32_t)fraction << 24 | ((uint32_t)lost & 0xffffff));
+    put_be32(rb + 8, ext_max);
+    put_be32(rb + 12, 0);   // jitter: FEC alıcısı blok düzeyinde ölçer
+    put_be32(rb + 16, 0);   // LSR: gönderici SR yollamıyor
+    put_be32(rb + 20, 0);   // DLSR
+    return RTCP_RR_SIZE;
+}
+
+/* RFC 4585 ortak geri bildirim başlığı: V=2 | FMT | PT | uzunluk | gönderen | medya SSRC */
+static void write_fb_header(uint8_t *buf, int fmt, int pt, size_t len,
+                            uint32_t reporter_ssrc, uint32_t media_ssrc) {
+    buf[0] = (uint8_t)((2 << 6) | fmt);
+    buf[1] = (uint8_t)pt;
+    put_be16(buf + 2, (uint16_t)(len / 4 - 1));
+    put_be32(buf + 4, reporter_ssrc);
+    put_be32(buf + 8, media_ssrc);
+}
+
+size_t rtcp_build_pli(uint32_t reporter_ssrc, uint32_t media_ssrc, uint8_t *buf, size_t cap) {
+    if (cap < RTCP_PLI_SIZE) return 0;
+    write_fb_header(buf, RTCP_FMT_PLI, RTCP_PT_PSFB, RTCP_PLI_SIZE, reporter_ssrc, media_ssrc);
+    return RTCP_PLI_SIZE;
+}
+
+size_t rtcp_build_block_nack(uint32_t reporter_ssrc, uint32_t media_ssrc,
+                             const RtcpBlockNack *nacks, int count, uint8_t *buf, size_t cap) {
+    if (count > RTCP_NACK_MAX_BLOCKS) count = RTCP_NACK_MAX_BLOCKS;
+    size_t len = 12 + (size_t)count * RTCP_NACK_FCI_SIZE;
+    if (count < 1 || cap < len) return 0;
+    write_fb_header(buf, RTCP_FMT_BLOCK_NACK, RTCP_PT_RTPFB, len, reporter_ssrc, media_ssrc);
+    for (int i = 0; i < count; i++) {
+        uint8_t *fci = buf + 12 + (size_t)i * RTCP_NACK_FCI_SIZE;
+        put_be32(fci, nacks[i].block_id);
+        put_be32(fci + 4, (uint32_t)(nacks[i].missing >> 32));
+        put_be32(fci + 8, (uint32_t)nacks[i].missing);
+    }
+    return len;
+}
+
+int rtcp_parse_feedback(const uint8_t *buf, size_t len, RtcpFeedback *out) {
+    if (len < 8 || (buf[0] >> 6) != 2) return -1;
+    size_t plen = ((size_t)get_be16(buf + 2) + 1) * 4;
+    if (plen > len) return -1;
+
+    memset(out, 0, sizeof(*out));
+    out->type = buf[1];
+    out->reporter_ssrc = get_be32(buf + 4);
+
+    if (out->type == RTCP_PT_RR) {
+        int rc = buf[0] & 0x1f;
+        if (rc < 1 || plen < RTCP_RR_SIZE) return -1;
+        const uint8_t *rb = buf + 8;
+        uint32_t word = get_be32(rb + 4);
+        out->media_ssrc = get_be32(rb);
+        out->fraction_lost = (uint8_t)(word >> 24);
+        out->cumulative_lost = word & 0xffffff;
+        out->highest_seq = get_be32(rb + 8);
+        out->jitter = get_be32(rb + 12);
+        return 0;
+    }
+    if (out->type == RTCP_PT_PSFB || out->type == RTCP_PT_RTPFB) {
+        if (plen < 12) return -1;
+        out->fmt = buf[0] & 0x1f;
+        out->media_ssrc = get_be32(buf + 8);
+        if (out->type == RTCP_PT_PSFB && out->fmt == RTCP_FMT_PLI) return 0;
+        if (out->type == RTCP_PT_RTPFB && out->fmt == RTCP_FMT_BLOCK_NACK) {
+            size_t n = (plen - 12) / RTCP_NACK_FCI_SIZE;
+            if (n < 1) return -1;
+            if (n > RTCP_NACK_MAX_BLOCKS) n = RTCP_NACK_MAX_BLOCKS;
+            for (size_t i = 0; i < n; i++) {
+                const uint8_t *fci = buf + 12 + i * RTCP_NACK_FCI_SIZE;
+                out->nacks[i].block_id = get_be32(fci);
+                out->nacks[i].missing = (uint64_t)get_be32(fci + 4) << 32 | get_be32(fci + 8);
+            }
+            out->nack_count = (int)n;
+            return 0;
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,480 @@
+#define _GNU_SOURCE /* sendmmsg */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <netdb.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <isa-l.h>
+#include "rtp_fec.h"
+
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103     /* linux/udp.h, çekirdek >= 4.18 */
+#endif
+
+/* crc32c'nin başladığı byte ve başlık içindeki yeri */
+#define CRC_SKIP   4
+#define CRC_OFFSET (RTP_HEADER_SIZE + 16)
+
+/* Tek GSO mesajında çekirdeğin kabul ettiği en fazla segment ve byte */
+#define GSO_MAX_SEGMENTS 64
+#define GSO_MAX_BYTES    65000
+
+/* Yeniden gönderim bütçesinin biriktirebileceği süre */
+#define RESEND_BURST_NS 500000000ull
+
+/* Geçmişteki bir bloğun gönderildiği haliyle paketleri */
+typedef struct {
+    int valid;
+    uint32_t block_id;
+    int npkts;
+    int k;
+    size_t pkt_size;
+    uint8_t *buf;                   /* paket i -> buf + i * pkt_size */
+    size_t cap;
+} HistoryBlock;
+
+/* NACK geçmişi; gönderim iş parçacıkları yazar, geri bildirim işleyicisi okur */
+typedef struct {
+    HistoryBlock *slots;
+    unsigned int n;
+    pthread_mutex_t lock;
+    double rate;                    /* byte/ns */
+    double tokens;
+    uint64_t last_refill;
+    RtpFecResendStats stats;
+} History;
+
+struct RtpFecSender {
+    int fd;
+    struct sockaddr_storage dst;
+    socklen_t dst_len;
+    uint32_t ssrc;
+    uint16_t seq;
+    uint32_t next_block_id;
+    int gso;
+
+    /* Bir bloğun tüm başlıkları ve mesaj dizileri (gönderim senkron, tekrar kullanılır) */
+    uint8_t headers[FEC_MAX_TOTAL_SHARDS][RTP_FEC_PACKET_OVERHEAD];
+    struct iovec iov[FEC_MAX_TOTAL_SHARDS * 2];
+    struct mmsghdr msgs[FEC_MAX_TOTAL_SHARDS];
+    char control[FEC_MAX_TOTAL_SHARDS][CMSG_SPACE(sizeof(uint16_t))];
+
+    RtpFecSenderStats stats;
+    History *hist;                  /* NULL -> NACK'ler yanıtsız */
+};
+
+static void put_be16(uint8_t *p, uint16_t v) { p[0] = v >> 8; p[1] = (uint8_t)v; }
+static void put_be32(uint8_t *p, uint32_t v) {
+    p[0] = v >> 24; p[1] = (uint8_t)(v >> 16); p[2] = (uint8_t)(v >> 8); p[3] = (uint8_t)v;
+}
+static uint16_t get_be16(const uint8_t *p) { return (uint16_t)(p[0] << 8 | p[1]); }
+static uint32_t get_be32(const uint8_t *p) {
+    return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+}
+
+void rtp_fec_write_header(uint8_t *buf, const RtpFecHeader *h) {
+    // RTP: V=2, P=0, X=0, CC=0 | M + PT
+    buf[0] = RTP_VERSION << 6;
+    buf[1] = (uint8_t)((h->marker ? 0x80 : 0) | RTP_FEC_PAYLOAD_TYPE);
+    put_be16(buf + 2, h->seq);
+    put_be32(buf + 4, h->timestamp);
+    put_be32(buf + 8, h->ssrc);
+
+    uint8_t *f = buf + RTP_HEADER_SIZE;
+    put_be32(f, h->block_id);
+    f[4] = h->shard_index;
+    f[5] = h->k;
+    f[6] = h->r;
+    f[7] = h->flags;
+    put_be16(f + 8, h->shard_size);
+    f[10] = RTP_FEC_WIRE_VERSION;
+    f[11] = 0;
+    put_be32(f + 12, h->payload_len);
+    put_be32(f + 16, 0);
+}
+
+static uint32_t packet_crc(const uint8_t *hdr, const uint8_t *shard, size_t shard_size) {
+    uint32_t crc = crc32_iscsi((unsigned char *)hdr + CRC_SKIP, CRC_OFFSET - CRC_SKIP, 0xffffffffu);
+    crc = crc32_iscsi((unsigned char *)shard, (int)shard_size, crc);
+    return ~crc;
+}
+
+void rtp_fec_seal(uint8_t *hdr, const uint8_t *shard, size_t shard_size) {
+    put_be32(hdr + CRC_OFFSET, packet_crc(hdr, shard, shard_size));
+}
+
+int rtp_fec_parse(const uint8_t *buf, size_t len, RtpFecPacket *out) {
+    if (len < RTP_FEC_PACKET_OVERHEAD) return RTP_FEC_PARSE_INVALID;
+    if ((buf[0] >> 6) != RTP_VERSION) return RTP_FEC_PARSE_INVALID;
+    if ((buf[1] & 0x7f) != RTP_FEC_PAYLOAD_TYPE) return RTP_FEC_PARSE_INVALID;
+
+    // Alanlar okunmadan önce: bozuk bir k, shard_index ya da boyut güvenilmez
+    const uint8_t *payload = buf + RTP_FEC_PACKET_OVERHEAD;
+    if (packet_crc(buf, payload, len - RTP_FEC_PACKET_OVERHEAD) != get_be32(buf + CRC_OFFSET))
+        return RTP_FEC_PARSE_CHECKSUM;
+
+    RtpFecHeader *h = &out->hdr;
+    h->marker    = (buf[1] & 0x80) != 0;
+    h->seq       = get_be16(buf + 2);
+    h->timestamp = get_be32(buf + 4);
+    h->ssrc      = get_be32(buf + 8);
+
+    const uint8_t *f = buf + RTP_HEADER_SIZE;
+    // Başka bir parity düzeni: shard'lar bu çözücüyle yanlış kurtarılırdı
+    if (f[10] != RTP_FEC_WIRE_VERSION) return RTP_FEC_PARSE_VERSION;
+    h->block_id    = get_be32(f);
+    h->shard_index = f[4];
+    h->k           = f[5];
+    h->r           = f[6];
+    h->flags       = f[7];
+    h->shard_size  = get_be16(f + 8);
+    h->payload_len = get_be32(f + 12);
+
+    if (h->k < 1 || h->k > FEC_MAX_DATA_SHARDS || h->r > FEC_MAX_PARITY_SHARDS)
+        return RTP_FEC_PARSE_INVALID;
+    if (h->shard_index >= h->k + h->r) return RTP_FEC_PARSE_INVALID;
+    if (len - RTP_FEC_PACKET_OVERHEAD != h->shard_size) return RTP_FEC_PARSE_INVALID;
+    if (h->payload_len > (uint32_t)h->k * h->shard_size) return RTP_FEC_PARSE_INVALID;
+
+    out->payload = payload;
+    out->payload_size = h->shard_size;
+    return 0;
+}
+
+int rtp_fec_max_shard_size(int mtu) {
+    int room = mtu - RTP_FEC_IP_UDP_OVERHEAD - RTP_FEC_PACKET_OVERHEAD;
+    return room < SHARD_POOL_ALIGN ? SHARD_POOL_ALIGN : room & ~(SHARD_POOL_ALIGN - 1);
+}
+
+RtpFecSender* rtp_fec_sender_new(const char *host, int port, uint32_t ssrc, int use_gso) {
+    struct addrinfo hints, *res = NULL;
+    char port_str[16];
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+    snprintf(port_str, sizeof(port_str), "%d", port);
+    if (getaddrinfo(host, port_str, &hints, &res) != 0 || !res) return NULL;
+
+    RtpFecSender *s = calloc(1, sizeof(*s));
+    if (!s) {
+        freeaddrinfo(res);
+        return NULL;
+    }
+    s->fd = socket(res->ai_family, SOCK_DGRAM, 0);
+    if (s->fd < 0) {
+        freeaddrinfo(res);
+        free(s);
+        return NULL;
+    }
+    memcpy(&s->dst, res->ai_addr, res->ai_addrlen);
+    s->dst_len = res->ai_addrlen;
+    freeaddrinfo(res);
+
+    s->ssrc = ssrc;
+    s->seq = (uint16_t)(ssrc ^ (ssrc >> 16));
+
+    // Büyük bloklar için gönderim tamponunu büyüt (IDR patlamaları)
+    int sndbuf = 4 * 1024 * 1024;
+    setsockopt(s->fd, SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+
+    // GSO desteği: soket seçeneği kabul ediliyorsa mesaj başına cmsg ile kullanılır
+    if (use_gso) {
+        int probe = 0;
+        s->gso = setsockopt(s->fd, SOL_UDP, UDP_SEGMENT, &probe, sizeof(probe)) == 0;
+    }
+    return s;
+}
+
+void rtp_fec_sender_free(RtpFecSender *s) {
+    if (!s) return;
+    if (s->fd >= 0) close(s->fd);
+    if (s->hist) {
+        for (unsigned int i = 0; i < s->hist->n; i++)
+            free(s->hist->slots[i].buf);
+        free(s->hist->slots);
+        pthread_mutex_destroy(&s->hist->lock);
+        free(s->hist);
+    }
+    free(s);
+}
+
+int rtp_fec_sender_gso_enabled(const RtpFecSender *s) {
+    return s->gso;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+int rtp_fec_sender_enable_history(RtpFecSender *s, unsigned int blocks, unsigned int budget_kbps) {
+    History *h = calloc(1, sizeof(*h));
+    if (!h) return -1;
+    h->n = blocks < 1 ? 1 : blocks;
+    h->slots = calloc(h->n, sizeof(HistoryBlock));
+    if (!h->slots) {
+        free(h);
+        return -1;
+    }
+    pthread_mutex_init(&h->lock, NULL);
+    h->rate = budget_kbps * 1000.0 / 8.0 / 1e9;
+    h->tokens = h->rate * RESEND_BURST_NS;
+    h->last_refill = now_ns();
+    s->hist = h;
+    return 0;
+}
+
+/*
+ * Kilit tutulurken: block_id için geçmiş slotunu (en eski bloğun yerine) hazırlar.
+ * @return paket tamponu, NULL -> bellek yok (blok geçmişe girmez)
+ */
+static uint8_t* history_slot(History *h, uint32_t block_id, int npkts, int k, size_t pkt_size) {
+    HistoryBlock *b = &h->slots[block_id % h->n];
+    size_t need = (size_t)npkts * pkt_size;
+    b->valid = 0;
+    if (need > b->cap) {
+        uint8_t *buf = realloc(b->buf, need);
+        if (!buf) return NULL;
+        b->buf = buf;
+        b->cap = need;
+    }
+    b->valid = 1;
+    b->block_id = block_id;
+    b->npkts = npkts;
+    b->k = k;
+    b->pkt_size = pkt_size;
+    return b->buf;
+}
+
+int rtp_fec_sender_resend(RtpFecSender *s, uint32_t block_id, uint64_t missing) {
+    History *h = s->hist;
+    if (!h) return -1;
+    pthread_mutex_lock(&h->lock);
+    h->stats.requests++;
+    HistoryBlock *b = &h->slots[block_id % h->n];
+    if (!b->valid || b->block_id != block_id) {
+        h->stats.misses++;
+        pthread_mutex_unlock(&h->lock);
+        return 0;
+    }
+
+    uint64_t now = now_ns();
+    h->tokens += (double)(now - h->last_refill) * h->rate;
+    if (h->tokens > h->rate * RESEND_BURST_NS) h->tokens = h->rate * RESEND_BURST_NS;
+    h->last_refill = now;
+
+    int sent = 0;
+    for (int i = 0; i < b->npkts && sent < b->k; i++) {
+        if (!(missing >> i & 1)) continue;
+        if (h->tokens < (double)b->pkt_size) {
+            h->stats.throttled++;
+            continue;
+        }
+        // İşaret bir kez konur; aynı shard'ın sonraki yeniden gönderimleri de onu taşır
+        uint8_t *pkt = b->buf + (size_t)i * b->pkt_size;
+        uint8_t *flags = pkt + RTP_HEADER_SIZE + 7;
+        if (!(*flags & RTP_FEC_FLAG_RETRANSMIT)) {
+            *flags |= RTP_FEC_FLAG_RETRANSMIT;
+            rtp_fec_seal(pkt, pkt + RTP_FEC_PACKET_OVERHEAD, b->pkt_size - RTP_FEC_PACKET_OVERHEAD);
+        }
+        if (sendto(s->fd, pkt, b->pkt_size, MSG_DONTWAIT,
+                   (struct sockaddr *)&s->dst, s->dst_len) < 0)
+            break;
+        h->tokens -= (double)b->pkt_size;
+        h->stats.packets++;
+        h->stats.bytes += b->pkt_size;
+        sent++;
+    }
+    pthread_mutex_unlock(&h->lock);
+    return sent;
+}
+
+void rtp_fec_sender_get_resend_stats(RtpFecSender *s, RtpFecResendStats *out) {
+    if (!s->hist) {
+        memset(out, 0, sizeof(*out));
+        return;
+    }
+    pthread_mutex_lock(&s->hist->lock);
+    *out = s->hist->stats;
+    pthread_mutex_unlock(&s->hist->lock);
+}
+
+/* msgs[0..count-1] gönderilene kadar sendmmsg çağırır */
+static int send_all(RtpFecSender *s, struct mmsghdr *msgs, unsigned int count) {
+    unsigned int done = 0;
+    while (done < count) {
+        int n = sendmmsg(s->fd, msgs + done, count - done, 0);
+        s->stats.syscalls++;
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        done += (unsigned int)n;
+    }
+    return 0;
+}
+
+/* Bloğun i. shard paketinin başlığı; END bloğunun son shard'ı RTP marker taşır */
+static void block_header(const RtpFecSender *s, const FecBlock *blk, int i, uint32_t block_id,
+                         uint32_t rtp_timestamp, uint8_t flags, uint16_t seq, uint8_t *out) {
+    RtpFecHeader h = {
+        .seq = seq,
+        .timestamp = rtp_timestamp,
+        .ssrc = s->ssrc,
+        .marker = (flags & RTP_FEC_FLAG_END_OF_FRAME) && i == blk->k + blk->r - 1,
+        .block_id = block_id,
+        .shard_index = (uint8_t)i,
+        .k = (uint8_t)blk->k,
+        .r = (uint8_t)blk->r,
+        .flags = flags,
+        .shard_size = (uint16_t)blk->shard_size,
+        .payload_len = (uint32_t)blk->payload_len,
+    };
+    rtp_fec_write_header(out, &h);
+}
+
+int rtp_fec_sender_send_block(RtpFecSender *s, const FecBlock *blk,
+                              uint32_t rtp_timestamp, uint8_t flags) {
+    int total = blk->k + blk->r;
+    uint32_t block_id = s->next_block_id++;
+    size_t pkt_size = RTP_FEC_PACKET_OVERHEAD + (size_t)blk->shard_size;
+
+    // Başlıkları yaz; her paket = [başlık][shard] iki iovec
+    for (int i = 0; i < total; i++) {
+        block_header(s, blk, i, block_id, rtp_timestamp, flags, s->seq++, s->headers[i]);
+        rtp_fec_seal(s->headers[i], blk->shards[i], (size_t)blk->shard_size);
+        s->iov[2 * i].iov_base = s->headers[i];
+        s->iov[2 * i].iov_len = RTP_FEC_PACKET_OVERHEAD;
+        s->iov[2 * i + 1].iov_base = blk->shards[i];
+        s->iov[2 * i + 1].iov_len = blk->shard_size;
+    }
+    if (s->hist) {
+        pthread_mutex_lock(&s->hist->lock);
+        uint8_t *out = history_slot(s->hist, block_id, total, blk->k, pkt_size);
+        for (int i = 0; out && i < total; i++) {
+            memcpy(out + (size_t)i * pkt_size, s->headers[i], RTP_FEC_PACKET_OVERHEAD);
+            memcpy(out + (size_t)i * pkt_size + RTP_FEC_PACKET_OVERHEAD, blk->shards[i],
+                   blk->shard_size);
+        }
+        pthread_mutex_unlock(&s->hist->lock);
+    }
+
+    unsigned int nmsgs = 0;
+    memset(s->msgs, 0, sizeof(struct mmsghdr) * total);
+
+    if (s->gso) {
+        // Tüm shard'lar eşit boyutta: çekirdek tek mesajı pkt_size'lık datagramlara böler
+        int per_msg = GSO_MAX_BYTES / (int)pkt_size;
+        if (per_msg > GSO_MAX_SEGMENTS) per_msg = GSO_MAX_SEGMENTS;
+        if (per_msg < 1) per_msg = 1;
+        for (int i = 0; i < total; i += per_msg) {
+            int segs = total - i < per_msg ? total - i : per_msg;
+            struct msghdr *mh = &s->msgs[nmsgs].msg_hdr;
+            mh->msg_name = &s->dst;
+            mh->msg_namelen = s->dst_len;
+            mh->msg_iov = &s->iov[2 * i];
+            mh->msg_iovlen = 2 * segs;
+            if (segs > 1) {
+                mh->msg_control = s->control[nmsgs];
+                mh->msg_controllen = CMSG_SPACE(sizeof(uint16_t));
+                struct cmsghdr *cm = CMSG_FIRSTHDR(mh);
+                cm->cmsg_level = SOL_UDP;
+                cm->cmsg_type = UDP_SEGMENT;
+                cm->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+                uint16_t gso_size = (uint16_t)pkt_size;
+                memcpy(CMSG_DATA(cm), &gso_size, sizeof(gso_size));
+            }
+            nmsgs++;
+        }
+        if (send_all(s, s->msgs, nmsgs) == 0) {
+            s->stats.gso_sends += nmsgs;
+            goto sent;
+        }
+        // Çıkış arayüzü GSO'yu reddetti (örn. EIO): kalıcı olarak sendmmsg'ye dön.
+        // Kısmen gönderilmiş shard'lar tekrar gider; alıcı kopyaları yok sayar.
+        s->gso = 0;
+        nmsgs = 0;
+        memset(s->msgs, 0, sizeof(struct mmsghdr) * total);
+    }
+
+    for (int i = 0; i < total; i++) {
+        struct msghdr *mh = &s->msgs[nmsgs++].msg_hdr;
+        mh->msg_name = &s->dst;
+        mh->msg_namelen = s->dst_len;
+        mh->msg_iov = &s->iov[2 * i];
+        mh->msg_iovlen = 2;
+    }
+    if (send_all(s, s->msgs, nmsgs) < 0) {
+        s->stats.errors++;
+        return -1;
+    }
+
+sent:
+    s->stats.packets += total;
+    s->stats.bytes += (uint64_t)total * pkt_size;
+    s->stats.blocks++;
+    return 0;
+}
+
+int rtp_fec_sender_pack_block(RtpFecSender *s, const FecBlock *blk, uint32_t rtp_timestamp,
+                              uint8_t flags, uint8_t *out, size_t stride) {
+    int total = blk->k + blk->r;
+    uint32_t block_id = s->next_block_id++;
+    for (int i = 0; i < total; i++) {
+        uint8_t *pkt = out + (size_t)i * stride;
+        block_header(s, blk, i, block_id, rtp_timestamp, flags, 0, pkt);
+        memcpy(pkt + RTP_FEC_PACKET_OVERHEAD, blk->shards[i], blk->shard_size);
+        rtp_fec_seal(pkt, pkt + RTP_FEC_PACKET_OVERHEAD, (size_t)blk->shard_size);
+    }
+    if (s->hist) {
+        size_t pkt_size = RTP_FEC_PACKET_OVERHEAD + (size_t)blk->shard_size;
+        pthread_mutex_lock(&s->hist->lock);
+        uint8_t *hist = history_slot(s->hist, block_id, total, blk->k, pkt_size);
+        for (int i = 0; hist && i < total; i++)
+            memcpy(hist + (size_t)i * pkt_size, out + (size_t)i * stride, pkt_size);
+        pthread_mutex_unlock(&s->hist->lock);
+    }
+    s->stats.blocks++;
+    return total;
+}
+
+int rtp_fec_sender_send_packets(RtpFecSender *s, uint8_t *const *pkts, const size_t *lens,
+                                int count) {
+    if (count > FEC_MAX_TOTAL_SHARDS) count = FEC_MAX_TOTAL_SHARDS;
+    memset(s->msgs, 0, sizeof(struct mmsghdr) * count);
+    uint64_t bytes = 0;
+    for (int i = 0; i < count; i++) {
+        // Sıra numarası gönderim sırasıdır: alıcının kayıp sayımı araya serpiştirmeden etkilenmez
+        put_be16(pkts[i] + 2, s->seq++);
+        s->iov[i].iov_base = pkts[i];
+        s->iov[i].iov_len = lens[i];
+        struct msghdr *mh = &s->msgs[i].msg_hdr;
+        mh->msg_name = &s->dst;
+        mh->msg_namelen = s->dst_len;
+        mh->msg_iov = &s->iov[i];
+        mh->msg_iovlen = 1;
+        bytes += lens[i];
+    }
+    if (send_all(s, s->msgs, (unsigned int)count) < 0) {
+        s->stats.errors++;
+        return -1;
+    }
+    s->stats.packets += count;
+    s->stats.bytes += bytes;
+    return count;
+}
+
+void rtp_fec_sender_get_stats(const RtpFecSender *s, RtpFecSenderStats *out) {
+    *out = s->stats;
+}
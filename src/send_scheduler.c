@@ -0,0 +1,280 @@
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include "send_scheduler.h"
+
+/* Tek sendmmsg çağrısında giden en fazla paket (rtp_fec_sender_send_packets sınırı) */
+#define SEND_BATCH FEC_MAX_TOTAL_SHARDS
+
+/* Serpiştirme derinliği üst sınırı */
+#define SEND_MAX_INTERLEAVE 32
+
+/* Kuyruktaki bir bloğun paketleri; buf yalnızca büyümek için yeniden ayrılır */
+typedef struct {
+    uint8_t *buf;
+    size_t cap;
+    size_t pkt_size;
+    int npkts;
+    int next;                       /* sıradaki seçilecek paket */
+    uint64_t t_enqueue;
+} SchedBlock;
+
+struct SendScheduler {
+    SendSchedulerConfig cfg;
+    RtpFecSender *sender;
+
+    /* [head, tail) kuyruktaki bloklar; head'i yalnızca zamanlayıcı, tail'i enqueue ilerletir */
+    SchedBlock *slots;
+    unsigned int head, tail;
+    size_t backlog;                 /* henüz seçilmemiş paket byte'ı */
+
+    pthread_mutex_t lock;
+    pthread_cond_t wake;            /* enqueue -> zamanlayıcı */
+    pthread_cond_t space;           /* zamanlayıcı -> enqueue */
+    pthread_t thread;
+    int thread_started;
+    int stop;
+
+    /* Token bucket (byte) */
+    double tokens;
+    uint64_t last_refill;
+    unsigned int rr;                /* pencere içi sıradaki blok */
+    unsigned int last_pick;         /* son seçilen paketin bloğu (serpiştirme sayacı) */
+    int have_last;
+
+    SendSchedulerStats stats;
+    TelHistogram delay;
+};
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static SchedBlock* slot_at(SendScheduler *sch, unsigned int pos) {
+    return &sch->slots[pos % sch->cfg.queue_blocks];
+}
+
+void send_scheduler_default_config(SendSchedulerConfig *cfg) {
+    cfg->interleave = 4;
+    cfg->rate_kbps = 0;
+    cfg->burst_packets = 16;
+    cfg->frame_interval_us = 33333;
+    cfg->queue_blocks = 64;
+}
+
+/*
+ * Kilit tutulurken: kovaya geçen süre kadar token ekler. En eski blok kuyruğa
+ * girişinden bir kare aralığı sonra bitmiş olmalı; kalan backlog bu süreye
+ * sığmıyorsa hız artırılır, süre dolduysa pacing bırakılır.
+ * @return byte/ns hız, 0 -> sınırsız
+ */
+static double refill(SendScheduler *sch, uint64_t now, const SchedBlock *oldest) {
+    if (!sch->cfg.rate_kbps) return 0.0;
+    double rate = sch->cfg.rate_kbps * 1000.0 / 8.0 / 1e9;
+    if (sch->cfg.frame_interval_us) {
+        uint64_t deadline = oldest->t_enqueue + (uint64_t)sch->cfg.frame_interval_us * 1000u;
+        if (now >= deadline) {
+            sch->stats.boosts++;
+            sch->last_refill = now;
+            return 0.0;
+        }
+        double need = (double)sch->backlog / (double)(deadline - now);
+        if (need > rate) {
+            rate = need;
+            sch->stats.boosts++;
+        }
+    }
+    double cap = (double)sch->cfg.burst_packets * oldest->pkt_size;
+    sch->tokens += (double)(now - sch->last_refill) * rate;
+    if (sch->tokens > cap) sch->tokens = cap;
+    sch->last_refill = now;
+    return rate;
+}
+
+/* Pencere: head'den itibaren henüz bitmemiş ilk `interleave` blok; sıradakini döndürür */
+static int window_pick(SendScheduler *sch, unsigned int *pos) {
+    unsigned int live[SEND_MAX_INTERLEAVE];
+    unsigned int n = 0;
+    for (unsigned int u = sch->head; u != sch->tail && n < sch->cfg.interleave; u++) {
+        SchedBlock *b = slot_at(sch, u);
+        if (b->next < b->npkts) live[n++] = u;
+    }
+    if (!n) return 0;
+    *pos = live[sch->rr++ % n];
+    return 1;
+}
+
+static void* scheduler_main(void *arg) {
+    SendScheduler *sch = arg;
+    uint8_t *pkts[SEND_BATCH];
+    size_t lens[SEND_BATCH];
+
+    pthread_mutex_lock(&sch->lock);
+    for (;;) {
+        if (sch->head == sch->tail) {
+            if (sch->stop) break;
+            pthread_cond_wait(&sch->wake, &sch->lock);
+            continue;
+        }
+
+        uint64_t now = now_ns();
+        double rate = refill(sch, now, slot_at(sch, sch->head));
+
+        // Token yettiği kadar paketi pencereden sırayla seç
+        int n = 0;
+        size_t wait_bytes = 0;
+        while (n < SEND_BATCH) {
+            unsigned int pos;
+            if (!window_pick(sch, &pos)) break;
+            SchedBlock *b = slot_at(sch, pos);
+            if (rate > 0.0 && sch->tokens < (double)b->pkt_size) {
+                wait_bytes = b->pkt_size;
+                sch->rr--;
+                break;
+            }
+            if (rate > 0.0) sch->tokens -= (double)b->pkt_size;
+            if (sch->have_last && sch->last_pick != pos) sch->stats.interleaved++;
+            sch->last_pick = pos;
+            sch->have_last = 1;
+            pkts[n] = b->buf + (size_t)b->next * b->pkt_size;
+            lens[n] = b->pkt_size;
+            n++;
+            sch->backlog -= b->pkt_size;
+            if (++b->next == b->npkts) {
+                uint64_t delay_ns = now - b->t_enqueue;
+                uint64_t delay_us = delay_ns / 1000u;
+                tel_hist_record(&sch->delay, delay_ns);
+                if (delay_us > sch->stats.max_delay_us) sch->stats.max_delay_us = delay_us;
+            }
+        }
+
+        if (n == 0 && wait_bytes) {
+            // Sıradaki paket için yeterli token birikene kadar (ya da yeni blok gelene kadar) bekle
+            sch->stats.paced_waits++;
+            uint64_t wait = (uint64_t)(((double)wait_bytes - sch->tokens) / rate) + 1;
+            uint64_t deadline = now + wait;
+            struct timespec ts = {
+                .tv_sec = (time_t)(deadline / 1000000000ull),
+                .tv_nsec = (long)(deadline % 1000000000ull),
+            };
+            pthread_cond_timedwait(&sch->wake, &sch->lock, &ts);
+            continue;
+        }
+
+        // Seçilen bloklar gönderim bitene kadar serbest bırakılmaz: kilitsiz gönder
+        pthread_mutex_unlock(&sch->lock);
+        int sent = rtp_fec_sender_send_packets(sch->sender, pkts, lens, n);
+        pthread_mutex_lock(&sch->lock);
+        if (sent < 0) sch->stats.send_errors++;
+        else          sch->stats.packets += (uint64_t)sent;
+
+        int freed = 0;
+        while (sch->head != sch->tail) {
+            SchedBlock *b = slot_at(sch, sch->head);
+            if (b->next < b->npkts) break;
+            sch->head++;
+            freed = 1;
+        }
+        if (freed) pthread_cond_signal(&sch->space);
+    }
+    pthread_mutex_unlock(&sch->lock);
+    return NULL;
+}
+
+SendScheduler* send_scheduler_new(const SendSchedulerConfig *cfg, RtpFecSender *sender) {
+    SendScheduler *sch = calloc(1, sizeof(*sch));
+    if (!sch) return NULL;
+    sch->cfg = *cfg;
+    if (sch->cfg.interleave < 1) sch->cfg.interleave = 1;
+    if (sch->cfg.interleave > SEND_MAX_INTERLEAVE) sch->cfg.interleave = SEND_MAX_INTERLEAVE;
+    if (sch->cfg.burst_packets < 1) sch->cfg.burst_packets = 1;
+    if (sch->cfg.queue_blocks < sch->cfg.interleave) sch->cfg.queue_blocks = sch->cfg.interleave;
+    sch->sender = sender;
+    sch->last_refill = now_ns();
+    pthread_mutex_init(&sch->lock, NULL);
+
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&sch->wake, &attr);
+    pthread_condattr_destroy(&attr);
+    pthread_cond_init(&sch->space, NULL);
+
+    sch->slots = calloc(sch->cfg.queue_blocks, sizeof(SchedBlock));
+    if (!sch->slots || pthread_create(&sch->thread, NULL, scheduler_main, sch) != 0) {
+        send_scheduler_free(sch);
+        return NULL;
+    }
+    sch->thread_started = 1;
+    return sch;
+}
+
+void send_scheduler_stop(SendScheduler *sch) {
+    if (!sch) return;
+    pthread_mutex_lock(&sch->lock);
+    sch->stop = 1;
+    pthread_cond_signal(&sch->wake);
+    pthread_mutex_unlock(&sch->lock);
+    if (sch->thread_started) pthread_join(sch->thread, NULL);
+    sch->thread_started = 0;
+}
+
+void send_scheduler_free(SendScheduler *sch) {
+    if (!sch) return;
+    send_scheduler_stop(sch);
+    if (sch->slots) {
+        for (unsigned int i = 0; i < sch->cfg.queue_blocks; i++)
+            free(sch->slots[i].buf);
+    }
+    free(sch->slots);
+    pthread_cond_destroy(&sch->space);
+    pthread_cond_destroy(&sch->wake);
+    pthread_mutex_destroy(&sch->lock);
+    free(sch);
+}
+
+int send_scheduler_enqueue(SendScheduler *sch, const FecBlock *blk,
+                           uint32_t rtp_timestamp, uint8_t flags) {
+    pthread_mutex_lock(&sch->lock);
+    if (sch->tail - sch->head >= sch->cfg.queue_blocks) {
+        sch->stats.queue_full++;
+        while (sch->tail - sch->head >= sch->cfg.queue_blocks)
+            pthread_cond_wait(&sch->space, &sch->lock);
+    }
+    SchedBlock *b = slot_at(sch, sch->tail);
+    pthread_mutex_unlock(&sch->lock);
+
+    // tail ilerlemeden zamanlayıcı bu slotu görmez: kopyalama kilitsiz yapılır
+    size_t pkt_size = RTP_FEC_PACKET_OVERHEAD + (size_t)blk->shard_size;
+    size_t need = (size_t)(blk->k + blk->r) * pkt_size;
+    if (need > b->cap) {
+        uint8_t *buf = realloc(b->buf, need);
+        if (!buf) return -1;
+        b->buf = buf;
+        b->cap = need;
+    }
+    b->pkt_size = pkt_size;
+    b->npkts = rtp_fec_sender_pack_block(sch->sender, blk, rtp_timestamp, flags, b->buf, pkt_size);
+    b->next = 0;
+    b->t_enqueue = now_ns();
+
+    pthread_mutex_lock(&sch->lock);
+    sch->tail++;
+    sch->backlog += need;
+    sch->stats.blocks++;
+    unsigned int queued = sch->tail - sch->head;
+    if (queued > sch->stats.max_queue) sch->stats.max_queue = queued;
+    pthread_cond_signal(&sch->wake);
+    pthread_mutex_unlock(&sch->lock);
+    return 0;
+}
+
+void send_scheduler_get_stats(SendScheduler *sch, SendSchedulerStats *out) {
+    pthread_mutex_lock(&sch->lock);
+    *out = sch->stats;
+    out->queued = sch->tail - sch->head;
+    pthread_mutex_unlock(&sch->lock);
+    tel_hist_summary(&sch->delay, &out->delay);
+}
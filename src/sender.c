@@ -1,22 +1,288 @@
 #include <gst/gst.h>
 #include <gst/app/gstappsink.h>
+#include <glib-unix.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
 #include <isa-l.h> // ISA-L başlık dosyasını ekle
 
 #include "gpu_detect_factory.h"
+#include "gpu_memory.h"
+#include "encoder_profile.h"
+#include "fec_codec.h"
+#include "shard_pool.h"
+#include "fec_block.h"
+#include "rtp_fec.h"
+#include "rtcp_feedback.h"
+#include "fec_controller.h"
+#include "fec_pipeline.h"
+#include "fec_aggregator.h"
+#include "slice_packer.h"
+#include "send_scheduler.h"
+#include "telemetry.h"
+#include "media_source.h"
+#include "stream_config.h"
+#include "preview.h"
 
-// --- FEC Parametreleri ---
+// --- FEC Parametreleri (varsayılanlar; r çalışma anında denetleyiciden gelir) ---
 #define K_DATA_SHARDS 10
 #define R_PARITY_SHARDS 4
-#define TOTAL_SHARDS (K_DATA_SHARDS + R_PARITY_SHARDS)
 
-// AppSink'ten yeni bir örnek (H.264 buffer) geldiğinde çağrılacak fonksiyon
+// Havuzdaki en az slab adedi; iş hattı kuyruk derinliğine göre artırılır
+#define SHARD_POOL_SLABS 8
+
+// Ortalama erişim birimi başına ayrılan slab (büyük IDR'lar birden çok bloğa bölünür)
+#define SLABS_PER_JOB 4
+
+// İş hattı özetinin varsayılan basılma aralığı (--stats-interval)
+#define STATS_INTERVAL_SEC 5
+
+// --stats-file yeniden yazılma aralığı
+#define STATS_FILE_INTERVAL_SEC 1
+
+// PLI'a yanıt olarak zorlanan IDR'lar arası en kısa süre: önceki IDR yoldayken
+// gelen PLI'lar yeni bir IDR daha üretmesin
+#define PLI_MIN_INTERVAL_US 200000
+
+// --nack-budget varsayılanı: yeniden gönderime ayrılan pay, bit hızı bütçesinin yüzdesi
+#define NACK_BUDGET_PCT 10
+
+// --simulcast katman sayısı üst sınırı (örn. 720p / 360p / 180p)
+#define MAX_LAYERS 3
+
+// Piksel oranıyla küçültülen alt katman bit hızı bunun altına inmez
+#define LAYER_MIN_KBPS 100
+
+// Bütün akışların paylaştığı durum: shard havuzu ve FEC işçileri
+static ShardPool *shard_pool = NULL;
+
+// Tam veri shard'ları eşlenmiş buffer'ı doğrudan göstersin mi (--copy-shards ile kapatılır)
+static gboolean zero_copy_shards = TRUE;
+
+// MTU'ya göre en büyük shard boyutu
+static int max_shard_size = 0;
+
+// appsink iş parçacıklarını FEC kodlamadan ve ağdan ayıran, akışlarca paylaşılan iş hattı
+static FecPipeline *fec_pipe = NULL;
+
+static GMainLoop *main_loop = NULL;
+
+// Prometheus metin dışa aktarımı (--metrics-port / --stats-file); ikisi de yoksa NULL
+static Telemetry *telemetry = NULL;
+static gchar *stats_file = NULL;
+
+// EOS'a ulaşmamış akış sayısı; hepsi bitince ana döngü durur
+static gint streams_running = 0;
+
+// --streams ile birden çok akış varsa çıktılar akış adıyla etiketlenir
+static gboolean multi_stream = FALSE;
+
+// Komut satırından gelen, her akışa aynen uygulanan ayarlar
+typedef struct {
+    FecControllerConfig fec;
+    guint aggregate_us;             /* 0 -> toplama yok */
+    gboolean slice_mode;            /* NAL hizalı çıkış, slice grubu başına FEC işi */
+    SendSchedulerConfig sched;      /* serpiştirme ve pacing; kare aralığı akışın fps'inden */
+    gboolean scheduled;             /* --interleave > 1 ya da --pacing-kbps verildi */
+    gboolean gso;
+    gboolean headless;              /* önizleme dalı kurulmaz */
+    PreviewConfig preview;
+    gboolean gpu_memory;            /* post-proc çıkışını cihaz belleğinde tut (--gpu-memory) */
+    EncoderConfig enc;              /* profil ve GOP; bit hızı akışın denetleyicisinden */
+    gint min_bitrate_kbps;          /* 0 -> bütçenin dörtte biri */
+    gboolean adaptive_bitrate;      /* RTCP kaybına göre encoder bit hızını değiştir */
+    guint nack_history;             /* NACK için saklanan blok; 0 -> NACK'ler yanıtsız */
+    guint nack_budget_pct;          /* yeniden gönderim, akış bütçesinin yüzdesi */
+    gint layer_heights[MAX_LAYERS]; /* --simulcast, azalan; tek katmanda 0 -> kaynak boyutu */
+    gint layer_count;
+} SenderSettings;
+
+#define MAX_BRANCH_PATH 8
+
+typedef struct SenderStream SenderStream;
+
+// Tek bir encode dalı: tee -> [ölçekleme] -> encoder -> appsink -> FEC -> gönderim.
+// --simulcast'ta her katman ayrı bir dal; kendi SSRC'si ve FEC blok akışıyla.
+// Aynı anda yalnızca akışın etkin katmanı FEC'e ve ağa gider.
+typedef struct {
+    SenderStream *stream;
+    int index;                      /* 0 -> en yüksek çözünürlük */
+    gint height;                    /* 0 -> kaynak boyutu, ölçekleme yok */
+    gchar *name;                    /* "720p"; tek katmanda "encode" */
+    gchar *label;                   /* çıktı öneki: akış etiketi, simulcast'ta katman adıyla */
+    guint32 ssrc;
+    GstElement *enc;
+    guint enc_kbps;                 /* encoder'a son uygulanan hedef */
+    guint bitrate_changes;
+    gint64 last_forced_us;
+
+    // RTP/UDP çıkışı; zamanlayıcı varsa bloklar onun üzerinden serpiştirilip yayılır
+    RtpFecSender *rtp_sender;
+    SendScheduler *scheduler;
+    SendSchedulerStats sched_stats;
+
+    // Küçük P-frame'leri tek FEC bloğunda toplayan kurucu (--aggregate-ms)
+    FecAggregator *fec_agg;
+    FecAggregatorStats agg_stats;
+
+    // --slice-mode: erişim birimini beklemeden NAL'ları slice gruplarına ayıran kurucu
+    SlicePacker *slicer;
+    SlicePackerStats slice_stats;
+
+    // Paylaşılan iş hattındaki etiket ve GOP atlama durumu
+    FecProducer producer;
+
+    // appsink'ten çıkan buffer'lar: etkin katmanken gönderilen / değilken atlanan
+    gint units_sent;
+    gint units_skipped;
+
+    // İlk buffer'da doğrulanan bellek yolu
+    GstElement *path[MAX_BRANCH_PATH];
+    int path_len;
+} SenderLayer;
+
+// Tek bir yakalama -> encode -> FEC -> gönderim hattı; kendi soketleri,
+// FEC denetleyicisi ve istatistikleriyle. Encode dalları (katmanlar) aynı
+// yakalamayı tee'den paylaşır; alıcı etkin katmanı SSRC'sinden tanır.
+struct SenderStream {
+    StreamConfig cfg;
+    MediaSourceKind kind;
+    GstElement *pipeline;
+    const char *enc_name;
+    gboolean adaptive_bitrate;
+
+    SenderLayer *layers[MAX_LAYERS];
+    int nlayers;
+    // Etkin katmanı appsink iş parçacıkları okur; geçiş bekleyen katmanın ilk
+    // keyframe'inde yapılır (-1 -> bekleyen yok)
+    gint active_layer;
+    gint pending_layer;
+    gint layer_switches;
+
+    // Alıcıdan gelen RTCP kayıp raporlarına göre (k, r) seçen denetleyici
+    FecController *fec_ctl;
+
+    // PLI -> zorlanan IDR (ana döngü yazar, telemetri atomik okur)
+    gint plis;
+    gint keyframes_forced;
+
+    // Yakalama anı (base_time + PTS) -> appsink gecikmesi, ns
+    TelHistogram capture_latency;
+
+    // Encode dalının girişi (tee iş parçacığı): kare sayısı ve PTS boşluğundan eksik kare
+    gint enc_frames;
+    gint enc_missing;
+    GstClockTime enc_first_pts, enc_last_pts;
+
+    // Sızdıran kuyruklu önizleme dalı; --headless'ta NULL
+    PreviewBranch *preview;
+
+    int feedback_fd;
+    guint feedback_watch;
+    gint pinned_threads;            /* cfg.cpus'a sabitlenen GStreamer iş parçacıkları */
+    gboolean eos;
+
+    // Cihaz belleği planı ve ilk buffer'da doğrulanan önizleme yolu
+    const char *mem_caps;           /* NULL -> sistem belleği */
+    const char *mem_note;           /* planın nedeni */
+    gboolean enc_download, disp_download;
+    GstElement *disp_path[MAX_BRANCH_PATH];
+    int disp_path_len;
+    gint downloads;                 /* negotiation sonrası görülen sistem belleği indirmeleri */
+    gchar *label;                   /* çıktı öneki: "[ad] " ya da tek akışta "" */
+};
+
+// Eşlenmiş GstBuffer, işin bütün blokları gönderilene kadar canlı tutulur.
+// İş hattı sahibi gönderimden sonra (ya da atlanınca) tam bir kez bırakır.
+typedef struct {
+    GstBuffer *buffer;
+    GstMapInfo map;
+} MappedBuffer;
+
+static void mapped_buffer_release(void *owner) {
+    MappedBuffer *mb = owner;
+    gst_buffer_unmap(mb->buffer, &mb->map);
+    gst_buffer_unref(mb->buffer);
+    g_free(mb);
+}
+
+// Buffer PTS'ini yakalama anının saat zamanına (base_time + PTS) çevirir; 90 kHz
+// RTP zaman damgası buradan türetilir. Sistem saati CLOCK_MONOTONIC olduğu için
+// g_get_monotonic_time ile karşılaştırılabilir ve aynı makinedeki alıcı uçtan uca
+// gecikmeyi doğrudan ölçebilir.
+static GstClockTime capture_time_for(GstElement *sink, GstBuffer *buffer) {
+    GstClockTime pts = GST_BUFFER_PTS(buffer);
+    if (!GST_CLOCK_TIME_IS_VALID(pts)) return GST_CLOCK_TIME_NONE;
+    return gst_element_get_base_time(sink) + pts;
+}
+
+// Sıralayıcı iş parçacığında, erişim birimleri geliş sırasıyla çağrılır;
+// iş, gönderildiği katmanın etiketini taşır. Slice grubunda START yalnızca birimin
+// ilk grubunda, END son grubunda; ara grupların son bloğu SLICE_END taşır.
+static void on_fec_job_ready(void *user, FecJob *job) {
+    SenderLayer *l = job->tag;
+    guint8 frame_flags = job->keyframe ? RTP_FEC_FLAG_KEYFRAME : 0;
+    if (job->flags & FEC_JOB_AGGREGATE) frame_flags |= RTP_FEC_FLAG_AGGREGATE;
+    for (int i = 0; i < job->nblocks; i++) {
+        guint8 flags = frame_flags;
+        if (i == 0 && !(job->flags & FEC_JOB_NOT_FIRST))
+            flags |= RTP_FEC_FLAG_START_OF_FRAME;
+        if (i == job->nblocks - 1)
+            flags |= (job->flags & FEC_JOB_NOT_LAST) ? RTP_FEC_FLAG_SLICE_END
+                                                     : RTP_FEC_FLAG_END_OF_FRAME;
+        int rc = l->scheduler
+            ? send_scheduler_enqueue(l->scheduler, &job->blocks[i], job->rtp_timestamp, flags)
+            : rtp_fec_sender_send_block(l->rtp_sender, &job->blocks[i], job->rtp_timestamp, flags);
+        if (rc < 0)
+            g_printerr("%sFailed to send FEC block\n", l->label);
+    }
+}
+
+// Kurucudan sırayla gelen işler: (k, r) gönderim anındaki kayıp tahmininden seçilir
+static void on_aggregate_ready(void *user, const unsigned char *data, size_t len,
+                               void *owner, void (*release_owner)(void *owner),
+                               uint32_t rtp_ts, int keyframe, int aggregated) {
+    SenderLayer *l = user;
+    // Güncel kayıp tahminine ve kare tipine göre (k, r); IDR daha fazla parity alır
+    int k, r;
+    fec_controller_select(l->stream->fec_ctl, keyframe, &k, &r);
+    fec_pipeline_submit(fec_pipe, &l->producer, data, len, owner, release_owner,
+                        rtp_ts, keyframe, aggregated ? FEC_JOB_AGGREGATE : 0, k, r);
+}
+
+// Slice kurucusundan gelen gruplar: her grup kendi (k, r) seçimiyle ayrı bir iş
+static void on_slice_group_ready(void *user, const unsigned char *data, size_t len,
+                                 void *owner, void (*release_owner)(void *owner),
+                                 uint32_t rtp_ts, int keyframe, int job_flags) {
+    SenderLayer *l = user;
+    int k, r;
+    fec_controller_select(l->stream->fec_ctl, keyframe, &k, &r);
+    fec_pipeline_submit(fec_pipe, &l->producer, data, len, owner, release_owner,
+                        rtp_ts, keyframe, job_flags, k, r);
+}
+
+// Yalnızca etkin katman gönderilir. Bekleyen katman ilk keyframe'inde etkin olur;
+// eski katmanın sonraki buffer'ları atlanır, alıcı yeni SSRC'ye IDR'la başlar.
+static gboolean layer_admit(SenderLayer *l, gboolean keyframe) {
+    SenderStream *s = l->stream;
+    if (g_atomic_int_get(&s->active_layer) == l->index) return TRUE;
+    if (!keyframe || !g_atomic_int_compare_and_exchange(&s->pending_layer, l->index, -1))
+        return FALSE;
+    g_atomic_int_set(&s->active_layer, l->index);
+    g_atomic_int_inc(&s->layer_switches);
+    return TRUE;
+}
+
+// AppSink'ten yeni bir örnek (H.264 buffer) geldiğinde çağrılacak fonksiyon.
+// Yalnızca eşleme yapıp işi kuyruğa bırakır; FEC ve gönderim işçilerde yürür.
 static GstFlowReturn on_new_sample_from_sink(GstElement *sink, gpointer data) {
+    SenderLayer *l = data;
+    SenderStream *s = l->stream;
     GstSample *sample;
     GstBuffer *buffer;
-    GstMapInfo map;
 
     // AppSink'ten örneği çek
     g_signal_emit_by_name(sink, "pull-sample", &sample);
@@ -28,249 +294,1504 @@ static GstFlowReturn on_new_sample_from_sink(GstElement *sink, gpointer data) {
         return GST_FLOW_OK;
     }
 
-    if (gst_buffer_map(buffer, &map, GST_MAP_READ)) {
-        g_print("H.264 NAL unit received, size: %ld bytes. Applying FEC...\n", map.size);
-
-        // --- ISA-L Reed-Solomon Kodlama Başlangıcı ---
-        
-        // 1. Gelen veriyi shard'lara bölmek için boyutu ve hizalamayı hesapla
-        int shard_size = (map.size + K_DATA_SHARDS - 1) / K_DATA_SHARDS;
-        // ISA-L'in verimli çalışması için shard boyutunu 16 byte'ın katı yapalım
-        shard_size = (shard_size + 15) & ~15;
-
-        // 2. Bellek tamponlarını (buffer) ayarla
-        unsigned char *data_shards[TOTAL_SHARDS];
-        for (int i = 0; i < TOTAL_SHARDS; i++) {
-            if (posix_memalign((void **)&data_shards[i], 16, shard_size)) {
-                g_printerr("Failed to allocate aligned memory for shards\n");
-                gst_buffer_unmap(buffer, &map);
-                gst_sample_unref(sample);
-                return GST_FLOW_ERROR;
-            }
-        }
-        
-        // Gelen veriyi ilk K adet shard'a kopyala, kalanı sıfırla (padding)
-        // memset(data_shards[0], 0, K_DATA_SHARDS * shard_size);
-        // memcpy(data_shards[0], map.data, map.size);
-
-        // Daha güvenli bellek yönetimi: Veriyi shard'lara manuel olarak dağıt
-        size_t bytes_copied = 0;
-        for (int i = 0; i < K_DATA_SHARDS; i++) {
-            size_t to_copy = map.size - bytes_copied;
-            if (to_copy > shard_size) {
-                to_copy = shard_size;
-            }
-            if (to_copy > 0) {
-                memcpy(data_shards[i], (unsigned char*)map.data + bytes_copied, to_copy);
-                bytes_copied += to_copy;
-            }
-            // Shard'ın geri kalanını sıfırla (padding)
-            if (to_copy < shard_size) {
-                memset(data_shards[i] + to_copy, 0, shard_size - to_copy);
-            }
-        }
-        // Eğer veri tüm shard'ları doldurmadıysa, kalan shard'ları tamamen sıfırla
-        for (int i = bytes_copied / shard_size + 1; i < K_DATA_SHARDS; i++) {
-             memset(data_shards[i], 0, shard_size);
+    // Etkin olmayan katman eşlenmeden bırakılır: ne FEC işçisine ne ağa gider
+    gboolean keyframe = !GST_BUFFER_FLAG_IS_SET(buffer, GST_BUFFER_FLAG_DELTA_UNIT);
+    if (!layer_admit(l, keyframe)) {
+        g_atomic_int_inc(&l->units_skipped);
+        gst_sample_unref(sample);
+        return GST_FLOW_OK;
+    }
+    g_atomic_int_inc(&l->units_sent);
+
+    // Eşleme, işin sahibi olarak kendi buffer referansını taşır; sample hemen bırakılabilir
+    MappedBuffer *mb = g_new0(MappedBuffer, 1);
+    mb->buffer = gst_buffer_ref(buffer);
+    gst_sample_unref(sample);
+    if (!gst_buffer_map(mb->buffer, &mb->map, GST_MAP_READ)) {
+        gst_buffer_unref(mb->buffer);
+        g_free(mb);
+        return GST_FLOW_OK;
+    }
+
+    // Yakalama -> appsink: kaynak, post-proc, tee kuyruğu, encoder ve parser birlikte
+    GstClockTime now = (GstClockTime)g_get_monotonic_time() * GST_USECOND;
+    GstClockTime capture = capture_time_for(sink, mb->buffer);
+    if (GST_CLOCK_TIME_IS_VALID(capture))
+        tel_hist_record(&s->capture_latency, now > capture ? now - capture : 0);
+    else
+        capture = now;
+    guint32 rtp_ts = (guint32)gst_util_uint64_scale(capture, RTP_FEC_CLOCK_RATE, GST_SECOND);
+    if (l->slicer) {
+        // Her buffer tek bir NAL; h264parse birimin son NAL'ını MARKER ile işaretler
+        slice_packer_push(l->slicer, mb->map.data, mb->map.size, mb, mapped_buffer_release,
+                          rtp_ts, GST_BUFFER_FLAG_IS_SET(mb->buffer, GST_BUFFER_FLAG_MARKER));
+        return GST_FLOW_OK;
+    }
+
+    fec_aggregator_push(l->fec_agg, mb->map.data, mb->map.size, mb, mapped_buffer_release,
+                        rtp_ts, keyframe);
+    return GST_FLOW_OK;
+}
+
+static void print_stage(const char *name, const TelSummary *st) {
+    if (!st->count) return;
+    g_print("   %-8s avg %7.3f ms, p50 %7.3f ms, p99 %7.3f ms, max %7.3f ms\n", name,
+            (double)st->sum / st->count / 1e6, st->p50 / 1e6, st->p99 / 1e6, st->max / 1e6);
+}
+
+static void print_pipeline_stats(void) {
+    FecPipelineStats s;
+    fec_pipeline_get_stats(fec_pipe, &s);
+    g_print(" > FEC pipeline: %llu queued, %llu dropped, %llu blocked, %llu failed, %llu in flight\n",
+            (unsigned long long)s.submitted, (unsigned long long)s.dropped,
+            (unsigned long long)s.blocked, (unsigned long long)s.failed,
+            (unsigned long long)s.in_flight);
+    if (s.blocks)
+        g_print("   %llu bytes in %llu blocks: %llu data + %llu parity shards, %llu padding bytes\n",
+                (unsigned long long)s.bytes_in, (unsigned long long)s.blocks,
+                (unsigned long long)s.data_shards, (unsigned long long)s.parity_shards,
+                (unsigned long long)s.padding_bytes);
+    print_stage("queue", &s.queue);
+    print_stage("shard", &s.shard);
+    print_stage("encode", &s.encode);
+    print_stage("reorder", &s.reorder);
+    print_stage("send", &s.emit);
+    print_stage("total", &s.total);
+}
+
+// Erişim birimi başına yazdırmak yerine periyodik özet (--stats-interval)
+static gboolean on_stats_timer(gpointer data) {
+    print_pipeline_stats();
+    return G_SOURCE_CONTINUE;
+}
+
+static gboolean on_stats_file_timer(gpointer data) {
+    if (telemetry_write_file(telemetry, stats_file) < 0)
+        g_printerr("Failed to write stats file %s\n", stats_file);
+    return G_SOURCE_CONTINUE;
+}
+
+static void write_stage(TelWriter *w, const char *stage, const TelSummary *st) {
+    gchar *labels = g_strdup_printf("stage=\"%s\"", stage);
+    tel_write_summary(w, "nova_sender_stage_latency_seconds", labels, st, 1e-9);
+    g_free(labels);
+}
+
+static void write_counter(TelWriter *w, const char *name, const char *help, guint64 value) {
+    tel_write_family(w, name, "counter", help);
+    tel_write_value(w, name, NULL, (double)value);
+}
+
+// Kazıma başına bir kez, telemetri iş parçacığından çağrılır. Yalnızca kilitli ya da
+// atomik okunan durum yazılır (iş hattı, zamanlayıcı, denetleyici, histogramlar).
+// Katman metriklerinin etiketi: tek katmanda yalnızca akış, simulcast'ta katman adıyla
+static gchar* layer_metric_labels(const SenderLayer *l) {
+    const SenderStream *s = l->stream;
+    if (s->nlayers == 1) return g_strdup_printf("stream=\"%s\"", s->cfg.name);
+    return g_strdup_printf("stream=\"%s\",layer=\"%s\"", s->cfg.name, l->name);
+}
+
+static void collect_sender_metrics(void *user, TelWriter *w) {
+    GPtrArray *streams = user;
+    FecPipelineStats ps;
+    fec_pipeline_get_stats(fec_pipe, &ps);
+
+    tel_write_family(w, "nova_sender_stage_latency_seconds", "summary",
+                     "FEC pipeline stage latency per access unit or slice group");
+    write_stage(w, "queue", &ps.queue);
+    write_stage(w, "shard", &ps.shard);
+    write_stage(w, "encode", &ps.encode);
+    write_stage(w, "reorder", &ps.reorder);
+    write_stage(w, "send", &ps.emit);
+    write_stage(w, "total", &ps.total);
+    write_counter(w, "nova_sender_fec_jobs_total", "Jobs queued to the FEC workers", ps.submitted);
+    write_counter(w, "nova_sender_fec_dropped_total", "Jobs dropped by the queue policy", ps.dropped);
+    write_counter(w, "nova_sender_fec_blocked_total", "Submissions that waited for queue space",
+                  ps.blocked);
+    write_counter(w, "nova_sender_fec_failed_total", "Jobs whose blocks could not be prepared",
+                  ps.failed);
+    write_counter(w, "nova_sender_fec_bytes_total", "Payload bytes protected by FEC", ps.bytes_in);
+    write_counter(w, "nova_sender_fec_blocks_total", "FEC blocks sent", ps.blocks);
+    tel_write_family(w, "nova_sender_fec_shards_total", "counter", "Shards sent by kind");
+    tel_write_value(w, "nova_sender_fec_shards_total", "kind=\"data\"", (double)ps.data_shards);
+    tel_write_value(w, "nova_sender_fec_shards_total", "kind=\"parity\"", (double)ps.parity_shards);
+    write_counter(w, "nova_sender_fec_padding_bytes_total", "Zero padding in tail data shards",
+                  ps.padding_bytes);
+    tel_write_family(w, "nova_sender_fec_in_flight", "gauge", "Jobs queued or being encoded");
+    tel_write_value(w, "nova_sender_fec_in_flight", NULL, (double)ps.in_flight);
+
+    guint n = streams->len;
+    gchar **labels = g_new0(gchar *, n);
+    FecControllerState *cs = g_new0(FecControllerState, n);
+    TelSummary *cap = g_new0(TelSummary, n);
+    PreviewStats *pv = g_new0(PreviewStats, n);
+    gboolean simulcast = FALSE;
+    guint nl = 0;
+    for (guint i = 0; i < n; i++) {
+        SenderStream *s = streams->pdata[i];
+        labels[i] = g_strdup_printf("stream=\"%s\"", s->cfg.name);
+        if (s->preview) preview_branch_get_stats(s->preview, &pv[i]);
+        fec_controller_get_state(s->fec_ctl, &cs[i]);
+        tel_hist_summary(&s->capture_latency, &cap[i]);
+        if (s->nlayers > 1) simulcast = TRUE;
+        nl += (guint)s->nlayers;
+    }
+    // Gönderim sayaçları katman başına (her katmanın kendi SSRC'si ve zamanlayıcısı var)
+    SenderLayer **lay = g_new0(SenderLayer *, nl);
+    gchar **llabels = g_new0(gchar *, nl);
+    SendSchedulerStats *sc = g_new0(SendSchedulerStats, nl);
+    RtpFecResendStats *rs = g_new0(RtpFecResendStats, nl);
+    nl = 0;
+    for (guint i = 0; i < n; i++) {
+        SenderStream *s = streams->pdata[i];
+        for (int j = 0; j < s->nlayers; j++, nl++) {
+            SenderLayer *l = lay[nl] = s->layers[j];
+            llabels[nl] = layer_metric_labels(l);
+            rtp_fec_sender_get_resend_stats(l->rtp_sender, &rs[nl]);
+            if (l->scheduler) send_scheduler_get_stats(l->scheduler, &sc[nl]);
         }
+    }
 
-        // 3. Kodlama matrisini ve tablolarını oluştur
-        unsigned char gftbls[K_DATA_SHARDS * R_PARITY_SHARDS * 32];
-        unsigned char encode_matrix[TOTAL_SHARDS * K_DATA_SHARDS];
-        ec_init_tables(K_DATA_SHARDS, R_PARITY_SHARDS, &encode_matrix[K_DATA_SHARDS * K_DATA_SHARDS], gftbls);
-        gf_gen_cauchy1_matrix(encode_matrix, TOTAL_SHARDS, K_DATA_SHARDS);
-
-        // 4. Parity dilimlerini hesapla (asıl kodlama işlemi)
-        ec_encode_data(shard_size, K_DATA_SHARDS, R_PARITY_SHARDS, gftbls, data_shards, &data_shards[K_DATA_SHARDS]);
-
-        g_print(" > FEC applied: %d data + %d parity shards of size %d created.\n", K_DATA_SHARDS, R_PARITY_SHARDS, shard_size);
-        
-        // TODO: Burada k+r adet shard, RTP paketlerine dönüştürülüp gönderilecek
-        
-        // Belleği temizle
-        for (int i = 0; i < TOTAL_SHARDS; i++) {
-            free(data_shards[i]);
+    tel_write_family(w, "nova_sender_capture_latency_seconds", "summary",
+                     "Capture timestamp to appsink, per encoded buffer");
+    for (guint i = 0; i < n; i++)
+        tel_write_summary(w, "nova_sender_capture_latency_seconds", labels[i], &cap[i], 1e-9);
+    tel_write_family(w, "nova_sender_branch_frames_total", "counter", "Raw frames entering each tee branch");
+    for (guint i = 0; i < n; i++) {
+        SenderStream *s = streams->pdata[i];
+        gchar *l = g_strdup_printf("%s,branch=\"encode\"", labels[i]);
+        tel_write_value(w, "nova_sender_branch_frames_total", l, g_atomic_int_get(&s->enc_frames));
+        g_free(l);
+        if (!s->preview) continue;
+        l = g_strdup_printf("%s,branch=\"preview\"", labels[i]);
+        tel_write_value(w, "nova_sender_branch_frames_total", l, (double)pv[i].frames);
+        g_free(l);
+    }
+    tel_write_family(w, "nova_sender_branch_dropped_total", "counter",
+                     "Frames a branch did not get: source gaps (encode), full queue or decimation (preview)");
+    for (guint i = 0; i < n; i++) {
+        SenderStream *s = streams->pdata[i];
+        gchar *l = g_strdup_printf("%s,branch=\"encode\",reason=\"missing\"", labels[i]);
+        tel_write_value(w, "nova_sender_branch_dropped_total", l, g_atomic_int_get(&s->enc_missing));
+        g_free(l);
+        if (!s->preview) continue;
+        l = g_strdup_printf("%s,branch=\"preview\",reason=\"queue_full\"", labels[i]);
+        tel_write_value(w, "nova_sender_branch_dropped_total", l, (double)pv[i].dropped);
+        g_free(l);
+        l = g_strdup_printf("%s,branch=\"preview\",reason=\"decimated\"", labels[i]);
+        tel_write_value(w, "nova_sender_branch_dropped_total", l, (double)pv[i].decimated);
+        g_free(l);
+    }
+    tel_write_family(w, "nova_sender_loss_ratio", "gauge", "Receiver loss estimate");
+    for (guint i = 0; i < n; i++)
+        tel_write_value(w, "nova_sender_loss_ratio", labels[i], cs[i].loss_estimate);
+    tel_write_family(w, "nova_sender_parity_shards", "gauge", "Parity shards per delta-frame block");
+    for (guint i = 0; i < n; i++)
+        tel_write_value(w, "nova_sender_parity_shards", labels[i], cs[i].r_delta);
+    tel_write_family(w, "nova_sender_target_bitrate_bps", "gauge", "Encoder target bitrate");
+    for (guint i = 0; i < n; i++)
+        tel_write_value(w, "nova_sender_target_bitrate_bps", labels[i], cs[i].target_kbps * 1000.0);
+    if (simulcast) {
+        tel_write_family(w, "nova_sender_active_layer", "gauge",
+                         "Simulcast layer being sent, 0 = highest resolution");
+        for (guint i = 0; i < n; i++)
+            tel_write_value(w, "nova_sender_active_layer", labels[i],
+                            g_atomic_int_get(&((SenderStream *)streams->pdata[i])->active_layer));
+        tel_write_family(w, "nova_sender_layer_switches_total", "counter",
+                         "Simulcast layer changes, each at a keyframe of the new layer");
+        for (guint i = 0; i < n; i++)
+            tel_write_value(w, "nova_sender_layer_switches_total", labels[i],
+                            g_atomic_int_get(&((SenderStream *)streams->pdata[i])->layer_switches));
+        tel_write_family(w, "nova_sender_layer_units_total", "counter",
+                         "Encoded buffers per simulcast layer: sent while active, skipped otherwise");
+        for (guint i = 0; i < nl; i++) {
+            gchar *l = g_strdup_printf("%s,state=\"sent\"", llabels[i]);
+            tel_write_value(w, "nova_sender_layer_units_total", l, g_atomic_int_get(&lay[i]->units_sent));
+            g_free(l);
+            l = g_strdup_printf("%s,state=\"skipped\"", llabels[i]);
+            tel_write_value(w, "nova_sender_layer_units_total", l,
+                            g_atomic_int_get(&lay[i]->units_skipped));
+            g_free(l);
         }
-        // --- ISA-L Reed-Solomon Kodlama Sonu ---
+    }
+
+    tel_write_family(w, "nova_sender_pli_total", "counter", "Picture loss indications received");
+    for (guint i = 0; i < n; i++)
+        tel_write_value(w, "nova_sender_pli_total", labels[i],
+                        g_atomic_int_get(&((SenderStream *)streams->pdata[i])->plis));
+    tel_write_family(w, "nova_sender_keyframes_forced_total", "counter",
+                     "Keyframes forced in answer to a PLI");
+    for (guint i = 0; i < n; i++)
+        tel_write_value(w, "nova_sender_keyframes_forced_total", labels[i],
+                        g_atomic_int_get(&((SenderStream *)streams->pdata[i])->keyframes_forced));
+    tel_write_family(w, "nova_sender_nack_blocks_total", "counter", "FEC blocks named in NACKs");
+    for (guint i = 0; i < nl; i++)
+        tel_write_value(w, "nova_sender_nack_blocks_total", llabels[i], (double)rs[i].requests);
+    tel_write_family(w, "nova_sender_resent_bytes_total", "counter",
+                     "Shard bytes resent in answer to NACKs");
+    for (guint i = 0; i < nl; i++)
+        tel_write_value(w, "nova_sender_resent_bytes_total", llabels[i], (double)rs[i].bytes);
+
+    tel_write_family(w, "nova_sender_sched_delay_seconds", "summary",
+                     "Send scheduler delay from enqueue to the last packet of a block");
+    for (guint i = 0; i < nl; i++)
+        if (sc[i].blocks)
+            tel_write_summary(w, "nova_sender_sched_delay_seconds", llabels[i], &sc[i].delay, 1e-9);
+    tel_write_family(w, "nova_sender_sched_queue_blocks", "gauge", "Blocks waiting in the send scheduler");
+    for (guint i = 0; i < nl; i++)
+        if (sc[i].blocks)
+            tel_write_value(w, "nova_sender_sched_queue_blocks", llabels[i], sc[i].queued);
+    tel_write_family(w, "nova_sender_sched_packets_total", "counter", "Packets sent by the scheduler");
+    for (guint i = 0; i < nl; i++)
+        if (sc[i].blocks)
+            tel_write_value(w, "nova_sender_sched_packets_total", llabels[i], (double)sc[i].packets);
+    tel_write_family(w, "nova_sender_sched_paced_waits_total", "counter", "Token bucket waits");
+    for (guint i = 0; i < nl; i++)
+        if (sc[i].blocks)
+            tel_write_value(w, "nova_sender_sched_paced_waits_total", llabels[i],
+                            (double)sc[i].paced_waits);
+
+    for (guint i = 0; i < n; i++) g_free(labels[i]);
+    g_free(labels);
+    for (guint i = 0; i < nl; i++) g_free(llabels[i]);
+    g_free(llabels);
+    g_free(lay);
+    g_free(sc);
+    g_free(cs);
+    g_free(cap);
+    g_free(rs);
+    g_free(pv);
+}
+
+// Denetleyicinin hedefi belirgin biçimde değiştiyse encoder'a uygular; küçük
+// dalgalanmalar encoder'ın hız denetimini gereksiz yere yeniden başlatmasın
+#define BITRATE_HYSTERESIS 0.05
 
-        gst_buffer_unmap(buffer, &map);
+static void apply_target_bitrate(SenderLayer *l) {
+    guint target = (guint)fec_controller_target_bitrate(l->stream->fec_ctl);
+    if (!target || target == l->enc_kbps) return;
+    double change = (double)target / l->enc_kbps;
+    if (change > 1.0 - BITRATE_HYSTERESIS && change < 1.0 + BITRATE_HYSTERESIS) return;
+    if (encoder_set_bitrate(l->enc, target)) {
+        l->enc_kbps = target;
+        l->bitrate_changes++;
     }
+}
 
-    gst_sample_unref(sample);
-    return GST_FLOW_OK;
+// Katmanın encoder'ından GOP sonunu beklemeden bir IDR ister (en fazla
+// PLI_MIN_INTERVAL_US'de bir); istek gönderildiyse TRUE
+static gboolean layer_request_keyframe(SenderLayer *l) {
+    gint64 now = g_get_monotonic_time();
+    if (l->last_forced_us && now - l->last_forced_us < PLI_MIN_INTERVAL_US) return FALSE;
+    if (!encoder_force_keyframe(l->enc)) return FALSE;
+    l->last_forced_us = now;
+    return TRUE;
+}
+
+// Simulcast: katman encoder'ları kendi bit hızlarında kalır, denetleyicinin hedefi
+// gönderilecek katmanı seçer (hedefe sığan en yüksek çözünürlük; yukarı geçiş
+// histerezisle). Yeni katman bir IDR'la başlasın diye keyframe'i hemen istenir ve
+// geçiş bekledikçe her raporda yinelenir (olay kaybolduysa geçiş takılı kalmasın).
+static void select_layer(SenderStream *s) {
+    guint target = (guint)fec_controller_target_bitrate(s->fec_ctl);
+    int active = g_atomic_int_get(&s->active_layer);
+    int pending = g_atomic_int_get(&s->pending_layer);
+    int current = pending >= 0 ? pending : active;
+    int want = s->nlayers - 1;
+    for (int i = 0; i < s->nlayers; i++) {
+        double need = s->layers[i]->enc_kbps * (i < current ? 1.0 + BITRATE_HYSTERESIS : 1.0);
+        if (target >= need) { want = i; break; }
+    }
+    if (want == current) {
+        if (pending >= 0) layer_request_keyframe(s->layers[pending]);
+        return;
+    }
+    if (want == active) {
+        // Bekleyen geçişten vazgeç; appsink henüz geçmediyse etkin katman sürer
+        g_atomic_int_compare_and_exchange(&s->pending_layer, pending, -1);
+        return;
+    }
+    g_atomic_int_set(&s->pending_layer, want);
+    s->layers[want]->last_forced_us = 0;
+    layer_request_keyframe(s->layers[want]);
 }
 
+// Alıcının bir sonraki IDR'ı alacağı katman: geçiş bekliyorsa yeni katman (IDR'ı
+// geçişi de tamamlar), yoksa etkin katman. Raporun SSRC'si eski katmanı gösterebilir.
+static SenderLayer* keyframe_layer(SenderStream *s) {
+    int pending = g_atomic_int_get(&s->pending_layer);
+    return s->layers[pending >= 0 ? pending : g_atomic_int_get(&s->active_layer)];
+}
+
+// Alıcı bir kareyi kurtaramadı: sonraki IDR'ı GOP sonunu beklemeden iste
+static void on_picture_loss(SenderStream *s) {
+    g_atomic_int_inc(&s->plis);
+    if (layer_request_keyframe(keyframe_layer(s)))
+        g_atomic_int_inc(&s->keyframes_forced);
+}
+
+// Raporun gönderildiği katman; simulcast'ta alıcı geçişten sonra bir süre eski
+// katmanın SSRC'sini bildirebilir
+static SenderLayer* layer_for_ssrc(SenderStream *s, guint32 ssrc) {
+    for (int i = 0; i < s->nlayers; i++)
+        if (s->layers[i]->ssrc == ssrc) return s->layers[i];
+    return NULL;
+}
+
+// Geri bildirim soketinde RTCP RR, PLI ya da blok NACK'i geldiğinde ana döngüden çağrılır
+static gboolean on_feedback(gint fd, GIOCondition cond, gpointer data) {
+    SenderStream *s = data;
+    guint8 buf[1500];
+    ssize_t n;
+    while ((n = recv(fd, buf, sizeof(buf), MSG_DONTWAIT)) > 0) {
+        RtcpFeedback fb;
+        SenderLayer *l;
+        if (rtcp_parse_feedback(buf, (size_t)n, &fb) < 0 ||
+            !(l = layer_for_ssrc(s, fb.media_ssrc))) continue;
+        if (fb.type == RTCP_PT_RR) {
+            fec_controller_report_loss(s->fec_ctl, fb.fraction_lost / 256.0);
+        } else if (fb.type == RTCP_PT_PSFB) {
+            on_picture_loss(s);
+        } else if (fb.type == RTCP_PT_RTPFB) {
+            // Geçmiş kapalıysa -1 döner: NACK sessizce yok sayılır
+            for (int i = 0; i < fb.nack_count; i++)
+                rtp_fec_sender_resend(l->rtp_sender, fb.nacks[i].block_id, fb.nacks[i].missing);
+        }
+    }
+    if (s->adaptive_bitrate) {
+        if (s->nlayers > 1) select_layer(s);
+        else                apply_target_bitrate(s->layers[0]);
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+static int open_feedback_socket(int port) {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) return -1;
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Hatada bütün süreç durur; EOS yalnızca o akışı bitirir
 static gboolean bus_call(GstBus *bus, GstMessage *msg, gpointer data) {
-    GMainLoop *loop = (GMainLoop *)data;
+    SenderStream *s = data;
     switch (GST_MESSAGE_TYPE(msg)) {
         case GST_MESSAGE_ERROR: {
             GError *err = NULL; gchar *dbg = NULL;
             gst_message_parse_error(msg, &err, &dbg);
-            g_printerr("ERROR: %s\n", err->message);
+            g_printerr("%sERROR: %s\n", s->label, err->message);
             if (dbg) g_printerr("Debug: %s\n", dbg);
             g_clear_error(&err); g_free(dbg);
-            g_main_loop_quit(loop);
+            g_main_loop_quit(main_loop);
             break;
         }
         case GST_MESSAGE_EOS:
-            g_print("EOS\n");
-            g_main_loop_quit(loop);
+            g_print("%sEOS\n", s->label);
+            if (!s->eos) {
+                s->eos = TRUE;
+                if (--streams_running == 0) g_main_loop_quit(main_loop);
+            }
             break;
         default: break;
     }
     return TRUE;
 }
 
-static gboolean str_contains(const char *s, const char *needle) {
-    return s && needle && strstr(s, needle) != NULL;
+// STREAM_STATUS ENTER yeni akış iş parçacığının içinden gönderilir; eşzamanlı
+// işleyici iş parçacığını akışın çekirdeklerine orada sabitler
+static GstBusSyncReply on_stream_status(GstBus *bus, GstMessage *msg, gpointer data) {
+    SenderStream *s = data;
+    if (GST_MESSAGE_TYPE(msg) != GST_MESSAGE_STREAM_STATUS) return GST_BUS_PASS;
+    GstStreamStatusType type;
+    GstElement *owner;
+    gst_message_parse_stream_status(msg, &type, &owner);
+    if (type == GST_STREAM_STATUS_TYPE_ENTER) {
+        if (stream_config_pin_thread(&s->cfg) == 0)
+            g_atomic_int_inc(&s->pinned_threads);
+        else
+            g_printerr("%sFailed to pin %s thread to CPUs %s\n", s->label,
+                       GST_ELEMENT_NAME(owner), s->cfg.cpus);
+    }
+    return GST_BUS_PASS;
 }
 
-int main(int argc, char **argv)
-{
-    gst_init(&argc, &argv);
-    GMainLoop *loop = g_main_loop_new(NULL, FALSE);
+// --duration dolduğunda ana döngüyü bitirir
+static gboolean on_duration_elapsed(gpointer data) {
+    g_main_loop_quit(main_loop);
+    return G_SOURCE_REMOVE;
+}
+
+// Hata yolunda, bir bin'e hiç eklenmemiş elemanı bırakır; eklenenler bin'leriyle gider
+static void unref_unadded(GstElement *e) {
+    if (e && !GST_OBJECT_PARENT(e)) gst_object_unref(gst_object_ref_sink(e));
+}
+
+// Elemanları sırayla bağlar (gst_element_link_many'nin dizi biçimi)
+static gboolean link_chain(GstElement **chain, int n) {
+    for (int i = 0; i + 1 < n; i++)
+        if (!gst_element_link(chain[i], chain[i + 1])) return FALSE;
+    return TRUE;
+}
+
+// İlk buffer geldiğinde dalın caps'i kesinleşmiştir: negotiated bellek yolunu raporla
+static void report_branch(SenderStream *s, const char *label, const char *branch,
+                          GstElement **path, int n) {
+    int downloads = gpu_memory_report_branch(label, branch, path, n);
+    if (downloads > 0) g_atomic_int_add(&s->downloads, downloads);
+}
+
+static GstPadProbeReturn on_first_encoded(GstPad *pad, GstPadProbeInfo *info, gpointer data) {
+    SenderLayer *l = data;
+    report_branch(l->stream, l->label, "encode", l->path, l->path_len);
+    return GST_PAD_PROBE_REMOVE;
+}
+
+static GstPadProbeReturn on_first_preview(GstPad *pad, GstPadProbeInfo *info, gpointer data) {
+    SenderStream *s = data;
+    report_branch(s, s->label, "preview", s->disp_path, s->disp_path_len);
+    return GST_PAD_PROBE_REMOVE;
+}
+
+// Encode kuyruğunun girişi: yakalamanın kare aralığından uzun boşluklar eksik kare sayılır.
+// Önizleme kuyruğu sızdırdığı için buradaki boşluklar yalnızca kaynaktan ya da encode
+// dalının kendi geri basıncından gelir.
+static GstPadProbeReturn on_encode_input(GstPad *pad, GstPadProbeInfo *info, gpointer data) {
+    SenderStream *s = data;
+    GstClockTime pts = GST_BUFFER_PTS(GST_PAD_PROBE_INFO_BUFFER(info));
+    g_atomic_int_inc(&s->enc_frames);
+    if (!GST_CLOCK_TIME_IS_VALID(pts)) return GST_PAD_PROBE_OK;
+    if (!GST_CLOCK_TIME_IS_VALID(s->enc_first_pts)) {
+        s->enc_first_pts = pts;
+    } else if (pts > s->enc_last_pts) {
+        GstClockTime frame = gst_util_uint64_scale_int(GST_SECOND, 1, MAX(s->cfg.source.fps, 1));
+        guint64 gap = (pts - s->enc_last_pts + frame / 2) / frame;
+        if (gap > 1) g_atomic_int_add(&s->enc_missing, (gint)(gap - 1));
+    }
+    s->enc_last_pts = pts;
+    return GST_PAD_PROBE_OK;
+}
+
+// Katmanın elemanları: ilk katman eski adlarını korur, diğerleri "_<sıra>" son ekini alır
+static GstElement* make_layer_element(const SenderLayer *l, const char *factory, const char *name) {
+    if (!l->index) return gst_element_factory_make(factory, name);
+    gchar *full = g_strdup_printf("%s_%d", name, l->index);
+    GstElement *e = gst_element_factory_make(factory, full);
+    g_free(full);
+    return e;
+}
 
+static gboolean layer_scaled(const SenderLayer *l) {
+    return l->height > 0 && l->height != l->stream->cfg.source.height;
+}
+
+// Katmanın encoder'ı: aile ne olursa olsun aynı gecikme profili, başlangıç bit hızı katmanın payı
+static gboolean create_layer_encoder(SenderLayer *l, const SenderSettings *set, const char *enc_name) {
+    EncoderConfig enc_cfg = set->enc;
+    enc_cfg.bitrate_kbps = l->enc_kbps;
+    enc_cfg.fps = l->stream->cfg.source.fps;
+    gchar *name = l->index ? g_strdup_printf("%s_%d", enc_name ? "gpu_enc" : "cpu_enc", l->index)
+                           : g_strdup(enc_name ? "gpu_enc" : "cpu_enc");
+    l->enc = encoder_new(enc_name, &enc_cfg, name);
+    g_free(name);
+    return l->enc != NULL;
+}
+
+/*
+ * Katmanın encode dalı: kuyruk -> [ölçekleme -> caps] -> [indirme] -> encoder -> parse -> appsink.
+ * Ölçekleme post-proc ailesiyle (yoksa videoscale) cihaz belleğinde yapılır; encoder
+ * cihaz belleğini kabul etmiyorsa indirme aynı adımdadır. Caps'te yalnızca yükseklik
+ * verilir, genişliği ölçekleyici en-boy oranını koruyarak seçer.
+ * @return GstElement* -> upstream'e bağlanacak kuyruk, NULL -> eleman/bağlantı hatası
+ */
+static GstElement* attach_layer_branch(SenderLayer *l, const SenderSettings *set,
+                                       GstElement *pipeline, const char *post_name,
+                                       GstElement **main_path, int main_len) {
+    SenderStream *s = l->stream;
+    GstElement *q_enc   = make_layer_element(l, "queue", "q_enc");
+    GstElement *parse   = make_layer_element(l, "h264parse", "parse");
+    GstElement *appsink = make_layer_element(l, "appsink", "encoder_output");
+    if (!q_enc || !parse || !appsink) {
+        g_printerr("%sFailed to create encode branch elements\n", l->label);
+        unref_unadded(q_enc);
+        unref_unadded(parse);
+        unref_unadded(appsink);
+        return NULL;
+    }
+
+    // AppSink ayarları; slice modunda h264parse erişim birimini NAL'lara böler
+    g_object_set(appsink, "emit-signals", TRUE, "sync", FALSE, NULL);
+    if (set->slice_mode) {
+        GstCaps *nal_caps = gst_caps_from_string("video/x-h264,stream-format=byte-stream,alignment=nal");
+        g_object_set(appsink, "caps", nal_caps, NULL);
+        gst_caps_unref(nal_caps);
+    }
+    g_signal_connect(appsink, "new-sample", G_CALLBACK(on_new_sample_from_sink), l);
+    gst_bin_add_many(GST_BIN(pipeline), q_enc, l->enc, parse, appsink, NULL);
+
+    GstElement *chain[8] = { q_enc };
+    int n = 1;
+    if (layer_scaled(l)) {
+        GstElement *conv = make_layer_element(l, post_name ? post_name : "videoscale", "enc_scale");
+        GstElement *cf = make_layer_element(l, "capsfilter", "enc_size");
+        if (!conv || !cf) {
+            g_printerr("%sFailed to create layer scaler\n", l->label);
+            unref_unadded(conv);
+            unref_unadded(cf);
+            return NULL;
+        }
+        const char *base = s->mem_caps && !s->enc_download ? s->mem_caps : "video/x-raw";
+        gchar *caps_str = g_strdup_printf("%s,height=%d", base, l->height);
+        GstCaps *caps = gst_caps_from_string(caps_str);
+        g_free(caps_str);
+        g_object_set(cf, "caps", caps, NULL);
+        gst_caps_unref(caps);
+        gst_bin_add_many(GST_BIN(pipeline), conv, cf, NULL);
+        chain[n++] = conv;
+        chain[n++] = cf;
+    } else if (s->enc_download) {
+        gchar *branch = l->index ? g_strdup_printf("enc_%d", l->index) : g_strdup("enc");
+        gboolean ok = gpu_memory_add_download(pipeline, post_name, branch, chain, &n);
+        g_free(branch);
+        if (!ok) return NULL;
+    }
+    chain[n++] = l->enc;
+    chain[n++] = parse;
+    chain[n++] = appsink;
+    if (!link_chain(chain, n)) {
+        g_printerr("%sFailed to link encode branch\n", l->label);
+        return NULL;
+    }
+
+    // Bellek yolu raporu: kaynaktan encoder'a
+    for (int i = 0; i < main_len; i++) l->path[l->path_len++] = main_path[i];
+    for (int i = 0; i < n - 2; i++) l->path[l->path_len++] = chain[i];
+    GstPad *appsink_pad = gst_element_get_static_pad(appsink, "sink");
+    gst_pad_add_probe(appsink_pad, GST_PAD_PROBE_TYPE_BUFFER, on_first_encoded, l, NULL);
+    gst_object_unref(appsink_pad);
+    return q_enc;
+}
+
+// Akışın GStreamer hattı: kaynak -> [post -> GPU caps] -> tee -> önizleme / encode katmanları;
+// --headless ve tek katmanda tee yoktur
+static GstElement* build_stream_pipeline(SenderStream *s, const SenderSettings *set) {
     const char *post_name = gpu_detect_and_find_factory("postproc");
     const char *enc_name  = gpu_detect_and_find_factory("encoder");
-    const char *sink_name = gpu_detect_and_find_factory("sink");
 
     // Pipeline elemanları
-    GstElement *pipeline = gst_pipeline_new("SenderEngine");
-    GstElement *src      = gst_element_factory_make("v4l2src", "src");
-    GstElement *mjpg_cf  = gst_element_factory_make("capsfilter", "mjpg_caps");
-    GstElement *dec      = NULL;
+    gchar *pipe_name = g_strdup_printf("SenderEngine-%s", s->cfg.name);
+    GstElement *pipeline = gst_pipeline_new(pipe_name);
+    g_free(pipe_name);
+    GstElement *src      = NULL;
     GstElement *post     = NULL;
-    GstElement *tee      = gst_element_factory_make("tee", "tee");
-
-    // Önizleme Dalı Elemanları
-    GstElement *q_disp   = gst_element_factory_make("queue", "q_disp");
-    GstElement *sink     = NULL;
+    GstElement *tee      = NULL;
+    GstElement *gpu_cf   = NULL;
 
-    // Yayın Dalı Elemanları
-    GstElement *q_enc    = gst_element_factory_make("queue", "q_enc");
-    GstElement *enc      = NULL;
-    GstElement *parse    = gst_element_factory_make("h264parse", "parse");
-    GstElement *appsink  = gst_element_factory_make("appsink", "encoder_output");
-
-    if (!pipeline || !src || !mjpg_cf || !tee || !q_disp || !q_enc || !parse || !appsink) {
+    if (!set->headless || s->nlayers > 1) tee = gst_element_factory_make("tee", "tee");
+    if (!pipeline || ((!set->headless || s->nlayers > 1) && !tee)) {
         g_printerr("Failed to create base elements\n");
-        return 1;
+        goto fail;
     }
-    
-    // Cihaz ayarları
-    g_object_set(src, "device", "/dev/video0", NULL);
-
-    // Kamera 720p@30 MJPG caps
-    GstCaps *mjpg_caps = gst_caps_new_simple("image/jpeg",
-        "width",  G_TYPE_INT, 1280,
-        "height", G_TYPE_INT, 720,
-        "framerate", GST_TYPE_FRACTION, 30, 1,
-        NULL);
-    g_object_set(mjpg_cf, "caps", mjpg_caps, NULL);
-    gst_caps_unref(mjpg_caps);
-
-    // GPU'ya göre JPEG decoder seçimi
-    // Not: Bu mantık, sink yerine encoder'a göre de genişletilebilir.
-    if ((post_name && str_contains(post_name, "vaapi")) ||
-        (enc_name && str_contains(enc_name, "vaapi")) ||
-        gst_element_factory_find("vaapijpegdec")) {
-        dec = gst_element_factory_make("vaapijpegdec", "dec");
-    } else if ((post_name && (str_contains(post_name, "nv") || str_contains(post_name, "cuda"))) ||
-               (enc_name && (str_contains(enc_name, "nv") || str_contains(enc_name, "cuda"))) ||
-               gst_element_factory_find("nvjpegdec")) {
-        dec = gst_element_factory_make("nvjpegdec", "dec"); // NV codec kuruluysa
-    } else {
-        dec = gst_element_factory_make("jpegdec", "dec");   // CPU fallback
+
+    // GPU'ya göre JPEG decoder seçimi (kamera ve dosya kaynağı için), tespitle birlikte bir kez yapılır
+    const char *jpeg_dec = gpu_detect_capabilities()->jpeg_decoder;
+
+    // Giriş: kamera, test deseni ya da MJPEG dosyası (--source)
+    if (!(src = media_source_new(&s->cfg.source, jpeg_dec, "src"))) {
+        g_printerr("Failed to create video source\n");
+        goto fail;
     }
-    if (!dec) { g_printerr("Failed to create JPEG decoder\n"); return 1; }
 
     // Post-proc (opsiyonel)
     if (post_name) post = gst_element_factory_make(post_name, "gpu_post");
 
-    // Sink (Önizleme) seçimi
-    if (sink_name) sink = gst_element_factory_make(sink_name, "gpu_sink");
-    if (!sink)     sink = gst_element_factory_make("autovideosink", "cpu_sink");
-    if (!sink)   { g_printerr("Failed to create sink\n"); return 1; }
-
-    // Encoder (Yayın) seçimi
-    if (enc_name) {
-        enc = gst_element_factory_make(enc_name, "gpu_enc");
-        if (g_str_has_prefix(enc_name, "vaapi")) {
-            // "film" tune ayarı genellikle daha iyi kalite verir
-            g_object_set(enc, "tune", 1, NULL); 
-        } else if (g_str_has_prefix(enc_name, "nv")) {
-             // p7 en yüksek kalite, hq yüksek kalite tune
-            g_object_set(enc, "preset", 7, "tune", 4, NULL);
+    // Önizleme dalı (sızdıran kuyruk + sink); --headless ile hiç kurulmaz
+    if (!set->headless &&
+        !(s->preview = preview_branch_new(&set->preview, gpu_detect_and_find_factory("sink"))))
+        goto fail;
+
+    // Encoder (Yayın) seçimi: her katman aynı aileden
+    for (int i = 0; i < s->nlayers; i++) {
+        if (!create_layer_encoder(s->layers[i], set, enc_name)) {
+            g_printerr("%sFailed to create encoder\n", s->layers[i]->label);
+            goto fail;
         }
-    } else {
-        enc = gst_element_factory_make("x264enc", "cpu_enc");
-        // CPU için "film" tune ayarı
-        g_object_set(enc, "tune", 4, NULL);
     }
-    if (!enc) { g_printerr("Failed to create encoder\n"); return 1; }
+    s->enc_name = enc_name;
 
-    // AppSink ayarları
-    g_object_set(appsink, "emit-signals", TRUE, "sync", FALSE, NULL);
-    g_signal_connect(appsink, "new-sample", G_CALLBACK(on_new_sample_from_sink), NULL);
+    // GPU belleği: post-proc çıkışı cihaz belleğinde tutulur ve bütün dallar oradan beslenir.
+    // Cihaz belleğini kabul etmeyen dal (örn. x264enc) açık bir indirme elemanıyla ayrılır.
+    if (!post) {
+        s->mem_note = "no GPU post-processor";
+    } else if (!set->gpu_memory) {
+        s->mem_note = "--gpu-memory=off";
+    } else {
+        const char *mem_caps = gpu_memory_caps_for(post_name);
+        gboolean enc_ok = gpu_memory_accepts(s->layers[0]->enc, mem_caps);
+        gboolean disp_ok = s->preview && gpu_memory_accepts(preview_branch_sink(s->preview), mem_caps);
+        if (enc_ok || disp_ok) {
+            s->mem_caps = mem_caps;
+            s->enc_download = !enc_ok;
+            s->disp_download = s->preview && !disp_ok;
+            gpu_cf = gst_element_factory_make("capsfilter", "gpu_caps");
+            if (!gpu_cf) { g_printerr("Failed to create gpu capsfilter\n"); goto fail; }
+            GstCaps *gpu_caps = gst_caps_from_string(mem_caps);
+            g_object_set(gpu_cf, "caps", gpu_caps, NULL);
+            gst_caps_unref(gpu_caps);
+        } else {
+            s->mem_note = "neither branch accepts GPU memory";
+        }
+    }
 
     // Pipeline’a elemanları ekle
-    if (post)
-        gst_bin_add_many(GST_BIN(pipeline), src, mjpg_cf, dec, post, tee, 
-                         q_disp, sink, q_enc, enc, parse, appsink, NULL);
-    else
-        gst_bin_add_many(GST_BIN(pipeline), src, mjpg_cf, dec, tee, 
-                         q_disp, sink, q_enc, enc, parse, appsink, NULL);
+    gst_bin_add(GST_BIN(pipeline), src);
+    if (tee)    gst_bin_add(GST_BIN(pipeline), tee);
+    if (post)   gst_bin_add(GST_BIN(pipeline), post);
+    if (gpu_cf) gst_bin_add(GST_BIN(pipeline), gpu_cf);
 
     // Elemanları bağla
-    // 1. Ana hattı tee'ye kadar bağla
-    gboolean linked = FALSE;
-    if (post)
-        linked = gst_element_link_many(src, mjpg_cf, dec, post, tee, NULL);
-    else
-        linked = gst_element_link_many(src, mjpg_cf, dec, tee, NULL);
-    if (!linked) { g_printerr("Failed to link main path to tee\n"); return 1; }
+    // 1. Ana hattı tee'ye (tee yoksa encode kuyruğuna) kadar bağla
+    GstElement *main_path[4];
+    int main_len = 0;
+    main_path[main_len++] = src;
+    if (post)   main_path[main_len++] = post;
+    if (gpu_cf) main_path[main_len++] = gpu_cf;
+    if (tee)    main_path[main_len++] = tee;
+    if (main_len > 1 && !link_chain(main_path, main_len)) {
+        g_printerr("Failed to link main path to %s%s\n", tee ? "tee" : "encoder",
+                   gpu_cf ? " with GPU memory caps" : "");
+        goto fail;
+    }
 
     // 2. Tee'den dalları bağla
-    // Önizleme Dalı
-    if (!gst_element_link_many(q_disp, sink, NULL)) {
-         g_printerr("Failed to link display branch\n"); return 1;
+    // Önizleme Dalı: ölçekleme ve indirme dalın içinde, post-proc ailesiyle yapılır
+    GstElement *disp_chain[4];
+    int disp_len = 0;
+    if (s->preview) {
+        GstElement *q_disp = preview_branch_attach(s->preview, pipeline, post_name, s->mem_caps,
+                                                   s->disp_download, disp_chain, &disp_len);
+        if (!q_disp) goto fail;
+        GstPad *tee_disp_pad = gst_element_get_request_pad(tee, "src_%u");
+        GstPad *q_disp_pad = gst_element_get_static_pad(q_disp, "sink");
+        gboolean linked = gst_pad_link(tee_disp_pad, q_disp_pad) == GST_PAD_LINK_OK;
+        gst_object_unref(tee_disp_pad);
+        gst_object_unref(q_disp_pad);
+        if (!linked) { g_printerr("Failed to link tee to display queue\n"); goto fail; }
     }
-    GstPad *tee_disp_pad = gst_element_get_request_pad(tee, "src_%u");
-    GstPad *q_disp_pad = gst_element_get_static_pad(q_disp, "sink");
-    if (gst_pad_link(tee_disp_pad, q_disp_pad) != GST_PAD_LINK_OK) {
-        g_printerr("Failed to link tee to display queue\n"); return 1;
-    }
-    gst_object_unref(tee_disp_pad);
-    gst_object_unref(q_disp_pad);
 
-    // Yayın Dalı
-    if (!gst_element_link_many(q_enc, enc, parse, appsink, NULL)) {
-        g_printerr("Failed to link encode branch\n"); return 1;
+    // Yayın Dalları: katman başına bir kuyruk; kareler tee'den bir kez çoğaltılır
+    for (int i = 0; i < s->nlayers; i++) {
+        GstElement *q_enc = attach_layer_branch(s->layers[i], set, pipeline, post_name,
+                                                main_path, main_len);
+        if (!q_enc) goto fail;
+        GstPad *q_enc_pad = gst_element_get_static_pad(q_enc, "sink");
+        gboolean linked;
+        if (tee) {
+            GstPad *tee_enc_pad = gst_element_get_request_pad(tee, "src_%u");
+            linked = gst_pad_link(tee_enc_pad, q_enc_pad) == GST_PAD_LINK_OK;
+            gst_object_unref(tee_enc_pad);
+        } else {
+            linked = gst_element_link(main_path[main_len - 1], q_enc);
+        }
+        if (!linked) {
+            g_printerr("Failed to link %s to encode queue\n", tee ? "tee" : "main path");
+            gst_object_unref(q_enc_pad);
+            goto fail;
+        }
+        if (i == 0) {
+            s->enc_first_pts = GST_CLOCK_TIME_NONE;
+            gst_pad_add_probe(q_enc_pad, GST_PAD_PROBE_TYPE_BUFFER, on_encode_input, s, NULL);
+        }
+        gst_object_unref(q_enc_pad);
     }
-    GstPad *tee_enc_pad = gst_element_get_request_pad(tee, "src_%u");
-    GstPad *q_enc_pad = gst_element_get_static_pad(q_enc, "sink");
-    if (gst_pad_link(tee_enc_pad, q_enc_pad) != GST_PAD_LINK_OK) {
-        g_printerr("Failed to link tee to encode queue\n"); return 1;
+
+    // Önizlemenin bellek yolu: kaynaktan sink'e
+    if (s->preview) {
+        for (int i = 0; i < main_len; i++) s->disp_path[s->disp_path_len++] = main_path[i];
+        for (int i = 0; i < disp_len; i++) s->disp_path[s->disp_path_len++] = disp_chain[i];
+        GstPad *preview_pad = gst_element_get_static_pad(preview_branch_sink(s->preview), "sink");
+        gst_pad_add_probe(preview_pad, GST_PAD_PROBE_TYPE_BUFFER, on_first_preview, s, NULL);
+        gst_object_unref(preview_pad);
     }
-    gst_object_unref(tee_enc_pad);
-    gst_object_unref(q_enc_pad);
 
-    // Bus & run
+    // Bus: hata/EOS ana döngüde, iş parçacığı sabitleme akış iş parçacığında
     GstBus *bus = gst_element_get_bus(pipeline);
-    gst_bus_add_watch(bus, bus_call, loop);
+    gst_bus_add_watch(bus, bus_call, s);
+    if (s->cfg.cpus) gst_bus_set_sync_handler(bus, on_stream_status, s, NULL);
     gst_object_unref(bus);
+    return pipeline;
+
+fail:
+    // Bin'e eklenenler pipeline'la gider; encoder'lar dallarına eklenmeden kalmış olabilir.
+    // Önizleme elemanlarını preview_branch_free bırakır.
+    unref_unadded(src);
+    unref_unadded(post);
+    unref_unadded(tee);
+    unref_unadded(gpu_cf);
+    for (int i = 0; i < s->nlayers; i++) {
+        unref_unadded(s->layers[i]->enc);
+        s->layers[i]->enc = NULL;
+    }
+    unref_unadded(pipeline);
+    return NULL;
+}
+
+static void sender_layer_free(SenderLayer *l) {
+    if (!l) return;
+    fec_aggregator_free(l->fec_agg);
+    slice_packer_free(l->slicer);
+    send_scheduler_free(l->scheduler);
+    rtp_fec_sender_free(l->rtp_sender);
+    g_free(l->name);
+    g_free(l->label);
+    g_free(l);
+}
+
+static void sender_stream_free(SenderStream *s) {
+    if (!s) return;
+    if (s->pipeline) {
+        gst_element_set_state(s->pipeline, GST_STATE_NULL);
+        gst_object_unref(s->pipeline);
+    }
+    preview_branch_free(s->preview);
+    for (int i = 0; i < s->nlayers; i++)
+        sender_layer_free(s->layers[i]);
+    if (s->feedback_watch) g_source_remove(s->feedback_watch);
+    if (s->feedback_fd >= 0) close(s->feedback_fd);
+    fec_controller_free(s->fec_ctl);
+    stream_config_clear(&s->cfg);
+    g_free(s->label);
+    g_free(s);
+}
+
+// Katmanın gönderim tarafı: kendi SSRC'siyle RTP soketi, NACK geçmişi, zamanlayıcı ve kurucular
+static SenderLayer* sender_layer_new(SenderStream *s, int index, gint height, guint kbps,
+                                     guint32 ssrc, const SenderSettings *set) {
+    SenderLayer *l = g_new0(SenderLayer, 1);
+    l->stream = s;
+    l->index = index;
+    l->height = height;
+    l->ssrc = ssrc;
+    l->enc_kbps = kbps;
+    if (set->layer_count > 1) {
+        l->name = g_strdup_printf("%dp", height);
+        l->label = multi_stream ? g_strdup_printf("[%s %s] ", s->cfg.name, l->name)
+                                : g_strdup_printf("[%s] ", l->name);
+    } else {
+        l->name = g_strdup("encode");
+        l->label = g_strdup(s->label);
+    }
+    fec_producer_init(&l->producer, l);
+
+    l->rtp_sender = rtp_fec_sender_new(s->cfg.host, s->cfg.port, ssrc, set->gso);
+    if (!l->rtp_sender) {
+        g_printerr("%sFailed to open UDP socket to %s:%d\n", l->label, s->cfg.host, s->cfg.port);
+        goto fail;
+    }
+    if (set->nack_history &&
+        rtp_fec_sender_enable_history(l->rtp_sender, set->nack_history,
+                                      (guint)s->cfg.bitrate_kbps * set->nack_budget_pct / 100u) < 0) {
+        g_printerr("%sFailed to allocate NACK history\n", l->label);
+        goto fail;
+    }
+    if (set->scheduled) {
+        SendSchedulerConfig sched = set->sched;
+        sched.frame_interval_us = 1000000u / (guint)MAX(s->cfg.source.fps, 1);
+        // Pacing'siz serpiştirme yalnızca kuyrukta zaten bekleyen blokları karıştırır; bloklar
+        // tek tek geldiği için pratikte arka arkaya gider. Hız verilmediyse akışın bütçesi kullanılır.
+        if (sched.interleave > 1 && !sched.rate_kbps && s->cfg.bitrate_kbps > 0)
+            sched.rate_kbps = (guint)s->cfg.bitrate_kbps;
+        if (!(l->scheduler = send_scheduler_new(&sched, l->rtp_sender))) {
+            g_printerr("%sFailed to start send scheduler\n", l->label);
+            goto fail;
+        }
+    }
+    FecAggregatorConfig agg_cfg = {
+        .capacity = (size_t)set->fec.k * max_shard_size,
+        .deadline_us = set->aggregate_us,
+    };
+    l->fec_agg = fec_aggregator_new(&agg_cfg, shard_pool, on_aggregate_ready, l);
+    if (!l->fec_agg) {
+        g_printerr("%sFailed to create FEC block aggregator\n", l->label);
+        goto fail;
+    }
+    if (set->slice_mode &&
+        !(l->slicer = slice_packer_new(agg_cfg.capacity, shard_pool, on_slice_group_ready, l))) {
+        g_printerr("%sFailed to create slice packer\n", l->label);
+        goto fail;
+    }
+    return l;
+
+fail:
+    sender_layer_free(l);
+    return NULL;
+}
+
+// Alt katmanın bit hızı ilk katmanınkinin piksel oranı kadarıdır (yarı yükseklik -> dörtte bir)
+static guint layer_bitrate(guint top_kbps, gint top_height, gint height) {
+    if (!top_height || !height || height >= top_height) return top_kbps;
+    double ratio = (double)height / top_height;
+    return MAX((guint)(top_kbps * ratio * ratio), (guint)LAYER_MIN_KBPS);
+}
+
+static SenderStream* sender_stream_new(const StreamConfig *cfg, const guint32 *ssrcs,
+                                       const SenderSettings *set) {
+    SenderStream *s = g_new0(SenderStream, 1);
+    stream_config_copy(&s->cfg, cfg);
+    s->label = multi_stream ? g_strdup_printf("[%s] ", cfg->name) : g_strdup("");
+    s->feedback_fd = -1;
+    s->pending_layer = -1;
+    if (s->cfg.feedback_port <= 0) s->cfg.feedback_port = s->cfg.port + 1;
+    media_source_get_kind(&s->cfg.source, &s->kind);
+
+    FecControllerConfig fec_cfg = set->fec;
+    fec_cfg.bitrate_kbps = s->cfg.bitrate_kbps;
+    fec_cfg.min_bitrate_kbps = set->min_bitrate_kbps > 0 ? set->min_bitrate_kbps
+                                                         : s->cfg.bitrate_kbps / 4;
+    s->fec_ctl = fec_controller_new(&fec_cfg);
+    if (!s->fec_ctl) {
+        g_printerr("%sFailed to create FEC controller\n", s->label);
+        goto fail;
+    }
+    s->adaptive_bitrate = set->adaptive_bitrate;
+    // İlk katman denetleyicinin başlangıç hedefiyle, alt katmanlar piksel oranıyla
+    guint top_kbps = (guint)fec_controller_target_bitrate(s->fec_ctl);
+    gint top_height = set->layer_heights[0] ? set->layer_heights[0] : s->cfg.source.height;
+    for (int i = 0; i < set->layer_count; i++) {
+        gint height = set->layer_heights[i];
+        SenderLayer *l = sender_layer_new(s, i, height, layer_bitrate(top_kbps, top_height, height),
+                                          ssrcs[i], set);
+        if (!l) goto fail;
+        s->layers[s->nlayers++] = l;
+    }
+    s->feedback_fd = open_feedback_socket(s->cfg.feedback_port);
+    if (s->feedback_fd < 0) {
+        g_printerr("%sFailed to bind feedback port %d\n", s->label, s->cfg.feedback_port);
+        goto fail;
+    }
+    s->feedback_watch = g_unix_fd_add(s->feedback_fd, G_IO_IN, on_feedback, s);
+
+    s->pipeline = build_stream_pipeline(s, set);
+    if (!s->pipeline) {
+        g_printerr("%sFailed to build sender pipeline\n", s->label);
+        goto fail;
+    }
+    return s;
+
+fail:
+    sender_stream_free(s);
+    return NULL;
+}
+
+static void print_stream_config(const SenderStream *s) {
+    const MediaSourceConfig *src = &s->cfg.source;
+    const char *jpeg_dec = gpu_detect_capabilities()->jpeg_decoder;
+    if (s->kind == MEDIA_SOURCE_TEST)
+        g_print(" > %sSource: test pattern %dx%d@%d\n", s->label, src->width, src->height, src->fps);
+    else if (s->kind == MEDIA_SOURCE_FILE)
+        g_print(" > %sSource: %s @%d fps%s\n", s->label, src->location, src->fps,
+                src->loop ? " (looped)" : "");
+    else
+        g_print(" > %sSource: %s %dx%d@%d MJPG\n", s->label,
+                src->device ? src->device : "/dev/video0", src->width, src->height, src->fps);
+    if (s->kind != MEDIA_SOURCE_TEST)
+        g_print(" > %sDecode on: %s\n", s->label, jpeg_dec);
+    g_print(" > %sEncode on: %s\n", s->label, s->enc_name ? s->enc_name : "x264enc (CPU fallback)");
+    const SenderLayer *top = s->layers[0];
+    if (s->nlayers == 1) {
+        g_print(" > %sBitrate: %d kbit/s budget incl. parity, encoder starts at %u kbit/s (%s)\n",
+                s->label, s->cfg.bitrate_kbps, top->enc_kbps,
+                s->adaptive_bitrate ? "follows receiver loss" : "fixed");
+    } else {
+        GString *layers = g_string_new(NULL);
+        for (int i = 0; i < s->nlayers; i++)
+            g_string_append_printf(layers, "%s%s at %u kbit/s", i ? ", " : "",
+                                   s->layers[i]->name, s->layers[i]->enc_kbps);
+        g_print(" > %sSimulcast: %s; %d kbit/s budget incl. parity, %s\n", s->label, layers->str,
+                s->cfg.bitrate_kbps, s->adaptive_bitrate ? "layer follows receiver loss, switched at keyframes"
+                                                         : "highest layer only");
+        g_string_free(layers, TRUE);
+    }
+    GString *ssrcs = g_string_new(NULL);
+    for (int i = 0; i < s->nlayers; i++) {
+        g_string_append_printf(ssrcs, "%s%08x", i ? ", " : "", s->layers[i]->ssrc);
+        if (s->nlayers > 1) g_string_append_printf(ssrcs, " (%s)", s->layers[i]->name);
+    }
+    g_print(" > %sSending RTP/FEC to %s:%d as SSRC %s (%s), feedback on port %d\n",
+            s->label, s->cfg.host, s->cfg.port, ssrcs->str,
+            top->scheduler ? "send scheduler"
+                           : rtp_fec_sender_gso_enabled(top->rtp_sender) ? "UDP GSO" : "sendmmsg",
+            s->cfg.feedback_port);
+    g_string_free(ssrcs, TRUE);
+    if (s->mem_caps) {
+        const char *kind = strstr(s->mem_caps, "memory:") + 7;
+        if (s->enc_download || s->disp_download)
+            g_print(" > %sGPU memory: %.*s after post-proc, %s branch downloads to system memory\n",
+                    s->label, (int)strcspn(kind, ")"), kind, s->enc_download ? "encode" : "preview");
+        else
+            g_print(" > %sGPU memory: %.*s on %s (zero-copy)\n", s->label,
+                    (int)strcspn(kind, ")"), kind,
+                    s->nlayers > 1 ? "every tee branch"
+                                   : s->preview ? "both tee branches" : "the encode branch");
+    } else {
+        g_print(" > %sGPU memory: off, system memory after decode (%s)\n", s->label, s->mem_note);
+    }
+    if (s->cfg.cpus)
+        g_print(" > %sStreaming threads pinned to CPUs %s\n", s->label, s->cfg.cpus);
+}
+
+static void print_branch_stats(const SenderStream *s) {
+    GstClockTime span = GST_CLOCK_TIME_IS_VALID(s->enc_first_pts) && s->enc_last_pts > s->enc_first_pts
+                        ? s->enc_last_pts - s->enc_first_pts : 0;
+    gint frames = g_atomic_int_get(&s->enc_frames);
+    g_print(" > %sEncode branch: %d frames at %.2f fps, %d missing\n", s->label, frames,
+            span ? (frames - 1) / ((double)span / GST_SECOND) : 0.0,
+            g_atomic_int_get(&s->enc_missing));
+    if (!s->preview) return;
+    PreviewStats ps;
+    preview_branch_get_stats(s->preview, &ps);
+    g_print(" > %sPreview branch: %llu frames shown, %llu dropped (queue full), %llu decimated\n",
+            s->label, (unsigned long long)ps.frames, (unsigned long long)ps.dropped,
+            (unsigned long long)ps.decimated);
+}
+
+// Katmanın gönderim özeti; simulcast'ta her satır katman adıyla etiketlenir
+static void print_layer_stats(const SenderLayer *l, gboolean aggregating) {
+    if (l->stream->nlayers > 1)
+        g_print(" > %sLayer: %d buffers sent while active, %d skipped, encoder %u kbit/s\n",
+                l->label, g_atomic_int_get(&l->units_sent), g_atomic_int_get(&l->units_skipped),
+                l->enc_kbps);
+    const FecAggregatorStats *as = &l->agg_stats;
+    if (aggregating)
+        g_print(" > %sAggregator: %llu of %llu access units packed into %llu blocks "
+                "(%llu full, %llu deadline, %llu bypass flushes)\n", l->label,
+                (unsigned long long)as->units_aggregated, (unsigned long long)as->units_in,
+                (unsigned long long)as->blocks_out, (unsigned long long)as->flush_full,
+                (unsigned long long)as->flush_deadline, (unsigned long long)as->flush_bypass);
+    const SlicePackerStats *sl = &l->slice_stats;
+    if (sl->units)
+        g_print(" > %sSlices: %llu access units sent as %llu slice groups from %llu NALs "
+                "(%llu copied; %llu closed by marker, %llu by next timestamp)\n", l->label,
+                (unsigned long long)sl->units, (unsigned long long)sl->groups_out,
+                (unsigned long long)sl->nals_in, (unsigned long long)sl->nals_copied,
+                (unsigned long long)sl->close_marker, (unsigned long long)sl->close_timestamp);
+    const SendSchedulerStats *sc = &l->sched_stats;
+    if (sc->blocks)
+        g_print(" > %sScheduler: %llu blocks, %llu packets (%llu interleaved), %llu pacing waits, "
+                "%llu rate boosts, %llu queue-full waits, max queue %u blocks, "
+                "delay p99 %.3f ms, max %.3f ms\n",
+                l->label, (unsigned long long)sc->blocks, (unsigned long long)sc->packets,
+                (unsigned long long)sc->interleaved, (unsigned long long)sc->paced_waits,
+                (unsigned long long)sc->boosts, (unsigned long long)sc->queue_full,
+                sc->max_queue, sc->delay.p99 / 1e6, sc->max_delay_us / 1000.0);
+    RtpFecSenderStats ss;
+    rtp_fec_sender_get_stats(l->rtp_sender, &ss);
+    g_print(" > %sRTP: %llu packets, %llu bytes in %llu blocks, %llu syscalls (%llu GSO), %llu errors\n",
+            l->label, (unsigned long long)ss.packets, (unsigned long long)ss.bytes,
+            (unsigned long long)ss.blocks, (unsigned long long)ss.syscalls,
+            (unsigned long long)ss.gso_sends, (unsigned long long)ss.errors);
+}
+
+static void print_stream_stats(const SenderStream *s, gboolean aggregating) {
+    guint64 submitted = 0, dropped = 0;
+    RtpFecResendStats rs = { 0 };
+    for (int i = 0; i < s->nlayers; i++) {
+        const SenderLayer *l = s->layers[i];
+        RtpFecResendStats lrs;
+        rtp_fec_sender_get_resend_stats(l->rtp_sender, &lrs);
+        submitted += l->producer.submitted;
+        dropped += l->producer.dropped;
+        rs.requests += lrs.requests;
+        rs.packets += lrs.packets;
+        rs.bytes += lrs.bytes;
+        rs.misses += lrs.misses;
+        rs.throttled += lrs.throttled;
+    }
+    g_print(" > %sFEC producer: %llu queued, %llu dropped; %d streaming threads pinned\n",
+            s->label, (unsigned long long)submitted, (unsigned long long)dropped,
+            g_atomic_int_get(&s->pinned_threads));
+    g_print(" > %sSystem-memory downloads after negotiation: %d\n",
+            s->label, g_atomic_int_get(&s->downloads));
+    print_branch_stats(s);
+    TelSummary cap;
+    tel_hist_summary(&s->capture_latency, &cap);
+    if (cap.count)
+        g_print(" > %sCapture to appsink: p50 %.3f ms, p99 %.3f ms, max %.3f ms over %llu buffers\n",
+                s->label, cap.p50 / 1e6, cap.p99 / 1e6, cap.max / 1e6,
+                (unsigned long long)cap.count);
+    for (int i = 0; i < s->nlayers; i++)
+        print_layer_stats(s->layers[i], aggregating);
+    if (g_atomic_int_get(&s->plis) || rs.requests)
+        g_print(" > %sFeedback: %d PLIs -> %d keyframes forced; NACKs for %llu blocks -> "
+                "%llu shards resent (%llu bytes), %llu expired, %llu over budget\n", s->label,
+                g_atomic_int_get(&s->plis), g_atomic_int_get(&s->keyframes_forced),
+                (unsigned long long)rs.requests, (unsigned long long)rs.packets,
+                (unsigned long long)rs.bytes, (unsigned long long)rs.misses,
+                (unsigned long long)rs.throttled);
+    FecControllerState cs;
+    fec_controller_get_state(s->fec_ctl, &cs);
+    g_print(" > %sFEC controller: loss %.2f%%, r=%d (IDR r=%d) after %llu reports\n",
+            s->label, cs.loss_estimate * 100.0, cs.r_delta, cs.r_keyframe, cs.reports);
+    if (s->nlayers > 1)
+        g_print(" > %sSimulcast: %d layer switches, sending %s at exit\n", s->label,
+                g_atomic_int_get(&s->layer_switches),
+                s->layers[g_atomic_int_get(&s->active_layer)]->name);
+    else
+        g_print(" > %sEncoder bitrate: %u kbit/s after %u changes\n",
+                s->label, s->layers[0]->enc_kbps, s->layers[0]->bitrate_changes);
+}
+
+// Akışlar ve katmanlar aynı alıcıya gidebilir; SSRC'ler süreç içinde benzersiz olmalı.
+// taken: kurulmakta olan akışın önceki katmanlarına verilenler.
+static guint32 unique_ssrc(GPtrArray *streams, const guint32 *taken, int ntaken) {
+    for (;;) {
+        guint32 ssrc = g_random_int();
+        gboolean used = ssrc == 0;
+        for (int i = 0; i < ntaken && !used; i++)
+            used = taken[i] == ssrc;
+        for (guint i = 0; i < streams->len && !used; i++) {
+            SenderStream *s = streams->pdata[i];
+            for (int j = 0; j < s->nlayers && !used; j++)
+                used = s->layers[j]->ssrc == ssrc;
+        }
+        if (!used) return ssrc;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    gboolean copy_shards = FALSE;
+    gboolean no_gso = FALSE;
+    gchar *dest_host = NULL;
+    gint dest_port = 5004;
+    gint mtu = RTP_FEC_DEFAULT_MTU;
+    gint feedback_port = 0;
+    gboolean fixed_fec = FALSE;
+    gchar *drop_policy = NULL;
+    FecPipelineConfig pipe_cfg;
+    fec_pipeline_default_config(&pipe_cfg);
+    gint fec_workers = (gint)pipe_cfg.workers;
+    gint fec_queue = (gint)pipe_cfg.queue_depth;
+    gint aggregate_ms = 0;
+    gboolean slice_mode = FALSE;
+    SendSchedulerConfig sched_cfg;
+    send_scheduler_default_config(&sched_cfg);
+    gint interleave = 1;
+    gint pacing_kbps = 0;
+    gint pacing_burst = (gint)sched_cfg.burst_packets;
+    gboolean headless = FALSE;
+    gint duration = 0;
+    gint stats_interval = STATS_INTERVAL_SEC;
+    gint metrics_port = 0;
+    gchar *streams_file = NULL;
+    gchar *cpus = NULL;
+    gint numa_node = -1;
+    gchar *gpu_memory = NULL;
+    gchar *enc_profile = NULL;
+    gint bitrate = 0;
+    gint min_bitrate = 0;
+    gint gop = 0;
+    gboolean fixed_bitrate = FALSE;
+    gint nack_history = 0;
+    gint nack_budget = NACK_BUDGET_PCT;
+    gchar *simulcast = NULL;
+    EncoderConfig enc_cfg;
+    encoder_default_config(&enc_cfg);
+    MediaSourceConfig src_cfg;
+    media_source_default_config(&src_cfg);
+    PreviewConfig preview_cfg;
+    preview_default_config(&preview_cfg);
+    FecControllerConfig fec_cfg;
+    fec_controller_default_config(&fec_cfg);
+    fec_cfg.k = K_DATA_SHARDS;
+    fec_cfg.r_max = R_PARITY_SHARDS;
+    GOptionEntry entries[] = {
+        { "copy-shards", 0, 0, G_OPTION_ARG_NONE, &copy_shards,
+          "Copy every data shard instead of pointing into the mapped buffer", NULL },
+        { "host", 'h', 0, G_OPTION_ARG_STRING, &dest_host,
+          "Receiver address (default 127.0.0.1)", "HOST" },
+        { "port", 'p', 0, G_OPTION_ARG_INT, &dest_port,
+          "Receiver UDP port (default 5004)", "PORT" },
+        { "mtu", 0, 0, G_OPTION_ARG_INT, &mtu,
+          "Path MTU used to size shards (default 1500)", "BYTES" },
+        { "no-gso", 0, 0, G_OPTION_ARG_NONE, &no_gso,
+          "Disable UDP GSO and send with plain sendmmsg batches", NULL },
+        { "fec-k", 'k', 0, G_OPTION_ARG_INT, &fec_cfg.k,
+          "Data shards per FEC block (default 10)", "K" },
+        { "fec-r-min", 0, 0, G_OPTION_ARG_INT, &fec_cfg.r_min,
+          "Parity shards on a clean link (default 1)", "R" },
+        { "fec-r-max", 'r', 0, G_OPTION_ARG_INT, &fec_cfg.r_max,
+          "Parity shards on a lossy link and before feedback (default 4)", "R" },
+        { "fixed-fec", 0, 0, G_OPTION_ARG_NONE, &fixed_fec,
+          "Always send fec-r-max parity shards, ignore receiver feedback", NULL },
+        { "feedback-port", 0, 0, G_OPTION_ARG_INT, &feedback_port,
+          "Local UDP port for receiver RTCP reports (default port + 1)", "PORT" },
+        { "fec-workers", 0, 0, G_OPTION_ARG_INT, &fec_workers,
+          "FEC encoder threads, shared by all streams (default 2)", "N" },
+        { "fec-queue", 0, 0, G_OPTION_ARG_INT, &fec_queue,
+          "Access units queued per FEC thread (default 8)", "N" },
+        { "drop-policy", 0, 0, G_OPTION_ARG_STRING, &drop_policy,
+          "When the FEC queue is full: block (backpressure) or drop (skip to next IDR)", "POLICY" },
+        { "aggregate-ms", 0, 0, G_OPTION_ARG_INT, &aggregate_ms,
+          "Pack small P-frames into shared FEC blocks, waiting at most MS (default 0, off)", "MS" },
+        { "slice-mode", 0, 0, G_OPTION_ARG_NONE, &slice_mode,
+          "Send FEC blocks per slice group as NAL units leave the parser", NULL },
+        { "interleave", 0, 0, G_OPTION_ARG_INT, &interleave,
+          "Interleave the shards of up to N queued FEC blocks (default 1, off); paces at --bitrate "
+          "unless --pacing-kbps is given", "N" },
+        { "pacing-kbps", 0, 0, G_OPTION_ARG_INT, &pacing_kbps,
+          "Pace packets with a token bucket at this rate per stream (default 0, off)", "KBPS" },
+        { "pacing-burst", 0, 0, G_OPTION_ARG_INT, &pacing_burst,
+          "Packets the token bucket may send back-to-back (default 16)", "N" },
+        { "headless", 0, 0, G_OPTION_ARG_NONE, &headless,
+          "No local preview: the tee and the preview branch are not built", NULL },
+        { "duration", 0, 0, G_OPTION_ARG_INT, &duration,
+          "Stop after this many seconds (default 0, run until EOS)", "SEC" },
+        { "stats-interval", 0, 0, G_OPTION_ARG_INT, &stats_interval,
+          "Print the pipeline summary every SEC seconds (default 5, 0 = only at exit)", "SEC" },
+        { "metrics-port", 0, 0, G_OPTION_ARG_INT, &metrics_port,
+          "Serve Prometheus metrics on 127.0.0.1:PORT/metrics (default 0, off)", "PORT" },
+        { "stats-file", 0, 0, G_OPTION_ARG_FILENAME, &stats_file,
+          "Rewrite Prometheus metrics to this file every second", "FILE" },
+        { "streams", 0, 0, G_OPTION_ARG_FILENAME, &streams_file,
+          "Run one pipeline per [stream] group of this key file", "FILE" },
+        { "cpus", 0, 0, G_OPTION_ARG_STRING, &cpus,
+          "Pin streaming threads to these CPUs, e.g. 0-3,8", "LIST" },
+        { "numa-node", 0, 0, G_OPTION_ARG_INT, &numa_node,
+          "Pin streaming threads to the CPUs of this NUMA node", "N" },
+        { "encoder-profile", 0, 0, G_OPTION_ARG_STRING, &enc_profile,
+          "Encoder tuning: low-latency or quality (default low-latency)", "PROFILE" },
+        { "bitrate", 0, 0, G_OPTION_ARG_INT, &bitrate,
+          "Send budget per stream including FEC parity, kbit/s (default 4000)", "KBPS" },
+        { "min-bitrate", 0, 0, G_OPTION_ARG_INT, &min_bitrate,
+          "Lowest encoder bitrate under congestion, kbit/s (default bitrate / 4)", "KBPS" },
+        { "gop", 0, 0, G_OPTION_ARG_INT, &gop,
+          "Frames between keyframes (default 1 s, 2 s for quality)", "FRAMES" },
+        { "intra-refresh", 0, 0, G_OPTION_ARG_NONE, &enc_cfg.intra_refresh,
+          "low-latency x264enc: rolling intra refresh instead of periodic IDRs "
+          "(no keyframes except on PLI; not with --drop-policy=drop or --simulcast)", NULL },
+        { "fixed-bitrate", 0, 0, G_OPTION_ARG_NONE, &fixed_bitrate,
+          "Keep the encoder at its start bitrate, ignore receiver loss", NULL },
+        { "nack-history", 0, 0, G_OPTION_ARG_INT, &nack_history,
+          "Keep the last N FEC blocks to resend shards the receiver NACKs (default 0, off)", "N" },
+        { "nack-budget", 0, 0, G_OPTION_ARG_INT, &nack_budget,
+          "Resend at most this share of the bitrate budget, percent (default 10)", "PCT" },
+        { "simulcast", 0, 0, G_OPTION_ARG_STRING, &simulcast,
+          "Encode one layer per height from the same capture, e.g. 720,360,180; "
+          "send the highest the receiver's loss allows", "HEIGHTS" },
+        { "gpu-memory", 0, 0, G_OPTION_ARG_STRING, &gpu_memory,
+          "Keep frames in GPU memory after post-processing: auto or off (default auto)", "MODE" },
+        G_OPTION_ENTRY_NULL
+    };
+    GError *opt_err = NULL;
+    GOptionContext *opt_ctx = g_option_context_new("- FEC sender");
+    g_option_context_add_main_entries(opt_ctx, entries, NULL);
+    media_source_add_options(opt_ctx, &src_cfg);
+    preview_add_options(opt_ctx, &preview_cfg);
+    g_option_context_add_group(opt_ctx, gst_init_get_option_group());
+    if (!g_option_context_parse(opt_ctx, &argc, &argv, &opt_err)) {
+        g_printerr("Option parsing failed: %s\n", opt_err->message);
+        g_clear_error(&opt_err);
+        g_option_context_free(opt_ctx);
+        return 1;
+    }
+    g_option_context_free(opt_ctx);
+    zero_copy_shards = !copy_shards;
+    fec_cfg.adaptive = !fixed_fec;
+    if (drop_policy && strcmp(drop_policy, "drop") == 0) {
+        pipe_cfg.policy = FEC_QUEUE_DROP;
+    } else if (drop_policy && strcmp(drop_policy, "block") != 0) {
+        g_printerr("Unknown drop policy '%s' (use block or drop)\n", drop_policy);
+        return 1;
+    }
+    g_free(drop_policy);
+    if (encoder_profile_from_name(enc_profile, &enc_cfg.profile) < 0) {
+        g_printerr("Unknown encoder profile '%s' (use low-latency or quality)\n", enc_profile);
+        return 1;
+    }
+    g_free(enc_profile);
+    if (gop > 0) enc_cfg.gop = (guint)gop;
+    sched_cfg.interleave = interleave > 1 ? (unsigned int)interleave : 1;
+    sched_cfg.rate_kbps = pacing_kbps > 0 ? (unsigned int)pacing_kbps : 0;
+    sched_cfg.burst_packets = pacing_burst > 0 ? (unsigned int)pacing_burst : 1;
+    if (slice_mode && aggregate_ms > 0) {
+        g_printerr("--slice-mode and --aggregate-ms cannot be combined\n");
+        return 1;
+    }
+    if ((preview_cfg.width > 0) != (preview_cfg.height > 0)) {
+        g_printerr("--preview-width and --preview-height must be given together\n");
+        return 1;
+    }
+    if (gpu_memory && strcmp(gpu_memory, "auto") != 0 && strcmp(gpu_memory, "off") != 0) {
+        g_printerr("Unknown GPU memory mode '%s' (use auto or off)\n", gpu_memory);
+        return 1;
+    }
+    // --simulcast: 2..MAX_LAYERS azalan, çift yükseklik; verilmezse tek katman kaynak boyutunda
+    gint layer_heights[MAX_LAYERS] = { 0 };
+    gint layer_count = 1;
+    if (simulcast) {
+        gchar **parts = g_strsplit(simulcast, ",", -1);
+        guint nparts = g_strv_length(parts);
+        gboolean ok = nparts >= 2 && nparts <= MAX_LAYERS;
+        for (guint i = 0; ok && i < nparts; i++) {
+            gchar *end = NULL;
+            gint64 h = g_ascii_strtoll(g_strstrip(parts[i]), &end, 10);
+            ok = end && *end == '\0' && h >= 16 && h % 2 == 0 && h <= 4320 &&
+                 (i == 0 || h < layer_heights[i - 1]);
+            if (ok) layer_heights[i] = (gint)h;
+        }
+        g_strfreev(parts);
+        if (!ok) {
+            g_printerr("Invalid --simulcast '%s' (2 to %d even heights, highest first)\n",
+                       simulcast, MAX_LAYERS);
+            return 1;
+        }
+        layer_count = (gint)nparts;
+        g_free(simulcast);
+    }
+    // Bu ikisi periyodik IDR bekler; intra-refresh'te IDR yalnızca PLI ile gelir
+    if (enc_cfg.intra_refresh && (pipe_cfg.policy == FEC_QUEUE_DROP || layer_count > 1)) {
+        g_printerr("--intra-refresh cannot be combined with %s (both wait for periodic IDRs)\n",
+                   layer_count > 1 ? "--simulcast" : "--drop-policy=drop");
+        return 1;
+    }
+    pipe_cfg.workers = fec_workers > 0 ? (unsigned int)fec_workers : 1;
+    pipe_cfg.queue_depth = fec_queue > 0 ? (unsigned int)fec_queue : 1;
+    if (numa_node >= 0 && !cpus && !(cpus = stream_config_numa_cpus(numa_node))) {
+        g_printerr("NUMA node %d not found\n", numa_node);
+        return 1;
+    }
+
+    // Komut satırı tek akışı tanımlar; --streams dosyasındaki gruplar bunu temel alır
+    StreamConfig defaults = {
+        .name = "main",
+        .source = src_cfg,
+        .host = dest_host ? dest_host : "127.0.0.1",
+        .port = dest_port,
+        .feedback_port = feedback_port,
+        .bitrate_kbps = bitrate > 0 ? bitrate : (gint)enc_cfg.bitrate_kbps,
+        .cpus = cpus,
+    };
+    GPtrArray *stream_cfgs;
+    if (streams_file) {
+        GError *err = NULL;
+        stream_cfgs = stream_config_load(streams_file, &defaults, &err);
+        if (!stream_cfgs) {
+            g_printerr("Failed to load streams from %s: %s\n", streams_file, err->message);
+            g_clear_error(&err);
+            return 1;
+        }
+    } else {
+        stream_cfgs = g_ptr_array_new();
+        g_ptr_array_add(stream_cfgs, &defaults);
+    }
+    multi_stream = streams_file != NULL;
+
+    gst_init(&argc, &argv);
+    main_loop = g_main_loop_new(NULL, FALSE);
+
+    // FEC tablolarını akış başlamadan önce hazırla (denetleyicinin seçebileceği her r için);
+    // tablolar ve işçiler bütün akışlarca paylaşılır
+    FecController *probe_ctl = fec_controller_new(&fec_cfg);
+    if (!probe_ctl) {
+        g_printerr("Failed to create FEC controller\n");
+        return 1;
+    }
+    fec_controller_get_config(probe_ctl, &fec_cfg);
+    fec_controller_free(probe_ctl);
+    for (int r = fec_cfg.r_min; r <= fec_cfg.r_max; r++) {
+        if (!fec_encoder_get(fec_cfg.k, r)) {
+            g_printerr("Failed to initialize FEC encoder tables (k=%d, r=%d)\n", fec_cfg.k, r);
+            return 1;
+        }
+    }
+    // Kuyruktaki ve işçideki her iş kendi slab'larını tutar
+    // (her katmanın kurucusu ayrıca bir hazırlık slab'ı tutar)
+    unsigned int pool_slabs = pipe_cfg.workers * (pipe_cfg.queue_depth + 1) * SLABS_PER_JOB +
+                              2 * stream_cfgs->len * (unsigned int)layer_count;
+    shard_pool = shard_pool_new(MAX(pool_slabs, SHARD_POOL_SLABS));
+    if (!shard_pool) {
+        g_printerr("Failed to create shard pool\n");
+        return 1;
+    }
+    max_shard_size = rtp_fec_max_shard_size(mtu);
+    pipe_cfg.zero_copy = zero_copy_shards;
+    pipe_cfg.max_shard_size = max_shard_size;
+    fec_pipe = fec_pipeline_new(&pipe_cfg, shard_pool, on_fec_job_ready, NULL);
+    if (!fec_pipe) {
+        g_printerr("Failed to start FEC worker threads\n");
+        return 1;
+    }
+
+    SenderSettings settings = {
+        .fec = fec_cfg,
+        .aggregate_us = aggregate_ms > 0 ? (guint)aggregate_ms * 1000u : 0,
+        .slice_mode = slice_mode,
+        .sched = sched_cfg,
+        .scheduled = sched_cfg.interleave > 1 || sched_cfg.rate_kbps > 0,
+        .gso = !no_gso,
+        .headless = headless,
+        .preview = preview_cfg,
+        .gpu_memory = !gpu_memory || strcmp(gpu_memory, "off") != 0,
+        .enc = enc_cfg,
+        .min_bitrate_kbps = min_bitrate,
+        .adaptive_bitrate = !fixed_bitrate,
+        .nack_history = nack_history > 0 ? (guint)nack_history : 0,
+        .nack_budget_pct = nack_budget > 0 ? (guint)nack_budget : 1,
+        .layer_count = layer_count,
+    };
+    memcpy(settings.layer_heights, layer_heights, sizeof(layer_heights));
+    g_free(gpu_memory);
+    GPtrArray *streams = g_ptr_array_new();
+    for (guint i = 0; i < stream_cfgs->len; i++) {
+        guint32 ssrcs[MAX_LAYERS];
+        for (int j = 0; j < settings.layer_count; j++)
+            ssrcs[j] = unique_ssrc(streams, ssrcs, j);
+        SenderStream *s = sender_stream_new(stream_cfgs->pdata[i], ssrcs, &settings);
+        if (!s) return 1;
+        g_ptr_array_add(streams, s);
+    }
+    g_ptr_array_unref(stream_cfgs);
+    streams_running = (gint)streams->len;
+
+    if (metrics_port > 0 || stats_file) {
+        telemetry = telemetry_new();
+        if (!telemetry || telemetry_add_collector(telemetry, collect_sender_metrics, streams) < 0) {
+            g_printerr("Failed to create telemetry exporter\n");
+            return 1;
+        }
+        if (metrics_port > 0 && telemetry_serve(telemetry, metrics_port) < 0) {
+            g_printerr("Failed to listen for metrics on 127.0.0.1:%d\n", metrics_port);
+            return 1;
+        }
+        if (stats_file) g_timeout_add_seconds(STATS_FILE_INTERVAL_SEC, on_stats_file_timer, NULL);
+    }
+    if (stats_interval > 0) g_timeout_add_seconds((guint)stats_interval, on_stats_timer, NULL);
+    if (duration > 0) g_timeout_add_seconds(duration, on_duration_elapsed, NULL);
+
+    for (guint i = 0; i < streams->len; i++)
+        gst_element_set_state(((SenderStream *)streams->pdata[i])->pipeline, GST_STATE_PLAYING);
+    if (multi_stream)
+        g_print("Starting %u sender pipelines from %s...\n", streams->len, streams_file);
+    else
+        g_print("Starting sender pipeline %s...\n", headless ? "headless" : "with local preview");
+    for (guint i = 0; i < streams->len; i++)
+        print_stream_config(streams->pdata[i]);
+    g_print(" > FEC shards: %s, max shard %d bytes\n",
+            zero_copy_shards ? "zero-copy (tail shard copied)" : "copied", max_shard_size);
+    g_print(" > Encoder profile: %s%s\n", encoder_profile_name(enc_cfg.profile),
+            enc_cfg.intra_refresh ? ", intra refresh (IDR only on PLI)" : "");
+    g_print(" > FEC: k=%d, r=%d..%d (%s)\n", fec_cfg.k, fec_cfg.r_min, fec_cfg.r_max,
+            fec_cfg.adaptive ? "adaptive" : "fixed");
+    g_print(" > FEC workers: %u x %u queued access units (%s when full)%s\n",
+            pipe_cfg.workers, pipe_cfg.queue_depth,
+            pipe_cfg.policy == FEC_QUEUE_DROP ? "drop to next IDR" : "block",
+            multi_stream ? ", shared by all streams" : "");
+    if (aggregate_ms > 0)
+        g_print(" > Aggregating small P-frames up to %zu bytes / %d ms per block\n",
+                (size_t)fec_cfg.k * max_shard_size, aggregate_ms);
+    if (settings.scheduled && sched_cfg.rate_kbps)
+        g_print(" > Send scheduler: interleave %u blocks, pacing at %u kbit/s (burst %u packets), "
+                "queue drains within a frame\n",
+                sched_cfg.interleave, sched_cfg.rate_kbps, sched_cfg.burst_packets);
+    else if (settings.scheduled)
+        g_print(" > Send scheduler: interleave %u blocks, pacing at the stream bitrate (burst %u packets), "
+                "queue drains within a frame\n", sched_cfg.interleave, sched_cfg.burst_packets);
+    if (!headless) {
+        gchar *size = preview_cfg.width > 0
+                      ? g_strdup_printf("%dx%d", preview_cfg.width, preview_cfg.height)
+                      : g_strdup("source size");
+        gchar *rate = preview_cfg.fps > 0 ? g_strdup_printf("at most %d fps", preview_cfg.fps)
+                                          : g_strdup("source rate");
+        g_print(" > Preview: leaky %d-frame queue, %s, %s\n",
+                MAX(preview_cfg.queue_frames, 1), size, rate);
+        g_free(size);
+        g_free(rate);
+    }
+    if (slice_mode)
+        g_print(" > Slice mode: NAL-aligned output, slice groups up to %zu bytes per FEC job\n",
+                (size_t)fec_cfg.k * max_shard_size);
+    g_print(" > Feedback: PLI forces a keyframe (at most every %d ms)", PLI_MIN_INTERVAL_US / 1000);
+    if (settings.nack_history)
+        g_print(", NACKs resend from the last %u blocks within %u%% of the bitrate\n",
+                settings.nack_history, settings.nack_budget_pct);
+    else
+        g_print(", NACKs ignored (--nack-history)\n");
+    if (metrics_port > 0)
+        g_print(" > Metrics: http://127.0.0.1:%d/metrics\n", metrics_port);
+    if (stats_file)
+        g_print(" > Stats file: %s, rewritten every %d s\n", stats_file, STATS_FILE_INTERVAL_SEC);
+    g_main_loop_run(main_loop);
+
+    g_print("Stopping sender pipeline%s.\n", multi_stream ? "s" : "");
+    for (guint i = 0; i < streams->len; i++) {
+        SenderStream *s = streams->pdata[i];
+        gst_element_set_state(s->pipeline, GST_STATE_NULL);
+    }
+
+    // Bekleyen toplanmış blokları, açık slice gruplarını ve kuyruktaki işleri gönderip işçileri durdur;
+    // havuz ve soketler ondan sonra kapanır
+    for (guint i = 0; i < streams->len; i++) {
+        SenderStream *s = streams->pdata[i];
+        for (int j = 0; j < s->nlayers; j++) {
+            SenderLayer *l = s->layers[j];
+            fec_aggregator_flush(l->fec_agg);
+            fec_aggregator_get_stats(l->fec_agg, &l->agg_stats);
+            fec_aggregator_free(l->fec_agg);
+            l->fec_agg = NULL;
+            if (l->slicer) {
+                slice_packer_flush(l->slicer);
+                slice_packer_get_stats(l->slicer, &l->slice_stats);
+                slice_packer_free(l->slicer);
+                l->slicer = NULL;
+            }
+        }
+    }
+    fec_pipeline_stop(fec_pipe);
+    for (guint i = 0; i < streams->len; i++) {
+        // Zamanlayıcı kuyruğundaki paketler de gönderilsin; RTP sayaçları ondan sonra okunur
+        SenderStream *s = streams->pdata[i];
+        for (int j = 0; j < s->nlayers; j++) {
+            SenderLayer *l = s->layers[j];
+            if (!l->scheduler) continue;
+            send_scheduler_stop(l->scheduler);
+            send_scheduler_get_stats(l->scheduler, &l->sched_stats);
+        }
+    }
+    print_pipeline_stats();
+
+    // Son değerler dosyaya yazılır; uç nokta iş hattı ve akışlar bırakılmadan kapanır
+    if (stats_file) telemetry_write_file(telemetry, stats_file);
+    telemetry_free(telemetry);
+    telemetry = NULL;
+    fec_pipeline_free(fec_pipe);
+
+    ShardPoolStats ps;
+    shard_pool_get_stats(shard_pool, &ps);
+    g_print(" > Shard pool: %llu hits, %llu misses (%llu grows, %llu overflows), slab %llu bytes\n",
+            (unsigned long long)ps.hits, (unsigned long long)ps.misses,
+            (unsigned long long)ps.grows, (unsigned long long)ps.overflows,
+            (unsigned long long)ps.slab_bytes);
+    for (guint i = 0; i < streams->len; i++) {
+        print_stream_stats(streams->pdata[i], aggregate_ms > 0);
+        sender_stream_free(streams->pdata[i]);
+    }
+    g_ptr_array_unref(streams);
+    g_main_loop_unref(main_loop);
+    g_free(dest_host);
+    g_free(cpus);
+    g_free(streams_file);
+    g_free(stats_file);
+    media_source_config_clear(&src_cfg);
 
-    gst_element_set_state(pipeline, GST_STATE_PLAYING);
-    g_print("Starting sender pipeline with local preview...\n");
-    const char *dec_name_str = gst_element_factory_find("vaapijpegdec") ? "vaapijpegdec" :
-                               (gst_element_factory_find("nvjpegdec") ? "nvjpegdec" : "jpegdec (CPU)");
-    g_print(" > Decode on: %s\n", dec_name_str);
-    g_print(" > Encode on: %s\n", enc_name ? enc_name : "x264enc (CPU fallback)");
-    g_main_loop_run(loop);
-
-    g_print("Stopping sender pipeline.\n");
-    gst_element_set_state(pipeline, GST_STATE_NULL);
-    gst_object_unref(pipeline);
-    g_main_loop_unref(loop);
+    shard_pool_free(shard_pool);
+    fec_codec_shutdown();
     return 0;
 }
@@ -0,0 +1,146 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "shard_pool.h"
+
+#define SLAB_NONE UINT32_MAX
+
+struct ShardPool {
+    ShardSlab         *slabs;
+    unsigned int       max_slabs;
+    /* Serbest liste başı: alt 32 bit index + 1 (0 = boş), üst 32 bit ABA etiketi */
+    _Atomic uint64_t   free_head;
+    _Atomic uint64_t   slab_bytes;
+
+    _Atomic uint64_t   hits;
+    _Atomic uint64_t   misses;
+    _Atomic uint64_t   grows;
+    _Atomic uint64_t   overflows;
+    _Atomic uint64_t   in_use;
+};
+
+static size_t round_up_align(size_t n) {
+    return (n + SHARD_POOL_ALIGN - 1) & ~(size_t)(SHARD_POOL_ALIGN - 1);
+}
+
+static void free_list_push(ShardPool *pool, ShardSlab *slab) {
+    uint64_t head = atomic_load_explicit(&pool->free_head, memory_order_relaxed);
+    uint64_t next;
+    do {
+        atomic_store_explicit(&slab->next, (uint32_t)head, memory_order_relaxed);
+        next = (((head >> 32) + 1) << 32) | (uint64_t)(slab->index + 1);
+    } while (!atomic_compare_exchange_weak_explicit(&pool->free_head, &head, next,
+                                                    memory_order_release, memory_order_relaxed));
+}
+
+static ShardSlab* free_list_pop(ShardPool *pool) {
+    uint64_t head = atomic_load_explicit(&pool->free_head, memory_order_acquire);
+    uint64_t next;
+    ShardSlab *slab;
+    do {
+        uint32_t idx = (uint32_t)head;
+        if (idx == 0) return NULL;
+        slab = &pool->slabs[idx - 1];
+        uint32_t after = atomic_load_explicit(&slab->next, memory_order_relaxed);
+        next = (((head >> 32) + 1) << 32) | after;
+    } while (!atomic_compare_exchange_weak_explicit(&pool->free_head, &head, next,
+                                                    memory_order_acquire, memory_order_acquire));
+    return slab;
+}
+
+/* Havuzun en büyük blok boyutunu günceller ve ayrılacak boyutu döndürür */
+static size_t pool_target_bytes(ShardPool *pool, size_t bytes) {
+    bytes = round_up_align(bytes);
+    uint64_t cur = atomic_load_explicit(&pool->slab_bytes, memory_order_relaxed);
+    while (cur < bytes &&
+           !atomic_compare_exchange_weak_explicit(&pool->slab_bytes, &cur, bytes,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+    return cur > bytes ? (size_t)cur : bytes;
+}
+
+ShardPool* shard_pool_new(unsigned int max_slabs) {
+    if (max_slabs == 0) return NULL;
+    ShardPool *pool = calloc(1, sizeof(*pool));
+    if (!pool) return NULL;
+    pool->slabs = calloc(max_slabs, sizeof(ShardSlab));
+    if (!pool->slabs) {
+        free(pool);
+        return NULL;
+    }
+    pool->max_slabs = max_slabs;
+    for (unsigned int i = 0; i < max_slabs; i++) {
+        pool->slabs[i].index = i;
+        free_list_push(pool, &pool->slabs[i]);
+    }
+    return pool;
+}
+
+void shard_pool_free(ShardPool *pool) {
+    if (!pool) return;
+    for (unsigned int i = 0; i < pool->max_slabs; i++)
+        free(pool->slabs[i].base);
+    free(pool->slabs);
+    free(pool);
+}
+
+ShardSlab* shard_pool_acquire(ShardPool *pool, size_t bytes) {
+    ShardSlab *slab = free_list_pop(pool);
+
+    if (!slab) {
+        // Tüm slab'lar dışarıda: bu blok için geçici bir slab ver
+        slab = calloc(1, sizeof(*slab));
+        if (!slab) return NULL;
+        slab->index = SLAB_NONE;
+        slab->capacity = round_up_align(bytes);
+        if (posix_memalign((void **)&slab->base, SHARD_POOL_ALIGN, slab->capacity)) {
+            free(slab);
+            return NULL;
+        }
+        atomic_fetch_add_explicit(&pool->overflows, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&pool->misses, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&pool->in_use, 1, memory_order_relaxed);
+        return slab;
+    }
+
+    if (slab->base && slab->capacity >= bytes) {
+        atomic_fetch_add_explicit(&pool->hits, 1, memory_order_relaxed);
+    } else {
+        // İlk kullanım ya da daha büyük bir keyframe: en büyük boyuta göre yeniden ayır
+        size_t target = pool_target_bytes(pool, bytes);
+        if (slab->base)
+            atomic_fetch_add_explicit(&pool->grows, 1, memory_order_relaxed);
+        free(slab->base);
+        slab->base = NULL;
+        slab->capacity = 0;
+        if (posix_memalign((void **)&slab->base, SHARD_POOL_ALIGN, target)) {
+            slab->base = NULL;
+            free_list_push(pool, slab);
+            return NULL;
+        }
+        slab->capacity = target;
+        atomic_fetch_add_explicit(&pool->misses, 1, memory_order_relaxed);
+    }
+    atomic_fetch_add_explicit(&pool->in_use, 1, memory_order_relaxed);
+    return slab;
+}
+
+void shard_pool_release(ShardPool *pool, ShardSlab *slab) {
+    if (!slab) return;
+    atomic_fetch_sub_explicit(&pool->in_use, 1, memory_order_relaxed);
+    if (slab->index == SLAB_NONE) {
+        free(slab->base);
+        free(slab);
+        return;
+    }
+    free_list_push(pool, slab);
+}
+
+void shard_pool_get_stats(ShardPool *pool, ShardPoolStats *out) {
+    out->hits       = atomic_load_explicit(&pool->hits, memory_order_relaxed);
+    out->misses     = atomic_load_explicit(&pool->misses, memory_order_relaxed);
+    out->grows      = atomic_load_explicit(&pool->grows, memory_order_relaxed);
+    out->overflows  = atomic_load_explicit(&pool->overflows, memory_order_relaxed);
+    out->in_use     = atomic_load_explicit(&pool->in_use, memory_order_relaxed);
+    out->slab_bytes = atomic_load_explicit(&pool->slab_bytes, memory_order_relaxed);
+}
@@ -0,0 +1,154 @@
+#include <stdlib.h>
+#include <string.h>
+#include "slice_packer.h"
+#include "fec_pipeline.h"
+
+#define NAL_TYPE_IDR 5
+#define NAL_TYPE_SPS 7
+
+/* Slab'ın ilk satırında grubun sahiplik kaydı, verisi hemen ardından */
+typedef struct {
+    ShardSlab *slab;
+    ShardPool *pool;
+} SliceBatch;
+
+struct SlicePacker {
+    size_t capacity;
+    ShardPool *pool;
+    SlicePackerEmit emit;
+    void *user;
+
+    /* Açık erişim birimi */
+    int in_unit;
+    uint32_t unit_ts;
+    int unit_key;
+    int groups;                     /* birimden gönderilmiş grup */
+
+    /* Bekleyen grup: slab'a kopyalanmış NAL'lar ya da kopyalanmadan tutulan tek NAL */
+    int pending;
+    const unsigned char *data;
+    size_t len;
+    void *owner;
+    void (*release_owner)(void *owner);
+    SliceBatch *batch;              /* NULL -> owner'ı tutulan NAL */
+
+    SlicePackerStats stats;
+};
+
+static void batch_release(void *owner) {
+    SliceBatch *b = owner;
+    shard_pool_release(b->pool, b->slab);
+}
+
+/* Byte-stream NAL'ının tipi (başlangıç kodundan sonraki ilk byte); bulunamazsa -1 */
+static int nal_type(const unsigned char *p, size_t len) {
+    for (size_t i = 0; i + 3 < len && i < 8; i++) {
+        if (p[i] == 0 && p[i + 1] == 0 && p[i + 2] == 1) return p[i + 3] & 0x1f;
+    }
+    return -1;
+}
+
+/* Bekleyen grubu emit'e devreder */
+static void emit_pending(SlicePacker *sp, int last) {
+    if (!sp->pending) return;
+    int flags = (sp->groups ? FEC_JOB_NOT_FIRST : 0) | (last ? 0 : FEC_JOB_NOT_LAST);
+    sp->pending = 0;
+    sp->groups++;
+    sp->stats.groups_out++;
+    sp->emit(sp->user, sp->data, sp->len, sp->owner, sp->release_owner,
+             sp->unit_ts, sp->unit_key, flags);
+}
+
+static void close_unit(SlicePacker *sp) {
+    emit_pending(sp, 1);
+    sp->in_unit = 0;
+}
+
+static int batch_open(SlicePacker *sp) {
+    ShardSlab *slab = shard_pool_acquire(sp->pool, SHARD_POOL_ALIGN + sp->capacity);
+    if (!slab) return -1;
+    SliceBatch *b = (SliceBatch *)slab->base;
+    b->slab = slab;
+    b->pool = sp->pool;
+    sp->pending = 1;
+    sp->batch = b;
+    sp->data = slab->base + SHARD_POOL_ALIGN;
+    sp->len = 0;
+    sp->owner = b;
+    sp->release_owner = batch_release;
+    return 0;
+}
+
+SlicePacker* slice_packer_new(size_t capacity, ShardPool *pool, SlicePackerEmit emit, void *user) {
+    SlicePacker *sp = calloc(1, sizeof(*sp));
+    if (!sp) return NULL;
+    sp->capacity = capacity;
+    sp->pool = pool;
+    sp->emit = emit;
+    sp->user = user;
+    return sp;
+}
+
+void slice_packer_free(SlicePacker *sp) {
+    if (!sp) return;
+    slice_packer_flush(sp);
+    free(sp);
+}
+
+void slice_packer_push(SlicePacker *sp, const unsigned char *data, size_t len,
+                       void *owner, void (*release_owner)(void *owner),
+                       uint32_t rtp_timestamp, int au_end) {
+    sp->stats.nals_in++;
+
+    // MARKER gelmediyse önceki birim ancak yeni zaman damgasıyla kapanabilir
+    if (sp->in_unit && rtp_timestamp != sp->unit_ts) {
+        sp->stats.close_timestamp++;
+        close_unit(sp);
+    }
+    if (!sp->in_unit) {
+        sp->in_unit = 1;
+        sp->unit_ts = rtp_timestamp;
+        sp->unit_key = 0;
+        sp->groups = 0;
+        sp->stats.units++;
+    }
+    int type = nal_type(data, len);
+    if (type == NAL_TYPE_IDR || type == NAL_TYPE_SPS) sp->unit_key = 1;
+
+    // Bekleyen grup bu NAL'ı alamıyorsa birimin son grubu değildir: gönder.
+    // Büyük NAL yalnızca açık slab'a sığıyorsa kopyalanır (SPS/PPS + IDR slice).
+    int copy = len <= sp->capacity / 2 ||
+               (sp->pending && sp->batch && sp->len + len <= sp->capacity);
+    if (sp->pending && (!copy || !sp->batch || sp->len + len > sp->capacity))
+        emit_pending(sp, 0);
+    if (copy && !sp->pending && batch_open(sp) < 0)
+        copy = 0;
+
+    if (copy) {
+        memcpy((unsigned char *)sp->batch + SHARD_POOL_ALIGN + sp->len, data, len);
+        sp->len += len;
+        sp->stats.nals_copied++;
+        if (release_owner) release_owner(owner);
+    } else {
+        // Büyük slice (ya da slab yok): buffer'ın kendisi grup olur
+        sp->pending = 1;
+        sp->batch = NULL;
+        sp->data = data;
+        sp->len = len;
+        sp->owner = owner;
+        sp->release_owner = release_owner;
+    }
+
+    if (au_end) {
+        sp->stats.close_marker++;
+        close_unit(sp);
+    }
+}
+
+void slice_packer_flush(SlicePacker *sp) {
+    if (sp->in_unit) close_unit(sp);
+}
+
+void slice_packer_get_stats(const SlicePacker *sp, SlicePackerStats *out) {
+    *out = sp->stats;
+}
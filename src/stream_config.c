@@ -0,0 +1,204 @@
+#define _GNU_SOURCE
+#include <gst/gst.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "stream_config.h"
+
+#define NUMA_NODE_DIR "/sys/devices/system/node"
+
+void stream_config_copy(StreamConfig *dst, const StreamConfig *src) {
+    *dst = *src;
+    dst->name = g_strdup(src->name);
+    dst->host = g_strdup(src->host);
+    dst->cpus = g_strdup(src->cpus);
+    dst->source.kind_name = g_strdup(src->source.kind_name);
+    dst->source.device = g_strdup(src->source.device);
+    dst->source.location = g_strdup(src->source.location);
+}
+
+void stream_config_clear(StreamConfig *cfg) {
+    g_clear_pointer(&cfg->name, g_free);
+    g_clear_pointer(&cfg->host, g_free);
+    g_clear_pointer(&cfg->cpus, g_free);
+    media_source_config_clear(&cfg->source);
+}
+
+static void stream_config_free(gpointer p) {
+    stream_config_clear(p);
+    g_free(p);
+}
+
+/* "0-3,8,10-11" -> CPU kümesi; boş ya da sınır dışı liste geçersizdir */
+static int parse_cpu_list(const char *spec, cpu_set_t *set) {
+    CPU_ZERO(set);
+    const char *p = spec;
+    while (*p) {
+        char *end;
+        long lo = strtol(p, &end, 10);
+        if (end == p || lo < 0) return -1;
+        long hi = lo;
+        p = end;
+        if (*p == '-') {
+            hi = strtol(p + 1, &end, 10);
+            if (end == p + 1 || hi < lo) return -1;
+            p = end;
+        }
+        if (hi >= CPU_SETSIZE) return -1;
+        for (long c = lo; c <= hi; c++) CPU_SET((int)c, set);
+        while (*p == ',' || *p == ' ') p++;
+    }
+    return CPU_COUNT(set) > 0 ? 0 : -1;
+}
+
+gchar* stream_config_numa_cpus(int node) {
+    gchar *path = g_strdup_printf(NUMA_NODE_DIR "/node%d/cpulist", node);
+    gchar *list = NULL;
+    if (node >= 0 && g_file_get_contents(path, &list, NULL, NULL)) {
+        g_strstrip(list);
+        if (!*list) g_clear_pointer(&list, g_free);
+    }
+    g_free(path);
+    return list;
+}
+
+int stream_config_pin_thread(const StreamConfig *cfg) {
+    if (!cfg->cpus) return 0;
+    cpu_set_t set;
+    if (parse_cpu_list(cfg->cpus, &set) < 0) return -1;
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0 ? 0 : -1;
+}
+
+/* Anahtar varsa değeri okur; yoksa mevcut (varsayılan) değer kalır */
+static gboolean read_string(GKeyFile *kf, const char *group, const char *key,
+                            gchar **out, GError **error) {
+    if (!g_key_file_has_key(kf, group, key, NULL)) return TRUE;
+    gchar *v = g_key_file_get_string(kf, group, key, error);
+    if (!v) return FALSE;
+    g_free(*out);
+    *out = v;
+    return TRUE;
+}
+
+static gboolean read_int(GKeyFile *kf, const char *group, const char *key,
+                         gint *out, GError **error) {
+    if (!g_key_file_has_key(kf, group, key, NULL)) return TRUE;
+    GError *err = NULL;
+    gint v = g_key_file_get_integer(kf, group, key, &err);
+    if (err) {
+        g_propagate_error(error, err);
+        return FALSE;
+    }
+    *out = v;
+    return TRUE;
+}
+
+static gboolean read_bool(GKeyFile *kf, const char *group, const char *key,
+                          gboolean *out, GError **error) {
+    if (!g_key_file_has_key(kf, group, key, NULL)) return TRUE;
+    GError *err = NULL;
+    gboolean v = g_key_file_get_boolean(kf, group, key, &err);
+    if (err) {
+        g_propagate_error(error, err);
+        return FALSE;
+    }
+    *out = v;
+    return TRUE;
+}
+
+static gboolean load_group(GKeyFile *kf, const char *group, StreamConfig *sc, GError **error) {
+    MediaSourceConfig *src = &sc->source;
+    gint numa_node = -1;
+    if (!read_string(kf, group, "source", &src->kind_name, error) ||
+        !read_string(kf, group, "device", &src->device, error) ||
+        !read_string(kf, group, "location", &src->location, error) ||
+        !read_int(kf, group, "width", &src->width, error) ||
+        !read_int(kf, group, "height", &src->height, error) ||
+        !read_int(kf, group, "fps", &src->fps, error) ||
+        !read_bool(kf, group, "loop", &src->loop, error) ||
+        !read_string(kf, group, "host", &sc->host, error) ||
+        !read_int(kf, group, "port", &sc->port, error) ||
+        !read_int(kf, group, "feedback-port", &sc->feedback_port, error) ||
+        !read_int(kf, group, "bitrate", &sc->bitrate_kbps, error) ||
+        !read_string(kf, group, "cpus", &sc->cpus, error) ||
+        !read_int(kf, group, "numa-node", &numa_node, error))
+        return FALSE;
+
+    MediaSourceKind kind;
+    if (media_source_get_kind(src, &kind) < 0) {
+        g_set_error(error, G_KEY_FILE_ERROR, G_KEY_FILE_ERROR_INVALID_VALUE,
+                    "[%s]: unknown source '%s' or missing location", group,
+                    src->kind_name ? src->kind_name : "");
+        return FALSE;
+    }
+    if (sc->port <= 0 || sc->port > 65535 || sc->feedback_port < 0 || sc->feedback_port > 65535) {
+        g_set_error(error, G_KEY_FILE_ERROR, G_KEY_FILE_ERROR_INVALID_VALUE,
+                    "[%s]: port out of range", group);
+        return FALSE;
+    }
+    if (sc->bitrate_kbps <= 0) {
+        g_set_error(error, G_KEY_FILE_ERROR, G_KEY_FILE_ERROR_INVALID_VALUE,
+                    "[%s]: bitrate must be positive", group);
+        return FALSE;
+    }
+    // Açık CPU listesi NUMA düğümünden önceliklidir
+    if (numa_node >= 0 && !g_key_file_has_key(kf, group, "cpus", NULL)) {
+        g_free(sc->cpus);
+        sc->cpus = stream_config_numa_cpus(numa_node);
+        if (!sc->cpus) {
+            g_set_error(error, G_KEY_FILE_ERROR, G_KEY_FILE_ERROR_INVALID_VALUE,
+                        "[%s]: NUMA node %d not found", group, numa_node);
+            return FALSE;
+        }
+    }
+    cpu_set_t set;
+    if (sc->cpus && parse_cpu_list(sc->cpus, &set) < 0) {
+        g_set_error(error, G_KEY_FILE_ERROR, G_KEY_FILE_ERROR_INVALID_VALUE,
+                    "[%s]: invalid cpu list '%s'", group, sc->cpus);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+GPtrArray* stream_config_load(const char *path, const StreamConfig *defaults,
+                              GError **error) {
+    GKeyFile *kf = g_key_file_new();
+    if (!g_key_file_load_from_file(kf, path, G_KEY_FILE_NONE, error)) {
+        g_key_file_free(kf);
+        return NULL;
+    }
+
+    GPtrArray *streams = g_ptr_array_new_with_free_func(stream_config_free);
+    gchar **groups = g_key_file_get_groups(kf, NULL);
+    gboolean ok = TRUE;
+    for (gchar **g = groups; ok && *g; g++) {
+        // "[stream]" ya da "[stream ad]"; diğer gruplar yok sayılır
+        if (strcmp(*g, "stream") != 0 && !g_str_has_prefix(*g, "stream ")) continue;
+
+        StreamConfig *sc = g_new0(StreamConfig, 1);
+        stream_config_copy(sc, defaults);
+        g_free(sc->name);
+        const char *name = *g + strlen("stream");
+        while (*name == ' ') name++;
+        sc->name = *name ? g_strdup(name) : g_strdup_printf("stream%u", streams->len);
+        sc->port = defaults->port + (gint)streams->len * STREAM_PORT_STRIDE;
+        sc->feedback_port = 0;
+        g_ptr_array_add(streams, sc);
+        ok = load_group(kf, *g, sc, error);
+    }
+    g_strfreev(groups);
+    g_key_file_free(kf);
+
+    if (ok && streams->len == 0) {
+        g_set_error(error, G_KEY_FILE_ERROR, G_KEY_FILE_ERROR_GROUP_NOT_FOUND,
+                    "%s: no [stream] groups", path);
+        ok = FALSE;
+    }
+    if (!ok) {
+        g_ptr_array_unref(streams);
+        return NULL;
+    }
+    return streams;
+}
@@ -0,0 +1,276 @@
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include "telemetry.h"
+
+#define MAX_COLLECTORS 16
+#define POLL_MS        200      /* durdurma işaretini kontrol aralığı */
+
+typedef struct {
+    TelCollector fn;
+    void *user;
+} Collector;
+
+struct Telemetry {
+    Collector collectors[MAX_COLLECTORS];
+    int ncollectors;
+    pthread_mutex_t render_lock;    /* HTTP ve dosya yazımı aynı anda toplayıcı çağırmasın */
+
+    int listen_fd;
+    pthread_t thread;
+    int thread_started;
+    atomic_int stop;
+};
+
+/* --- Histogram --- */
+
+static unsigned int bucket_index(uint64_t v) {
+    if (v < TEL_HIST_SUB) return (unsigned int)v;
+    unsigned int e = 63u - (unsigned int)__builtin_clzll(v);
+    if (e > TEL_HIST_MAX_EXP) return TEL_HIST_BUCKETS - 1;
+    unsigned int sub = (unsigned int)(v >> (e - TEL_HIST_SUB_BITS)) & (TEL_HIST_SUB - 1);
+    return (e - TEL_HIST_SUB_BITS + 1) * TEL_HIST_SUB + sub;
+}
+
+/* Kutunun en büyük değeri (HDR "highest equivalent value") */
+static uint64_t bucket_value(unsigned int idx) {
+    if (idx < TEL_HIST_SUB) return idx;
+    unsigned int e = idx / TEL_HIST_SUB + TEL_HIST_SUB_BITS - 1;
+    uint64_t sub = idx % TEL_HIST_SUB;
+    uint64_t width = 1ull << (e - TEL_HIST_SUB_BITS);
+    return ((TEL_HIST_SUB + sub) << (e - TEL_HIST_SUB_BITS)) + width - 1;
+}
+
+void tel_hist_record(TelHistogram *h, uint64_t value) {
+    atomic_fetch_add_explicit(&h->counts[bucket_index(value)], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&h->count, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&h->sum, value, memory_order_relaxed);
+    uint64_t cur = atomic_load_explicit(&h->max, memory_order_relaxed);
+    while (value > cur && !atomic_compare_exchange_weak_explicit(&h->max, &cur, value,
+                                                                 memory_order_relaxed,
+                                                                 memory_order_relaxed)) {
+    }
+}
+
+void tel_hist_summary(const TelHistogram *h, TelSummary *out) {
+    static const double q[4] = { 0.50, 0.90, 0.99, 0.999 };
+    uint64_t *dst[4] = { &out->p50, &out->p90, &out->p99, &out->p999 };
+    memset(out, 0, sizeof(*out));
+
+    // Sayım kutulardan yeniden toplanır: okuma sırasında gelen kayıtlar tutarsızlık yaratmaz
+    uint64_t counts[TEL_HIST_BUCKETS], total = 0;
+    for (unsigned int i = 0; i < TEL_HIST_BUCKETS; i++) {
+        counts[i] = atomic_load_explicit(&h->counts[i], memory_order_relaxed);
+        total += counts[i];
+    }
+    out->count = total;
+    out->sum = atomic_load_explicit(&h->sum, memory_order_relaxed);
+    out->max = atomic_load_explicit(&h->max, memory_order_relaxed);
+    if (!total) return;
+
+    uint64_t seen = 0;
+    int qi = 0;
+    for (unsigned int i = 0; i < TEL_HIST_BUCKETS && qi < 4; i++) {
+        seen += counts[i];
+        while (qi < 4 && seen >= (uint64_t)(q[qi] * (double)total + 0.5) && seen) {
+            uint64_t v = bucket_value(i);
+            *dst[qi++] = v < out->max ? v : out->max;
+        }
+    }
+    while (qi < 4) *dst[qi++] = out->max;
+}
+
+/* --- Yazıcı --- */
+
+static void tel_printf(TelWriter *w, const char *fmt, ...) {
+    for (;;) {
+        size_t room = w->cap - w->len;
+        va_list ap;
+        va_start(ap, fmt);
+        int n = w->data ? vsnprintf(w->data + w->len, room, fmt, ap) : -1;
+        va_end(ap);
+        if (n >= 0 && (size_t)n < room) {
+            w->len += (size_t)n;
+            return;
+        }
+        size_t cap = w->cap ? w->cap * 2 : 16 * 1024;
+        while (n >= 0 && cap - w->len <= (size_t)n) cap *= 2;
+        char *p = realloc(w->data, cap);
+        if (!p) return;
+        w->data = p;
+        w->cap = cap;
+    }
+}
+
+void tel_write_family(TelWriter *w, const char *name, const char *type, const char *help) {
+    tel_printf(w, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+void tel_write_value(TelWriter *w, const char *name, const char *labels, double value) {
+    if (labels && *labels) tel_printf(w, "%s{%s} %.9g\n", name, labels, value);
+    else                   tel_printf(w, "%s %.9g\n", name, value);
+}
+
+void tel_write_summary(TelWriter *w, const char *name, const char *labels,
+                       const TelSummary *s, double scale) {
+    const char *sep = labels && *labels ? "," : "";
+    const char *l = labels ? labels : "";
+    tel_printf(w, "%s{%s%squantile=\"0.5\"} %.9g\n", name, l, sep, s->p50 * scale);
+    tel_printf(w, "%s{%s%squantile=\"0.9\"} %.9g\n", name, l, sep, s->p90 * scale);
+    tel_printf(w, "%s{%s%squantile=\"0.99\"} %.9g\n", name, l, sep, s->p99 * scale);
+    tel_printf(w, "%s{%s%squantile=\"0.999\"} %.9g\n", name, l, sep, s->p999 * scale);
+    tel_printf(w, "%s{%s%squantile=\"1\"} %.9g\n", name, l, sep, s->max * scale);
+    if (*l) {
+        tel_printf(w, "%s_sum{%s} %.9g\n", name, l, s->sum * scale);
+        tel_printf(w, "%s_count{%s} %llu\n", name, l, (unsigned long long)s->count);
+    } else {
+        tel_printf(w, "%s_sum %.9g\n", name, s->sum * scale);
+        tel_printf(w, "%s_count %llu\n", name, (unsigned long long)s->count);
+    }
+}
+
+/* --- Dışa aktarıcı --- */
+
+Telemetry* telemetry_new(void) {
+    Telemetry *tel = calloc(1, sizeof(*tel));
+    if (!tel) return NULL;
+    tel->listen_fd = -1;
+    pthread_mutex_init(&tel->render_lock, NULL);
+    return tel;
+}
+
+void telemetry_free(Telemetry *tel) {
+    if (!tel) return;
+    atomic_store(&tel->stop, 1);
+    if (tel->thread_started) pthread_join(tel->thread, NULL);
+    if (tel->listen_fd >= 0) close(tel->listen_fd);
+    pthread_mutex_destroy(&tel->render_lock);
+    free(tel);
+}
+
+int telemetry_add_collector(Telemetry *tel, TelCollector fn, void *user) {
+    if (tel->ncollectors >= MAX_COLLECTORS) return -1;
+    tel->collectors[tel->ncollectors].fn = fn;
+    tel->collectors[tel->ncollectors].user = user;
+    tel->ncollectors++;
+    return 0;
+}
+
+char* telemetry_render(Telemetry *tel, size_t *len) {
+    TelWriter w = { 0 };
+    pthread_mutex_lock(&tel->render_lock);
+    for (int i = 0; i < tel->ncollectors; i++)
+        tel->collectors[i].fn(tel->collectors[i].user, &w);
+    pthread_mutex_unlock(&tel->render_lock);
+    if (!w.data) {
+        w.data = calloc(1, 1);
+        if (!w.data) return NULL;
+    }
+    if (len) *len = w.len;
+    return w.data;
+}
+
+static void write_all(int fd, const char *p, size_t len) {
+    while (len > 0) {
+        ssize_t n = send(fd, p, len, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return;
+        p += n;
+        len -= (size_t)n;
+    }
+}
+
+/* Tek bağlantı: isteği okur, /metrics ise metni, değilse 404 döner */
+static void serve_client(Telemetry *tel, int fd) {
+    char req[1024];
+    struct pollfd pfd = { .fd = fd, .events = POLLIN };
+    ssize_t n = poll(&pfd, 1, 1000) > 0 ? recv(fd, req, sizeof(req) - 1, 0) : -1;
+    if (n <= 0) return;
+    req[n] = '\0';
+
+    if (strncmp(req, "GET /metrics", 12) != 0 && strncmp(req, "GET / ", 6) != 0) {
+        static const char nf[] = "HTTP/1.0 404 Not Found\r\nContent-Length: 0\r\n\r\n";
+        write_all(fd, nf, sizeof(nf) - 1);
+        return;
+    }
+    size_t len = 0;
+    char *body = telemetry_render(tel, &len);
+    if (!body) return;
+    char head[160];
+    int hl = snprintf(head, sizeof(head),
+                      "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\n"
+                      "Content-Length: %zu\r\n\r\n", len);
+    write_all(fd, head, (size_t)hl);
+    write_all(fd, body, len);
+    free(body);
+}
+
+static void* serve_main(void *arg) {
+    Telemetry *tel = arg;
+    while (!atomic_load(&tel->stop)) {
+        struct pollfd pfd = { .fd = tel->listen_fd, .events = POLLIN };
+        if (poll(&pfd, 1, POLL_MS) <= 0) continue;
+        int fd = accept(tel->listen_fd, NULL, NULL);
+        if (fd < 0) continue;
+        serve_client(tel, fd);
+        close(fd);
+    }
+    return NULL;
+}
+
+int telemetry_serve(Telemetry *tel, int port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, 8) < 0) {
+        close(fd);
+        return -1;
+    }
+    tel->listen_fd = fd;
+    if (pthread_create(&tel->thread, NULL, serve_main, tel) != 0) {
+        close(fd);
+        tel->listen_fd = -1;
+        return -1;
+    }
+    tel->thread_started = 1;
+    return 0;
+}
+
+int telemetry_write_file(Telemetry *tel, const char *path) {
+    size_t len = 0;
+    char *body = telemetry_render(tel, &len);
+    if (!body) return -1;
+    size_t plen = strlen(path);
+    char *tmp = malloc(plen + 5);
+    if (!tmp) {
+        free(body);
+        return -1;
+    }
+    memcpy(tmp, path, plen);
+    memcpy(tmp + plen, ".tmp", 5);
+
+    int rc = -1;
+    FILE *f = fopen(tmp, "w");
+    if (f) {
+        size_t wrote = fwrite(body, 1, len, f);
+        if (fclose(f) == 0 && wrote == len && rename(tmp, path) == 0) rc = 0;
+        else unlink(tmp);
+    }
+    free(tmp);
+    free(body);
+    return rc;
+}
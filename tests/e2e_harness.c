@@ -0,0 +1,148 @@
+// e2e_harness.c
+// Kamerasız uçtan uca yük testi: N adet sender (test deseni, pencere yok) ve
+// receiver (fakesink) çiftini loopback üzerinde --duration süresince çalıştırır.
+// Her akış için fps, yakalama -> yeniden kurma gecikmesi ve süreç başına CPU
+// kullanımını CSV olarak basar.
+// Derleme: gcc -O2 tests/e2e_harness.c -o tests/e2e_harness
+// Kullanım: tests/e2e_harness [-n streams] [-d seconds] [-s src/sender] [-r src/receiver]
+//                             [-- extra sender options]
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+
+#define BASE_PORT   5004
+#define PORT_STRIDE 10      /* her akış: port (RTP) ve port + 1 (RTCP) */
+#define MAX_STREAMS 64
+#define MAX_ARGS    64
+
+typedef struct {
+    pid_t sender, receiver;
+    FILE *out;                      /* receiver stdout: silinmiş geçici dosya */
+    double sender_cpu, receiver_cpu;
+    char stats[512];
+} Stream;
+
+static double rusage_seconds(const struct rusage *ru) {
+    return ru->ru_utime.tv_sec + ru->ru_utime.tv_usec / 1e6 +
+           ru->ru_stime.tv_sec + ru->ru_stime.tv_usec / 1e6;
+}
+
+static pid_t spawn(char **argv, int out_fd) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        int null_fd = open("/dev/null", O_WRONLY);
+        dup2(out_fd >= 0 ? out_fd : null_fd, STDOUT_FILENO);
+        execv(argv[0], argv);
+        perror(argv[0]);
+        _exit(127);
+    }
+    return pid;
+}
+
+/* "stats: key=value ..." satırından bir değeri okur */
+static double stat_value(const char *stats, const char *key) {
+    const char *p = strstr(stats, key);
+    if (!p) return 0.0;
+    return atof(p + strlen(key) + 1);
+}
+
+int main(int argc, char **argv) {
+    int streams = 1, seconds = 10, opt;
+    const char *sender = "src/sender", *receiver = "src/receiver";
+    while ((opt = getopt(argc, argv, "n:d:s:r:")) != -1) {
+        switch (opt) {
+            case 'n': streams = atoi(optarg); break;
+            case 'd': seconds = atoi(optarg); break;
+            case 's': sender = optarg; break;
+            case 'r': receiver = optarg; break;
+            default:
+                fprintf(stderr, "usage: %s [-n streams] [-d seconds] [-s sender] [-r receiver]"
+                        " [-- sender options]\n", argv[0]);
+                return 2;
+        }
+    }
+    if (streams < 1 || streams > MAX_STREAMS || seconds < 1) {
+        fprintf(stderr, "streams must be 1..%d and seconds >= 1\n", MAX_STREAMS);
+        return 2;
+    }
+
+    Stream st[MAX_STREAMS];
+    memset(st, 0, sizeof(st));
+    char port[MAX_STREAMS][16], rx_secs[16], tx_secs[16];
+    snprintf(rx_secs, sizeof(rx_secs), "%d", seconds + 2);
+    snprintf(tx_secs, sizeof(tx_secs), "%d", seconds);
+
+    // Önce alıcılar: göndericinin ilk IDR'ı kaybolmasın. Çıktı bir pipe'a değil geçici
+    // dosyaya gider: çalışırken kimse okumadığından dolan pipe alıcıyı bekletirdi
+    for (int i = 0; i < streams; i++) {
+        snprintf(port[i], sizeof(port[i]), "%d", BASE_PORT + i * PORT_STRIDE);
+        if (!(st[i].out = tmpfile())) { perror("tmpfile"); return 1; }
+        char *rx_argv[] = { (char *)receiver, "--headless", "--latency", "--port", port[i],
+                            "--duration", rx_secs, NULL };
+        st[i].receiver = spawn(rx_argv, fileno(st[i].out));
+    }
+    usleep(500 * 1000);
+
+    for (int i = 0; i < streams; i++) {
+        char *tx_argv[MAX_ARGS] = { (char *)sender, "--source", "test", "--headless",
+                                    "--host", "127.0.0.1", "--port", port[i],
+                                    "--duration", tx_secs };
+        int n = 10;
+        for (int a = optind; a < argc && n < MAX_ARGS - 1; a++) tx_argv[n++] = argv[a];
+        tx_argv[n] = NULL;
+        st[i].sender = spawn(tx_argv, -1);
+    }
+
+    // Çocukları bekle, her birinin CPU süresini al
+    struct timeval t0, t1;
+    gettimeofday(&t0, NULL);
+    int pending = streams * 2, failures = 0;
+    while (pending > 0) {
+        int status;
+        struct rusage ru;
+        pid_t pid = wait4(-1, &status, 0, &ru);
+        if (pid < 0) break;
+        pending--;
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) failures++;
+        for (int i = 0; i < streams; i++) {
+            if (pid == st[i].sender)   st[i].sender_cpu = rusage_seconds(&ru);
+            if (pid == st[i].receiver) st[i].receiver_cpu = rusage_seconds(&ru);
+        }
+    }
+    gettimeofday(&t1, NULL);
+
+    printf("stream,port,frames,fps,latency_avg_ms,latency_p50_ms,latency_p99_ms,"
+           "sender_cpu_pct,receiver_cpu_pct\n");
+    for (int i = 0; i < streams; i++) {
+        // Alıcı çıktısından "stats:" satırını bul (çıktının boyu sınırsız)
+        char *buf = NULL;
+        size_t cap = 0;
+        int found = 0;
+        rewind(st[i].out);
+        while (getline(&buf, &cap, st[i].out) != -1) {
+            const char *line = strstr(buf, "stats:");
+            if (!line) continue;
+            size_t l = strcspn(line, "\n");
+            if (l >= sizeof(st[i].stats)) l = sizeof(st[i].stats) - 1;
+            memcpy(st[i].stats, line, l);
+            st[i].stats[l] = '\0';
+            found = 1;
+        }
+        free(buf);
+        fclose(st[i].out);
+        if (!found) failures++;
+        printf("%d,%s,%.0f,%.2f,%.3f,%.3f,%.3f,%.1f,%.1f\n", i, port[i],
+               stat_value(st[i].stats, "frames"), stat_value(st[i].stats, "fps"),
+               stat_value(st[i].stats, "latency_avg_ms"), stat_value(st[i].stats, "latency_p50_ms"),
+               stat_value(st[i].stats, "latency_p99_ms"),
+               100.0 * st[i].sender_cpu / seconds, 100.0 * st[i].receiver_cpu / (seconds + 2));
+    }
+    fprintf(stderr, "%d stream(s) finished in %.1f s, %d failure(s)\n", streams,
+            (t1.tv_sec - t0.tv_sec) + (t1.tv_usec - t0.tv_usec) / 1e6, failures);
+    return failures ? 1 : 0;
+}
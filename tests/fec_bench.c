@@ -0,0 +1,248 @@
+// fec_bench.c
+// Gönderici/alıcı FEC yolunun mikro kıyaslaması: kamera ya da GPU gerekmez.
+// Her (k, r, shard boyutu) için sender'ın kullandığı fec_block_prepare/encode
+// yolunu (sıfır kopya ve kopyalı) ve e silinmiş shard ile çözmeyi ölçer.
+// r=1 satırları xor_gen, r=2 satırları pq_gen yolunu; e=1 çözme XOR yolunu ölçer.
+// Kare tamponu SHARD_POOL_ALIGN hizalıdır: sıfır kopya shard'ları da hizalı kalır ve
+// SIMD yolu ölçülür (hizasız GstBuffer belleğinde gönderici ec_encode_data'ya düşer).
+// encode_crc, encode'a ek olarak her shard paketinin crc32c'sini hesaplar (gönderici
+// yolu); verify alıcının rtp_fec_parse doğrulamasıdır.
+// Çıktı CSV'dir; sürümler arasında karşılaştırmak için dosyaya yönlendirin.
+// Derleme: gcc -O2 -Iinclude tests/fec_bench.c src/fec_block.c src/fec_codec.c
+//          src/shard_pool.c src/rtp_fec.c -lisal -lpthread -o tests/fec_bench
+// Kullanım: tests/fec_bench [-q] [-n iterations]
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "fec_block.h"
+#include "rtp_fec.h"
+
+static const int ks[]     = { 4, 8, 10, 16 };
+static const int rs[]     = { 1, 2, 4 };
+static const int shards[] = { 256, 1024, 1408, 4096 };
+
+/* -q: sender varsayılanlarına yakın küçük ızgara */
+static const int ks_q[]     = { 10 };
+static const int rs_q[]     = { 1, 2, 4 };
+static const int shards_q[] = { 1408 };
+
+#define NELEM(a) ((int)(sizeof(a) / sizeof((a)[0])))
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+/* Bir hücrenin sonucu: toplam süre ve yineleme başına gecikmeler */
+static void report(const char *op, int k, int r, int shard, int erasures,
+                   size_t bytes, uint64_t *lat, int n) {
+    uint64_t total = 0;
+    for (int i = 0; i < n; i++) total += lat[i];
+    qsort(lat, n, sizeof(*lat), cmp_u64);
+    double gbps = total ? (double)bytes * n / (double)total : 0.0;  // byte/ns == GB/s
+    printf("%s,%d,%d,%d,%d,%zu,%d,%.3f,%.0f,%llu,%llu\n",
+           op, k, r, shard, erasures, bytes, n, gbps, (double)total / n,
+           (unsigned long long)lat[n / 2], (unsigned long long)lat[(n * 99) / 100]);
+}
+
+/* sender.c ile aynı yol: böl, kodla, slab'ı bırak */
+static void bench_encode(ShardPool *pool, const unsigned char *frame, size_t len,
+                         int k, int r, int shard, int zero_copy, int iters, uint64_t *lat) {
+    const FecEncoder *enc = fec_encoder_get(k, r);
+    for (int i = 0; i < iters; i++) {
+        uint64_t t0 = now_ns();
+        FecBlock blk;
+        if (fec_block_prepare(&blk, pool, k, r, frame, len, zero_copy) < 0) {
+            fprintf(stderr, "prepare failed (k=%d r=%d len=%zu)\n", k, r, len);
+            exit(1);
+        }
+        fec_block_encode(&blk, enc);
+        fec_block_release(&blk, pool);
+        lat[i] = now_ns() - t0;
+    }
+    report(zero_copy ? "encode" : "encode_copy", k, r, shard, 0, len, lat, iters);
+}
+
+/* encode + her shard paketinin crc32c'si; başlıklar sabit bir tamponda yazılır */
+static void bench_encode_crc(ShardPool *pool, const unsigned char *frame, size_t len,
+                             int k, int r, int shard, int iters, uint64_t *lat) {
+    static uint8_t hdr[RTP_FEC_PACKET_OVERHEAD];
+    RtpFecHeader h = { .k = (uint8_t)k, .r = (uint8_t)r };
+    const FecEncoder *enc = fec_encoder_get(k, r);
+    for (int i = 0; i < iters; i++) {
+        uint64_t t0 = now_ns();
+        FecBlock blk;
+        if (fec_block_prepare(&blk, pool, k, r, frame, len, 1) < 0) {
+            fprintf(stderr, "prepare failed (k=%d r=%d len=%zu)\n", k, r, len);
+            exit(1);
+        }
+        fec_block_encode(&blk, enc);
+        h.shard_size = (uint16_t)blk.shard_size;
+        h.payload_len = (uint32_t)len;
+        for (int j = 0; j < k + r; j++) {
+            h.shard_index = (uint8_t)j;
+            rtp_fec_write_header(hdr, &h);
+            rtp_fec_seal(hdr, blk.shards[j], (size_t)blk.shard_size);
+        }
+        fec_block_release(&blk, pool);
+        lat[i] = now_ns() - t0;
+    }
+    report("encode_crc", k, r, shard, 0, len, lat, iters);
+}
+
+/* Alıcı tarafı: bloğun k + r paketini ayrıştırıp doğrular; tek bitlik bozulma yakalanmalı */
+static int bench_verify(ShardPool *pool, const unsigned char *frame, size_t len,
+                        int k, int r, int shard, int iters, uint64_t *lat) {
+    FecBlock blk;
+    if (fec_block_prepare(&blk, pool, k, r, frame, len, 0) < 0) return -1;
+    fec_block_encode(&blk, fec_encoder_get(k, r));
+    size_t pkt_size = RTP_FEC_PACKET_OVERHEAD + (size_t)blk.shard_size;
+    uint8_t *pkts = malloc(pkt_size * (size_t)(k + r));
+    if (!pkts) return -1;
+    for (int j = 0; j < k + r; j++) {
+        RtpFecHeader h = {
+            .k = (uint8_t)k, .r = (uint8_t)r, .shard_index = (uint8_t)j,
+            .shard_size = (uint16_t)blk.shard_size, .payload_len = (uint32_t)len,
+        };
+        uint8_t *p = pkts + (size_t)j * pkt_size;
+        rtp_fec_write_header(p, &h);
+        memcpy(p + RTP_FEC_PACKET_OVERHEAD, blk.shards[j], blk.shard_size);
+        rtp_fec_seal(p, p + RTP_FEC_PACKET_OVERHEAD, (size_t)blk.shard_size);
+    }
+    fec_block_release(&blk, pool);
+
+    int ok = 0;
+    RtpFecPacket pkt;
+    for (int i = 0; i < iters; i++) {
+        uint64_t t0 = now_ns();
+        for (int j = 0; j < k + r; j++)
+            if (rtp_fec_parse(pkts + (size_t)j * pkt_size, pkt_size, &pkt) < 0) ok = -1;
+        lat[i] = now_ns() - t0;
+    }
+    uint8_t *victim = pkts + pkt_size - 1;
+    *victim ^= 0x10;
+    if (rtp_fec_parse(pkts, pkt_size, &pkt) != RTP_FEC_PARSE_CHECKSUM) ok = -1;
+    free(pkts);
+    if (ok < 0) {
+        fprintf(stderr, "checksum mismatch (k=%d r=%d shard=%d)\n", k, r, shard);
+        return -1;
+    }
+    report("verify", k, r, shard, 0, len, lat, iters);
+    return 0;
+}
+
+/* e veri shard'ı silinmiş bloğu çözer; desen her yinelemede kayar (önbellek ısınır) */
+static int bench_decode(ShardPool *pool, FecDecoder *dec, const unsigned char *frame, size_t len,
+                        int k, int r, int shard, int e, int iters, uint64_t *lat) {
+    FecBlock blk;
+    if (fec_block_prepare(&blk, pool, k, r, frame, len, 0) < 0) return -1;
+    fec_block_encode(&blk, fec_encoder_get(k, r));
+
+    int ok = 0;
+    unsigned char present[FEC_MAX_TOTAL_SHARDS];
+    for (int i = 0; i < iters; i++) {
+        memset(present, 1, sizeof(present));
+        for (int j = 0; j < e; j++) {
+            int idx = (i + j) % k;
+            present[idx] = 0;
+            memset(blk.shards[idx], 0xee, blk.shard_size);
+        }
+        uint64_t t0 = now_ns();
+        int rc = fec_decoder_reconstruct(dec, k, r, blk.shard_size, blk.shards, present);
+        lat[i] = now_ns() - t0;
+        if (rc < 0) ok = -1;
+    }
+
+    // Son yinelemenin sonucunu doğrula
+    for (int i = 0; i < k && ok == 0; i++) {
+        size_t off = (size_t)i * blk.shard_size;
+        size_t n = off < len ? (len - off < (size_t)blk.shard_size ? len - off : (size_t)blk.shard_size) : 0;
+        if (n && memcmp(blk.shards[i], frame + off, n) != 0) ok = -1;
+    }
+    fec_block_release(&blk, pool);
+    if (ok < 0) {
+        fprintf(stderr, "decode mismatch (k=%d r=%d shard=%d e=%d)\n", k, r, shard, e);
+        return -1;
+    }
+    report("decode", k, r, shard, e, len, lat, iters);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    int quick = 0, fixed_iters = 0, opt;
+    while ((opt = getopt(argc, argv, "qn:")) != -1) {
+        switch (opt) {
+            case 'q': quick = 1; break;
+            case 'n': fixed_iters = atoi(optarg); break;
+            default:
+                fprintf(stderr, "usage: %s [-q] [-n iterations]\n", argv[0]);
+                return 2;
+        }
+    }
+    const int *kv = quick ? ks_q : ks, *rv = quick ? rs_q : rs, *sv = quick ? shards_q : shards;
+    int nk = quick ? NELEM(ks_q) : NELEM(ks);
+    int nr = quick ? NELEM(rs_q) : NELEM(rs);
+    int ns = quick ? NELEM(shards_q) : NELEM(shards);
+
+    ShardPool *pool = shard_pool_new(4);
+    FecDecoder *dec = fec_decoder_new(0);
+    size_t max_len = (size_t)FEC_MAX_DATA_SHARDS * 4096;
+    unsigned char *frame = NULL;
+    if (posix_memalign((void **)&frame, SHARD_POOL_ALIGN, max_len)) frame = NULL;
+    uint64_t *lat = malloc(sizeof(uint64_t) * 20000);
+    if (!pool || !dec || !frame || !lat) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    srand(1);
+    for (size_t i = 0; i < max_len; i++) frame[i] = (unsigned char)rand();
+
+    int failures = 0;
+    printf("op,k,r,shard_size,erasures,frame_bytes,iterations,gb_per_s,ns_per_frame,p50_ns,p99_ns\n");
+    for (int a = 0; a < nk; a++)
+        for (int b = 0; b < nr; b++)
+            for (int c = 0; c < ns; c++) {
+                int k = kv[a], r = rv[b], shard = sv[c];
+                // Kuyruk shard'ı kısmi olsun: sıfır kopya yolundaki kopyalama da ölçülür
+                size_t len = (size_t)k * shard - shard / 3;
+
+                // Hücre başına ~64 MB veri, 200..20000 yineleme
+                int iters = fixed_iters > 0 ? fixed_iters : (int)((64u << 20) / len);
+                if (!fixed_iters && iters < 200) iters = 200;
+                if (iters > 20000) iters = 20000;
+
+                if (!fec_encoder_get(k, r)) {
+                    fprintf(stderr, "encoder init failed (k=%d r=%d)\n", k, r);
+                    failures++;
+                    continue;
+                }
+                bench_encode(pool, frame, len, k, r, shard, 1, iters, lat);
+                bench_encode(pool, frame, len, k, r, shard, 0, iters, lat);
+                bench_encode_crc(pool, frame, len, k, r, shard, iters, lat);
+                if (bench_verify(pool, frame, len, k, r, shard, iters, lat) < 0)
+                    failures++;
+                for (int e = 1; e <= r; e++)
+                    if (bench_decode(pool, dec, frame, len, k, r, shard, e, iters, lat) < 0)
+                        failures++;
+            }
+
+    FecDecoderStats ds;
+    fec_decoder_get_stats(dec, &ds);
+    fprintf(stderr, "decoder cache: %llu hits, %llu misses, %llu failures; %llu XOR decodes\n",
+            ds.cache_hits, ds.cache_misses, ds.failures, ds.xor_decodes);
+
+    free(lat);
+    free(frame);
+    fec_decoder_free(dec);
+    shard_pool_free(pool);
+    fec_codec_shutdown();
+    return failures ? 1 : 0;
+}
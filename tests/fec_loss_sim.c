@@ -0,0 +1,665 @@
+// fec_loss_sim.c
+// FEC ayarlarını canlı bağlantı yerine çevrimdışı seçmek için deterministik kayıp
+// emülatörü: sentetik erişim birimleri sender'ın yolundan geçer (fec_block_prepare /
+// encode, rtp_fec_sender_pack_block), gönderim zamanlayıcısının serpiştirme penceresiyle
+// sanal zamanda sıralanır, emüle edilen kanaldan (kayıp, gecikme, yeniden sıralama)
+// geçip alıcının rtp_fec_parse + fec_reassembler yoluna varış sırasıyla verilir.
+// Soket ve duvar saati yoktur; aynı tohum ve parametreler aynı sonucu verir.
+//
+// Kayıp modelleri:
+//   bernoulli  her paket bağımsız olarak -p olasılığıyla kaybolur
+//   gilbert    Gilbert-Elliott: iyi/kötü durumlar arası p_gb / p_bg geçişleri,
+//              durum başına kayıp olasılığı (varsayılan iyi 0, kötü 1)
+//   trace      kayıtlı iz: paket başına '1' kayıp, '0' alındı ('#' satırları ve
+//              boşluklar atlanır); iz bitince başa döner
+// Her modele sabit gecikme, düzgün dağılımlı jitter ve -R ile yeniden sıralama
+// (paketin bir kısmı fazladan gecikir) eklenebilir.
+//
+// Her (k, r, serpiştirme) hücresi için CSV: paket kaybı, FEC sonrası kalan blok kaybı,
+// teslim edilen ve (PLI'sız) çözülebilir kare oranı, bant genişliği yükü ve yakalama ->
+// birleştirme gecikmesi. NACK/PLI döngüsü emüle edilmez. -J ile alıcının blok sayılı
+// yeniden sıralama derinliği yerine uyarlanır jitter tamponu (son tarihli bloklar) kullanılır.
+// Derleme: gcc -O2 -Iinclude tests/fec_loss_sim.c src/fec_block.c src/fec_codec.c
+//          src/shard_pool.c src/rtp_fec.c src/fec_reassembler.c src/fec_aggregator.c
+//          -lisal -lpthread -lm -o tests/fec_loss_sim
+// Kullanım: tests/fec_loss_sim [-q] [-m model] [-p P] [-g PGB,PBG[,HG,HB]] [-t FILE]
+//           [-R PROB,MS] [-d MS[,JITTER]] [-L KBPS] [-k LIST] [-r LIST] [-i LIST]
+//           [-w BLOCKS | -J MIN,MAX] [-n FRAMES] [-b KBPS] [-f FPS] [-G GOP] [-M MTU] [-s SEED]
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "fec_block.h"
+#include "rtp_fec.h"
+#include "fec_reassembler.h"
+
+#define MAX_GRID 16
+
+/* Alıcının varsayılan blok penceresi (receiver --window) */
+#define RX_WINDOW 64
+
+/* IDR, ortalama P-frame'in bu katı; kare boyutları ortalamanın ±%30'u */
+#define IDR_FACTOR 4
+#define SIZE_JITTER 0.3
+
+static const int ks[] = { 4, 8, 10, 16 };
+static const int rs[] = { 1, 2, 4 };
+static const int ils[] = { 1, 2, 4, 8 };
+
+/* -q: sender varsayılanlarına yakın küçük ızgara */
+static const int ks_q[] = { 10 };
+static const int rs_q[] = { 1, 2, 4 };
+static const int ils_q[] = { 1, 4 };
+
+#define NELEM(a) ((int)(sizeof(a) / sizeof((a)[0])))
+
+/* --- Tohumlanmış PRNG (xorshift64*); platformdan bağımsız, rand() kullanılmaz --- */
+static uint64_t rng_seed(uint64_t seed, uint64_t stream) {
+    // splitmix64: aynı tohumdan bağımsız akışlar
+    uint64_t z = seed + stream * 0x9e3779b97f4a7c15ull;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    z ^= z >> 31;
+    return z ? z : 1;
+}
+
+static double rng_uniform(uint64_t *s) {
+    *s ^= *s >> 12;
+    *s ^= *s << 25;
+    *s ^= *s >> 27;
+    return (double)((*s * 0x2545f4914f6cdd1dull) >> 11) * 0x1.0p-53;
+}
+
+/* --- Kanal --- */
+typedef enum { MODEL_BERNOULLI, MODEL_GILBERT, MODEL_TRACE } ModelKind;
+
+typedef struct {
+    ModelKind kind;
+    double p;                       /* bernoulli */
+    double p_gb, p_bg;              /* gilbert: iyi -> kötü, kötü -> iyi */
+    double h_good, h_bad;           /* gilbert: durumdaki kayıp olasılığı */
+    unsigned char *trace;           /* 1 -> kayıp */
+    size_t trace_len;
+    double reorder_p;               /* fazladan gecikecek paket oranı */
+    uint64_t reorder_ns;
+    uint64_t delay_ns, jitter_ns;
+    uint64_t link_bps;              /* 0 -> kare bir patlama halinde gider */
+} ChannelConfig;
+
+typedef struct {
+    const ChannelConfig *cfg;
+    uint64_t rng_loss, rng_delay;
+    int bad;
+    size_t trace_pos;
+} Channel;
+
+static void channel_init(Channel *ch, const ChannelConfig *cfg, uint64_t seed) {
+    memset(ch, 0, sizeof(*ch));
+    ch->cfg = cfg;
+    ch->rng_loss = rng_seed(seed, 1);
+    ch->rng_delay = rng_seed(seed, 2);
+}
+
+/* @return 1 -> paket kayboldu */
+static int channel_drop(Channel *ch) {
+    const ChannelConfig *c = ch->cfg;
+    switch (c->kind) {
+        case MODEL_BERNOULLI:
+            return rng_uniform(&ch->rng_loss) < c->p;
+        case MODEL_GILBERT: {
+            // Durum önce ilerler, kayıp yeni duruma göre çekilir
+            double u = rng_uniform(&ch->rng_loss);
+            if (ch->bad ? u < c->p_bg : u < c->p_gb) ch->bad = !ch->bad;
+            return rng_uniform(&ch->rng_loss) < (ch->bad ? c->h_bad : c->h_good);
+        }
+        case MODEL_TRACE: {
+            int lost = c->trace[ch->trace_pos];
+            ch->trace_pos = (ch->trace_pos + 1) % c->trace_len;
+            return lost;
+        }
+    }
+    return 0;
+}
+
+static uint64_t channel_delay(Channel *ch) {
+    const ChannelConfig *c = ch->cfg;
+    uint64_t d = c->delay_ns;
+    if (c->jitter_ns) {
+        double j = (rng_uniform(&ch->rng_delay) * 2.0 - 1.0) * (double)c->jitter_ns;
+        d = (double)d + j > 0.0 ? (uint64_t)((double)d + j) : 0;
+    }
+    if (c->reorder_p > 0.0 && rng_uniform(&ch->rng_delay) < c->reorder_p) d += c->reorder_ns;
+    return d;
+}
+
+/* --- Yoldaki paketler: varış zamanına (eşitse gönderim sırasına) göre min-heap --- */
+typedef struct {
+    uint64_t arrival;
+    uint64_t order;
+    size_t len;
+    uint8_t *data;
+} Inflight;
+
+typedef struct {
+    Inflight *items;
+    size_t n, cap;
+} Heap;
+
+static int heap_less(const Inflight *a, const Inflight *b) {
+    return a->arrival < b->arrival || (a->arrival == b->arrival && a->order < b->order);
+}
+
+static int heap_push(Heap *h, Inflight it) {
+    if (h->n == h->cap) {
+        size_t cap = h->cap ? h->cap * 2 : 256;
+        Inflight *items = realloc(h->items, cap * sizeof(*items));
+        if (!items) return -1;
+        h->items = items;
+        h->cap = cap;
+    }
+    size_t i = h->n++;
+    while (i && heap_less(&it, &h->items[(i - 1) / 2])) {
+        h->items[i] = h->items[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    h->items[i] = it;
+    return 0;
+}
+
+static Inflight heap_pop(Heap *h) {
+    Inflight top = h->items[0];
+    Inflight last = h->items[--h->n];
+    size_t i = 0;
+    for (;;) {
+        size_t c = 2 * i + 1;
+        if (c >= h->n) break;
+        if (c + 1 < h->n && heap_less(&h->items[c + 1], &h->items[c])) c++;
+        if (!heap_less(&h->items[c], &last)) break;
+        h->items[i] = h->items[c];
+        i = c;
+    }
+    if (h->n) h->items[i] = last;
+    return top;
+}
+
+/* --- Bir hücrenin koşusu --- */
+typedef struct {
+    int frames, fps, gop, kbps, mtu, reorder;
+    int jitter_buffer;
+    FecJitterConfig jb;
+    uint64_t seed;
+} SimConfig;
+
+/* Gönderim kuyruğundaki blok: send_scheduler'daki SchedBlock'un sanal zamanlı karşılığı */
+typedef struct {
+    uint8_t *buf;
+    size_t pkt_size;
+    int npkts;
+    int next;
+    uint64_t t_enqueue;
+} SimBlock;
+
+typedef struct {
+    const SimConfig *cfg;
+    const unsigned char *source;    /* her birim bu tamponun başından len byte */
+    const size_t *sizes;
+    uint64_t frame_ns;
+
+    Channel ch;
+    Heap heap;
+    FecReassembler *ra;
+    uint64_t now_rx;                /* alıcıya verilen son paketin varış zamanı */
+
+    SimBlock *queue;
+    int qhead, qtail, qcap;
+    unsigned int rr;
+
+    uint64_t packets, lost, wire_bytes, payload_bytes, order;
+    int delivered, decodable, corrupt;
+    int last_index, chain_ok;
+    double *latency_ms;
+} Sim;
+
+static int frame_index(const Sim *sim, uint32_t ts) {
+    return (int)(((uint64_t)ts * sim->cfg->fps + RTP_FEC_CLOCK_RATE / 2) / RTP_FEC_CLOCK_RATE);
+}
+
+static void on_frame(void *user, const unsigned char *data, size_t len,
+                     uint32_t ts, int keyframe) {
+    Sim *sim = user;
+    int idx = frame_index(sim, ts);
+    if (idx < 0 || idx >= sim->cfg->frames || len != sim->sizes[idx] ||
+        memcmp(data, sim->source, len) != 0) {
+        sim->corrupt++;
+        return;
+    }
+    uint64_t capture = (uint64_t)idx * sim->frame_ns;
+    sim->latency_ms[sim->delivered++] = (double)(sim->now_rx - capture) / 1e6;
+    // PLI olmadan çözülebilir: IDR'dan bu kareye kadar zincir kopmamış
+    sim->chain_ok = keyframe || (sim->chain_ok && idx == sim->last_index + 1);
+    if (sim->chain_ok) sim->decodable++;
+    sim->last_index = idx;
+}
+
+/* Alıcı saatini t'ye getirir; arada dolan blok son tarihleri kendi anlarında işlenir */
+static void receiver_advance(Sim *sim, uint64_t t) {
+    if (sim->cfg->jitter_buffer) {
+        int64_t dl;
+        while ((dl = fec_reassembler_next_deadline(sim->ra)) >= 0 && (uint64_t)dl * 1000 <= t) {
+            sim->now_rx = (uint64_t)dl * 1000;
+            fec_reassembler_advance(sim->ra, dl);
+        }
+        fec_reassembler_advance(sim->ra, (int64_t)(t / 1000));
+    }
+    sim->now_rx = t;
+}
+
+/* Varış zamanı until'e kadar gelen paketleri alıcıya verir */
+static void deliver_until(Sim *sim, uint64_t until) {
+    while (sim->heap.n && sim->heap.items[0].arrival <= until) {
+        Inflight it = heap_pop(&sim->heap);
+        RtpFecPacket pkt;
+        receiver_advance(sim, it.arrival);
+        if (rtp_fec_parse(it.data, it.len, &pkt) == 0)
+            fec_reassembler_push(sim->ra, &pkt);
+        free(it.data);
+    }
+}
+
+static int channel_send(Sim *sim, const uint8_t *pkt, size_t len, uint64_t depart) {
+    sim->packets++;
+    sim->wire_bytes += len;
+    if (channel_drop(&sim->ch)) {
+        sim->lost++;
+        return 0;
+    }
+    Inflight it = { .arrival = depart + channel_delay(&sim->ch), .order = sim->order++, .len = len };
+    if (!(it.data = malloc(len))) return -1;
+    memcpy(it.data, pkt, len);
+    return heap_push(&sim->heap, it);
+}
+
+/*
+ * Gönderici saatini horizon'a kadar ilerletir. Pencere, kuyruğa girmiş ve bitmemiş
+ * ilk `interleave` blok; paketler pencereden sırayla seçilir (send_scheduler'ın
+ * window_pick'i). link_bps verilmişse her paket kendi serileştirme süresi kadar sürer.
+ */
+static int drain_sender(Sim *sim, uint64_t *now, uint64_t horizon, int interleave) {
+    const ChannelConfig *c = sim->ch.cfg;
+    while (sim->qhead != sim->qtail) {
+        int live[MAX_GRID * 4];
+        int n = 0;
+        for (int u = sim->qhead; u != sim->qtail && n < interleave; u++) {
+            SimBlock *b = &sim->queue[u % sim->qcap];
+            if (b->t_enqueue > *now) break;
+            if (b->next < b->npkts) live[n++] = u;
+        }
+        if (!n) {
+            SimBlock *b = &sim->queue[sim->qhead % sim->qcap];
+            if (b->next < b->npkts && b->t_enqueue > *now) {
+                if (b->t_enqueue >= horizon) break;
+                *now = b->t_enqueue;
+                continue;
+            }
+            sim->qhead++;
+            continue;
+        }
+        if (*now >= horizon) break;
+        SimBlock *b = &sim->queue[live[sim->rr++ % n] % sim->qcap];
+        deliver_until(sim, *now);
+        if (channel_send(sim, b->buf + (size_t)b->next * b->pkt_size, b->pkt_size, *now) < 0)
+            return -1;
+        b->next++;
+        if (c->link_bps) *now += b->pkt_size * 8u * 1000000000ull / c->link_bps;
+        while (sim->qhead != sim->qtail) {
+            SimBlock *h = &sim->queue[sim->qhead % sim->qcap];
+            if (h->next < h->npkts) break;
+            sim->qhead++;
+        }
+    }
+    return 0;
+}
+
+static SimBlock* queue_slot(Sim *sim) {
+    if (sim->qtail - sim->qhead == sim->qcap) {
+        // Kuyruğu büyüt; sıralama [qhead, qtail) korunur
+        int cap = sim->qcap ? sim->qcap * 2 : 64;
+        SimBlock *q = calloc((size_t)cap, sizeof(*q));
+        if (!q) return NULL;
+        int n = sim->qtail - sim->qhead;
+        for (int i = 0; i < n; i++) q[i] = sim->queue[(sim->qhead + i) % sim->qcap];
+        for (int i = n; i < sim->qcap; i++) q[i] = sim->queue[(sim->qhead + i) % sim->qcap];
+        free(sim->queue);
+        sim->queue = q;
+        sim->qcap = cap;
+        sim->qtail = n;
+        sim->qhead = 0;
+    }
+    return &sim->queue[sim->qtail % sim->qcap];
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return x < y ? -1 : x > y;
+}
+
+static const char* model_name(ModelKind kind) {
+    return kind == MODEL_BERNOULLI ? "bernoulli" : kind == MODEL_GILBERT ? "gilbert" : "trace";
+}
+
+static int run_cell(const SimConfig *cfg, const ChannelConfig *ch, ShardPool *pool,
+                    const unsigned char *source, const size_t *sizes,
+                    int k, int r, int interleave) {
+    const FecEncoder *enc = fec_encoder_get(k, r);
+    RtpFecSender *sender = rtp_fec_sender_new("127.0.0.1", 9, 0x5eed, 0);
+    if (!enc || !sender) {
+        fprintf(stderr, "init failed (k=%d r=%d)\n", k, r);
+        rtp_fec_sender_free(sender);
+        return -1;
+    }
+    Sim sim = { .cfg = cfg, .source = source, .sizes = sizes, .last_index = -1 };
+    sim.frame_ns = 1000000000ull / (uint64_t)cfg->fps;
+    sim.latency_ms = calloc((size_t)cfg->frames, sizeof(double));
+    // Alıcı yeniden sıralama derinliği serpiştirmeden küçük olmamalı (README)
+    int reorder = cfg->jitter_buffer ? 0 : cfg->reorder > interleave ? cfg->reorder : interleave;
+    sim.ra = fec_reassembler_new(RX_WINDOW, (unsigned int)reorder, on_frame, &sim);
+    if (sim.ra && cfg->jitter_buffer) fec_reassembler_set_jitter_buffer(sim.ra, &cfg->jb);
+    channel_init(&sim.ch, ch, cfg->seed);
+    if (!sim.latency_ms || !sim.ra) {
+        fprintf(stderr, "out of memory\n");
+        return -1;
+    }
+
+    int rc = 0;
+    size_t shard_max = (size_t)rtp_fec_max_shard_size(cfg->mtu);
+    size_t block_max = (size_t)k * shard_max;
+    uint64_t blocks = 0, now = 0;
+    for (int i = 0; i < cfg->frames && rc == 0; i++) {
+        uint64_t capture = (uint64_t)i * sim.frame_ns;
+        uint32_t ts = (uint32_t)((uint64_t)i * RTP_FEC_CLOCK_RATE / (uint64_t)cfg->fps);
+        int keyframe = i % cfg->gop == 0;
+        size_t len = sizes[i];
+        sim.payload_bytes += len;
+        // fec_pipeline ile aynı bölme: k * en büyük shard'lık bloklar, sonuncusu kısmi
+        int nblocks = (int)((len + block_max - 1) / block_max);
+        for (int b = 0; b < nblocks && rc == 0; b++) {
+            size_t off = (size_t)b * block_max;
+            size_t blen = len - off < block_max ? len - off : block_max;
+            FecBlock blk;
+            SimBlock *sb = queue_slot(&sim);
+            if (!sb || fec_block_prepare(&blk, pool, k, r, source + off, blen, 1) < 0) {
+                fprintf(stderr, "prepare failed (k=%d r=%d len=%zu)\n", k, r, blen);
+                rc = -1;
+                break;
+            }
+            fec_block_encode(&blk, enc);
+            uint8_t flags = keyframe ? RTP_FEC_FLAG_KEYFRAME : 0;
+            if (b == 0) flags |= RTP_FEC_FLAG_START_OF_FRAME;
+            if (b == nblocks - 1) flags |= RTP_FEC_FLAG_END_OF_FRAME;
+            size_t pkt_size = RTP_FEC_PACKET_OVERHEAD + (size_t)blk.shard_size;
+            size_t need = (size_t)(k + r) * pkt_size;
+            uint8_t *buf = realloc(sb->buf, need);
+            if (!buf) {
+                fec_block_release(&blk, pool);
+                rc = -1;
+                break;
+            }
+            sb->buf = buf;
+            sb->pkt_size = pkt_size;
+            sb->npkts = rtp_fec_sender_pack_block(sender, &blk, ts, flags, buf, pkt_size);
+            sb->next = 0;
+            sb->t_enqueue = capture;
+            fec_block_release(&blk, pool);
+            sim.qtail++;
+            blocks++;
+        }
+        if (rc == 0) rc = drain_sender(&sim, &now, capture + sim.frame_ns, interleave);
+    }
+    if (rc == 0) rc = drain_sender(&sim, &now, UINT64_MAX, interleave);
+    deliver_until(&sim, UINT64_MAX);
+    fec_reassembler_flush(sim.ra);
+
+    FecReassemblerStats st;
+    FecJitterStats js;
+    fec_reassembler_get_stats(sim.ra, &st);
+    fec_reassembler_get_jitter_stats(sim.ra, &js);
+    qsort(sim.latency_ms, (size_t)sim.delivered, sizeof(double), cmp_double);
+    double p50 = sim.delivered ? sim.latency_ms[sim.delivered / 2] : 0.0;
+    double p99 = sim.delivered ? sim.latency_ms[(sim.delivered * 99) / 100] : 0.0;
+    double max = sim.delivered ? sim.latency_ms[sim.delivered - 1] : 0.0;
+    if (rc == 0)
+        printf("%s,%d,%d,%d,%d,%d,%llu,%.5f,%llu,%llu,%.6f,%d,%.5f,%d,%.5f,%.2f,%.3f,%.3f,%.3f,%.3f,%llu\n",
+               model_name(ch->kind), k, r, interleave, reorder, cfg->frames,
+               (unsigned long long)sim.packets,
+               sim.packets ? (double)sim.lost / sim.packets : 0.0,
+               (unsigned long long)blocks, (unsigned long long)st.blocks_lost,
+               blocks ? (double)st.blocks_lost / blocks : 0.0,
+               sim.delivered, (double)sim.delivered / cfg->frames,
+               sim.decodable, (double)sim.decodable / cfg->frames,
+               sim.payload_bytes ? 100.0 * (double)(sim.wire_bytes - sim.payload_bytes) /
+                                   sim.payload_bytes : 0.0,
+               p50, p99, max, js.wait_us / 1000.0, (unsigned long long)js.blocks_expired);
+    if (sim.corrupt) {
+        fprintf(stderr, "%d corrupt frames (k=%d r=%d interleave=%d)\n", sim.corrupt, k, r, interleave);
+        rc = -1;
+    }
+
+    for (int i = 0; i < sim.qcap; i++) free(sim.queue[i].buf);
+    free(sim.queue);
+    for (size_t i = 0; i < sim.heap.n; i++) free(sim.heap.items[i].data);
+    free(sim.heap.items);
+    free(sim.latency_ms);
+    fec_reassembler_free(sim.ra);
+    rtp_fec_sender_free(sender);
+    return rc;
+}
+
+/* "4,8,10" -> dizi; @return eleman sayısı, -1 -> geçersiz */
+static int parse_list(const char *arg, int *out, int lo, int hi) {
+    int n = 0;
+    const char *p = arg;
+    while (*p) {
+        char *end;
+        long v = strtol(p, &end, 10);
+        if (end == p || v < lo || v > hi || n == MAX_GRID) return -1;
+        out[n++] = (int)v;
+        if (*end == ',') end++;
+        else if (*end) return -1;
+        p = end;
+    }
+    return n ? n : -1;
+}
+
+/* "a,b[,c,d]" -> double'lar; @return okunan sayı */
+static int parse_doubles(const char *arg, double *out, int max) {
+    int n = 0;
+    const char *p = arg;
+    while (*p && n < max) {
+        char *end;
+        out[n] = strtod(p, &end);
+        if (end == p) return -1;
+        n++;
+        if (*end == ',') end++;
+        else if (*end) return -1;
+        p = end;
+    }
+    return n;
+}
+
+static int load_trace(const char *path, ChannelConfig *ch) {
+    FILE *f = fopen(path, "r");
+    if (!f) return -1;
+    size_t cap = 4096;
+    ch->trace = malloc(cap);
+    ch->trace_len = 0;
+    int c, comment = 0;
+    while (ch->trace && (c = fgetc(f)) != EOF) {
+        if (c == '\n') { comment = 0; continue; }
+        if (comment || c == ' ' || c == '\t' || c == '\r') continue;
+        if (c == '#') { comment = 1; continue; }
+        if (c != '0' && c != '1') {
+            fclose(f);
+            return -1;
+        }
+        if (ch->trace_len == cap) {
+            unsigned char *t = realloc(ch->trace, cap *= 2);
+            if (!t) break;
+            ch->trace = t;
+        }
+        ch->trace[ch->trace_len++] = (unsigned char)(c == '1');
+    }
+    fclose(f);
+    return ch->trace && ch->trace_len ? 0 : -1;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s [-q] [-m bernoulli|gilbert|trace] [-p P] [-g PGB,PBG[,HG,HB]] [-t FILE]\n"
+            "       [-R PROB,MS] [-d MS[,JITTER]] [-L KBPS] [-k LIST] [-r LIST] [-i LIST]\n"
+            "       [-w BLOCKS | -J MIN_MS,MAX_MS] [-n FRAMES] [-b KBPS] [-f FPS] [-G GOP] [-M MTU] [-s SEED]\n",
+            prog);
+}
+
+int main(int argc, char **argv) {
+    SimConfig cfg = { .frames = 3000, .fps = 30, .gop = 30, .kbps = 4000, .mtu = RTP_FEC_DEFAULT_MTU,
+                      .reorder = 4, .seed = 1 };
+    ChannelConfig ch = { .kind = MODEL_GILBERT, .p = 0.02, .p_gb = 0.005, .p_bg = 0.25,
+                         .h_good = 0.0, .h_bad = 1.0, .delay_ns = 20000000ull };
+    int kv[MAX_GRID], rv[MAX_GRID], iv[MAX_GRID];
+    int nk = -2, nr = -2, ni = -2, quick = 0, opt;
+    double d[4];
+    while ((opt = getopt(argc, argv, "qm:p:g:t:R:d:L:k:r:i:w:J:n:b:f:G:M:s:")) != -1) {
+        int n = 0;
+        switch (opt) {
+            case 'q': quick = 1; break;
+            case 'm':
+                if (strcmp(optarg, "bernoulli") == 0) ch.kind = MODEL_BERNOULLI;
+                else if (strcmp(optarg, "gilbert") == 0) ch.kind = MODEL_GILBERT;
+                else if (strcmp(optarg, "trace") == 0) ch.kind = MODEL_TRACE;
+                else n = -1;
+                break;
+            case 'p': n = parse_doubles(optarg, &ch.p, 1); break;
+            case 'g':
+                n = parse_doubles(optarg, d, 4);
+                if (n == 2 || n == 4) {
+                    ch.p_gb = d[0];
+                    ch.p_bg = d[1];
+                    if (n == 4) { ch.h_good = d[2]; ch.h_bad = d[3]; }
+                } else {
+                    n = -1;
+                }
+                break;
+            case 't':
+                if (load_trace(optarg, &ch) < 0) {
+                    fprintf(stderr, "cannot read loss trace %s (expected 0/1 per packet)\n", optarg);
+                    return 2;
+                }
+                ch.kind = MODEL_TRACE;
+                break;
+            case 'R':
+                if ((n = parse_doubles(optarg, d, 2)) == 2) {
+                    ch.reorder_p = d[0];
+                    ch.reorder_ns = (uint64_t)(d[1] * 1e6);
+                } else {
+                    n = -1;
+                }
+                break;
+            case 'd':
+                if ((n = parse_doubles(optarg, d, 2)) >= 1) {
+                    ch.delay_ns = (uint64_t)(d[0] * 1e6);
+                    ch.jitter_ns = n == 2 ? (uint64_t)(d[1] * 1e6) : 0;
+                }
+                break;
+            case 'L': ch.link_bps = (uint64_t)atol(optarg) * 1000u; break;
+            case 'k': n = nk = parse_list(optarg, kv, 1, FEC_MAX_DATA_SHARDS); break;
+            case 'r': n = nr = parse_list(optarg, rv, 1, FEC_MAX_TOTAL_SHARDS - FEC_MAX_DATA_SHARDS); break;
+            case 'i': n = ni = parse_list(optarg, iv, 1, 32); break;
+            case 'w': cfg.reorder = atoi(optarg); break;
+            case 'J':
+                if ((n = parse_doubles(optarg, d, 2)) == 2 && d[0] >= 0.0 && d[1] >= d[0]) {
+                    cfg.jitter_buffer = 1;
+                    cfg.jb.min_wait_us = (uint32_t)(d[0] * 1000.0);
+                    cfg.jb.max_wait_us = (uint32_t)(d[1] * 1000.0);
+                } else {
+                    n = -1;
+                }
+                break;
+            case 'n': cfg.frames = atoi(optarg); break;
+            case 'b': cfg.kbps = atoi(optarg); break;
+            case 'f': cfg.fps = atoi(optarg); break;
+            case 'G': cfg.gop = atoi(optarg); break;
+            case 'M': cfg.mtu = atoi(optarg); break;
+            case 's': cfg.seed = strtoull(optarg, NULL, 0); break;
+            default: n = -1; break;
+        }
+        if (n < 0) {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (ch.kind == MODEL_TRACE && !ch.trace) {
+        fprintf(stderr, "-m trace needs -t FILE\n");
+        return 2;
+    }
+    if (cfg.frames < 1 || cfg.fps < 1 || cfg.gop < 1 || cfg.kbps < 1 || cfg.reorder < 1 ||
+        rtp_fec_max_shard_size(cfg.mtu) < 64) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (nk == -2) nk = quick ? NELEM(ks_q) : NELEM(ks), memcpy(kv, quick ? ks_q : ks, sizeof(int) * nk);
+    if (nr == -2) nr = quick ? NELEM(rs_q) : NELEM(rs), memcpy(rv, quick ? rs_q : rs, sizeof(int) * nr);
+    if (ni == -2) ni = quick ? NELEM(ils_q) : NELEM(ils), memcpy(iv, quick ? ils_q : ils, sizeof(int) * ni);
+
+    // Kare boyutları tohumdan: GOP başına bütçe kbps'e eşit, IDR ortalama P'nin IDR_FACTOR katı
+    size_t *sizes = malloc(sizeof(size_t) * (size_t)cfg.frames);
+    double gop_bytes = (double)cfg.kbps * 1000.0 / 8.0 / cfg.fps * cfg.gop;
+    double p_mean = gop_bytes / (cfg.gop - 1 + IDR_FACTOR);
+    size_t max_len = 0;
+    uint64_t rng = rng_seed(cfg.seed, 0);
+    for (int i = 0; sizes && i < cfg.frames; i++) {
+        double mean = i % cfg.gop == 0 ? p_mean * IDR_FACTOR : p_mean;
+        double v = mean * (1.0 + SIZE_JITTER * (rng_uniform(&rng) * 2.0 - 1.0));
+        sizes[i] = v < 64.0 ? 64 : (size_t)v;
+        if (sizes[i] > max_len) max_len = sizes[i];
+    }
+    // Sıfır kopya shard'ları source + off'u gösterir; xor_gen / pq_gen hizalı işaretçi ister
+    unsigned char *source = NULL;
+    if (posix_memalign((void **)&source, SHARD_POOL_ALIGN, max_len ? max_len : 1)) source = NULL;
+    ShardPool *pool = shard_pool_new(4);
+    if (!sizes || !source || !pool) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    for (size_t i = 0; i < max_len; i++) source[i] = (unsigned char)(rng_uniform(&rng) * 256.0);
+
+    if (ch.kind == MODEL_BERNOULLI)
+        fprintf(stderr, "model: bernoulli p=%.4f", ch.p);
+    else if (ch.kind == MODEL_GILBERT)
+        fprintf(stderr, "model: gilbert p_gb=%.4f p_bg=%.4f loss good=%.3f bad=%.3f "
+                "(mean loss %.4f, mean burst %.1f packets)", ch.p_gb, ch.p_bg, ch.h_good, ch.h_bad,
+                (ch.p_bg * ch.h_good + ch.p_gb * ch.h_bad) / (ch.p_gb + ch.p_bg),
+                ch.p_bg > 0.0 ? 1.0 / ch.p_bg : 0.0);
+    else
+        fprintf(stderr, "model: trace of %zu packets", ch.trace_len);
+    fprintf(stderr, ", delay %.1f ms +- %.1f ms, reorder %.3f by %.1f ms, link %s, seed %llu\n",
+            ch.delay_ns / 1e6, ch.jitter_ns / 1e6, ch.reorder_p, ch.reorder_ns / 1e6,
+            ch.link_bps ? "paced" : "burst per frame", (unsigned long long)cfg.seed);
+
+    int failures = 0;
+    printf("model,k,r,interleave,reorder,frames,packets,packet_loss,blocks,blocks_lost,"
+           "residual_block_loss,frames_delivered,frame_recovery,frames_decodable,decodable_ratio,"
+           "overhead_pct,latency_p50_ms,latency_p99_ms,latency_max_ms,jb_wait_ms,jb_expired\n");
+    for (int a = 0; a < nk; a++)
+        for (int b = 0; b < nr; b++)
+            for (int c = 0; c < ni; c++)
+                if (kv[a] + rv[b] > FEC_MAX_TOTAL_SHARDS ||
+                    run_cell(&cfg, &ch, pool, source, sizes, kv[a], rv[b], iv[c]) < 0)
+                    failures++;
+
+    free(ch.trace);
+    free(source);
+    free(sizes);
+    shard_pool_free(pool);
+    fec_codec_shutdown();
+    return failures ? 1 : 0;
+}
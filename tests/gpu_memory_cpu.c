@@ -0,0 +1,160 @@
+// gpu_memory_cpu.c
+// GPU'suz makinede bellek yolu yardımcılarını sınar: gpu_memory_accepts, indirme
+// adımı (post-proc yerine videoconvert) ve dal raporu. Gerçek hat videotestsrc ->
+// videoconvert -> sistem belleği caps'i -> videoscale -> fakesink olarak kurulur;
+// cihaz belleğinden inişin sayılması ise pad'lere elle yazılan caps'le denenir.
+// Derleme: gcc -Iinclude tests/gpu_memory_cpu.c src/gpu_memory.c
+//          $(pkg-config --cflags --libs gstreamer-1.0) -o tests/gpu_memory_cpu
+#include <stdio.h>
+#include <string.h>
+#include <gst/gst.h>
+#include "gpu_memory.h"
+
+#define DMABUF_CAPS "video/x-raw(memory:DMABuf)"
+
+static int fails;
+
+static void check(int ok, const char *what) {
+    printf("%-52s %s\n", what, ok ? "OK" : "FAIL");
+    if (!ok) fails++;
+}
+
+typedef struct {
+    GstElement **chain;
+    int n;
+    int downloads;
+} FirstBuffer;
+
+// Gönderici gibi: ilk buffer'da caps kesinleşmiştir, yolu raporla
+static GstPadProbeReturn on_first_buffer(GstPad *pad, GstPadProbeInfo *info, gpointer data) {
+    FirstBuffer *fb = data;
+    fb->downloads = gpu_memory_report_branch("", "encode", fb->chain, fb->n);
+    return GST_PAD_PROBE_REMOVE;
+}
+
+// Bir bin'e eklenmeyecek eleman: floating referans sahiplenilir
+static GstElement* make_owned(const char *factory, const char *name) {
+    GstElement *e = gst_element_factory_make(factory, name);
+    return e ? gst_object_ref_sink(e) : NULL;
+}
+
+static void test_accepts(void) {
+    GstElement *sink = make_owned("fakesink", NULL);
+    GstElement *conv = make_owned("videoconvert", NULL);
+    GstElement *scale = make_owned("videoscale", NULL);
+    if (!sink || !conv || !scale) {
+        check(0, "fakesink/videoconvert/videoscale available");
+        return;
+    }
+    check(gpu_memory_accepts(sink, DMABUF_CAPS), "fakesink accepts DMABuf (ANY)");
+    check(gpu_memory_accepts(conv, "video/x-raw"), "videoconvert accepts system memory");
+    check(gpu_memory_accepts(scale, "video/x-raw"), "videoscale accepts system memory");
+    check(!gpu_memory_accepts(NULL, "video/x-raw"), "no element -> not accepted");
+    check(!gpu_memory_accepts(sink, NULL), "no caps -> not accepted");
+
+    // Şablonu özelliksiz bir encoder cihaz belleğini reddeder (yoksa atlanır)
+    GstElement *jpeg = make_owned("jpegenc", NULL);
+    if (jpeg) {
+        check(!gpu_memory_accepts(jpeg, DMABUF_CAPS), "jpegenc rejects DMABuf");
+        gst_object_unref(jpeg);
+    }
+    check(!strcmp(gpu_memory_caps_for("vaapipostproc"), "video/x-raw(memory:VASurface)") &&
+          !strcmp(gpu_memory_caps_for("videoconvert"), DMABUF_CAPS) && !gpu_memory_caps_for(NULL),
+          "gpu_memory_caps_for families");
+    gst_object_unref(sink);
+    gst_object_unref(conv);
+    gst_object_unref(scale);
+}
+
+// Sistem belleğindeki hat: indirme adımı eklenir ama rapor indirme saymaz
+static void test_download_pipeline(void) {
+    GstElement *pipeline = gst_pipeline_new("cpu_only");
+    GstElement *src = gst_element_factory_make("videotestsrc", "src");
+    GstElement *src_caps = gst_element_factory_make("capsfilter", "src_caps");
+    GstElement *scale = gst_element_factory_make("videoscale", "enc_scale");
+    GstElement *sink = gst_element_factory_make("fakesink", "sink");
+    if (!pipeline || !src || !src_caps || !scale || !sink) {
+        check(0, "pipeline elements available");
+        return;
+    }
+    g_object_set(src, "num-buffers", 3, NULL);
+    GstCaps *caps = gst_caps_from_string("video/x-raw,width=320,height=240");
+    g_object_set(src_caps, "caps", caps, NULL);
+    gst_caps_unref(caps);
+    gst_bin_add_many(GST_BIN(pipeline), src, src_caps, scale, sink, NULL);
+
+    GstElement *chain[8] = { src, src_caps };
+    int n = 2;
+    check(gpu_memory_add_download(pipeline, "videoconvert", "enc", chain, &n) && n == 4,
+          "add_download appends converter and caps");
+    check(n == 4 && !strcmp(GST_ELEMENT_NAME(chain[2]), "enc_download") &&
+          !strcmp(GST_ELEMENT_NAME(chain[3]), "enc_sysmem"), "download elements named after branch");
+    check(!gpu_memory_add_download(pipeline, "no-such-postproc", "bad", chain, &n) && n == 4,
+          "unknown post-proc fails without touching chain");
+    chain[n++] = scale;
+    chain[n++] = sink;
+
+    gboolean linked = TRUE;
+    for (int i = 0; i + 1 < n; i++) linked &= gst_element_link(chain[i], chain[i + 1]);
+    check(linked, "download branch links");
+    check(gpu_memory_report_branch("", "encode", chain, n) == -1, "report before negotiation -> -1");
+
+    FirstBuffer fb = { chain, n, -2 };
+    GstPad *sink_pad = gst_element_get_static_pad(sink, "sink");
+    gst_pad_add_probe(sink_pad, GST_PAD_PROBE_TYPE_BUFFER, on_first_buffer, &fb, NULL);
+    gst_object_unref(sink_pad);
+
+    gst_element_set_state(pipeline, GST_STATE_PLAYING);
+    GstBus *bus = gst_element_get_bus(pipeline);
+    GstMessage *msg = gst_bus_timed_pop_filtered(bus, 5 * GST_SECOND,
+                                                 GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+    check(msg && GST_MESSAGE_TYPE(msg) == GST_MESSAGE_EOS, "pipeline reaches EOS");
+    if (msg) gst_message_unref(msg);
+    gst_object_unref(bus);
+
+    check(fb.downloads == 0, "system-memory branch reports no download");
+    GstPad *pad = gst_element_get_static_pad(chain[3], "sink");
+    gchar *kind = gpu_memory_pad_kind(pad);
+    check(kind && !strcmp(kind, "SystemMemory"), "pad kind is SystemMemory");
+    g_free(kind);
+    gst_object_unref(pad);
+
+    gst_element_set_state(pipeline, GST_STATE_NULL);
+    gst_object_unref(pipeline);
+}
+
+// Pad'in negotiated caps'i yapışkan caps olayıdır; GPU olmadan cihaz belleği taklit edilir
+static void set_pad_caps(GstElement *e, const char *pad_name, const char *caps_str) {
+    GstPad *pad = gst_element_get_static_pad(e, pad_name);
+    gst_pad_set_active(pad, TRUE);
+    GstCaps *caps = gst_caps_from_string(caps_str);
+    GstEvent *ev = gst_event_new_caps(caps);
+    gst_pad_store_sticky_event(pad, ev);
+    gst_event_unref(ev);
+    gst_caps_unref(caps);
+    gst_object_unref(pad);
+}
+
+// Cihaz belleği -> sistem belleği geçişi tek indirme sayılır
+static void test_report_download(void) {
+    GstElement *chain[3] = {
+        make_owned("identity", "gpu_post"),
+        make_owned("identity", "enc_download"),
+        make_owned("identity", "cpu_enc"),
+    };
+    set_pad_caps(chain[0], "src", DMABUF_CAPS ",format=NV12,width=64,height=64");
+    set_pad_caps(chain[1], "sink", DMABUF_CAPS ",format=NV12,width=64,height=64");
+    set_pad_caps(chain[2], "sink", "video/x-raw,format=NV12,width=64,height=64");
+    check(gpu_memory_report_branch("", "encode", chain, 3) == 1, "DMABuf -> system memory counts one download");
+    check(gpu_memory_report_branch("", "preview", chain, 2) == 0, "DMABuf only branch is zero-copy");
+    for (int i = 0; i < 3; i++) gst_object_unref(chain[i]);
+}
+
+int main(int argc, char **argv) {
+    gst_init(&argc, &argv);
+    test_accepts();
+    test_download_pipeline();
+    test_report_download();
+    printf("%s\n", fails ? "FAILED" : "all passed");
+    return fails ? 1 : 0;
+}
@@ -0,0 +1,380 @@
+// rtp_fec_loopback.c
+// Bir FEC bloğunu 127.0.0.1'e gönderip aynı süreçte alır ve başlık/payload doğrular;
+// ardından bloğun NACK ile istenen shard'larının geçmişten yeniden gönderimini sınar.
+// Birleştirici için: blok numarası sıçramalarında pencerenin yeniden kurulması, yeni
+// SSRC'yle yeniden başlayan göndericiye IDR istenmesi, fec_reassembler_reset ve
+// simulcast SSRC kapısı.
+// Derleme: gcc -Iinclude tests/rtp_fec_loopback.c src/rtp_fec.c src/fec_block.c
+//          src/fec_codec.c src/shard_pool.c src/rtcp_feedback.c src/fec_reassembler.c
+//          src/fec_aggregator.c -lisal -lpthread -o tests/rtp_fec_loopback
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include "rtp_fec.h"
+#include "rtcp_feedback.h"
+#include "fec_reassembler.h"
+
+#define K 10
+#define R 4
+
+static int open_rx(struct sockaddr_in *out) {
+    int rx = socket(AF_INET, SOCK_DGRAM, 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    if (rx < 0 || bind(rx, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        perror("bind");
+        return -1;
+    }
+    socklen_t alen = sizeof(addr);
+    getsockname(rx, (struct sockaddr *)&addr, &alen);
+    int rcvbuf = 4 * 1024 * 1024;
+    setsockopt(rx, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    *out = addr;
+    return rx;
+}
+
+static int run(int use_gso) {
+    struct sockaddr_in addr;
+    int rx = open_rx(&addr);
+    if (rx < 0) return 1;
+
+    RtpFecSender *tx = rtp_fec_sender_new("127.0.0.1", ntohs(addr.sin_port), 0x1234abcd, use_gso);
+    ShardPool *pool = shard_pool_new(2);
+    if (!tx || !pool) { printf("setup failed\n"); return 1; }
+
+    size_t len = 12345;
+    unsigned char *frame = malloc(len);
+    for (size_t i = 0; i < len; i++) frame[i] = (unsigned char)(i * 31 + 7);
+
+    FecBlock blk;
+    fec_block_prepare(&blk, pool, K, R, frame, len, 1);
+    fec_block_encode(&blk, fec_encoder_get(K, R));
+    if (rtp_fec_sender_send_block(tx, &blk, 90000, RTP_FEC_FLAG_END_OF_FRAME) < 0) {
+        printf("send failed\n");
+        return 1;
+    }
+
+    int seen[K + R] = {0}, fails = 0;
+    uint8_t buf[65536];
+    for (int n = 0; n < K + R; n++) {
+        ssize_t got = recv(rx, buf, sizeof(buf), 0);
+        RtpFecPacket pkt;
+        if (got < 0 || rtp_fec_parse(buf, (size_t)got, &pkt) < 0) { fails++; continue; }
+        int idx = pkt.hdr.shard_index;
+        seen[idx]++;
+        if (pkt.hdr.k != K || pkt.hdr.r != R || pkt.hdr.payload_len != len ||
+            pkt.hdr.ssrc != 0x1234abcd || pkt.hdr.timestamp != 90000 ||
+            pkt.hdr.marker != (idx == K + R - 1) ||
+            memcmp(pkt.payload, blk.shards[idx], blk.shard_size) != 0)
+            fails++;
+    }
+    for (int i = 0; i < K + R; i++) if (seen[i] != 1) fails++;
+
+    RtpFecSenderStats st;
+    rtp_fec_sender_get_stats(tx, &st);
+    printf("%-8s gso=%s packets=%llu syscalls=%llu -> %s\n",
+           use_gso ? "gso" : "sendmmsg", rtp_fec_sender_gso_enabled(tx) ? "on" : "off",
+           (unsigned long long)st.packets, (unsigned long long)st.syscalls,
+           fails ? "FAIL" : "OK");
+
+    fec_block_release(&blk, pool);
+    shard_pool_free(pool);
+    rtp_fec_sender_free(tx);
+    free(frame);
+    close(rx);
+    return fails != 0;
+}
+
+// NACK: geçmişteki bloğun istenen shard'ları RETRANSMIT işaretiyle ve geçerli crc ile döner
+static int run_resend(void) {
+    struct sockaddr_in addr;
+    int rx = open_rx(&addr);
+    if (rx < 0) return 1;
+    RtpFecSender *tx = rtp_fec_sender_new("127.0.0.1", ntohs(addr.sin_port), 0x1234abcd, 0);
+    ShardPool *pool = shard_pool_new(2);
+    if (!tx || !pool || rtp_fec_sender_enable_history(tx, 4, 100000) < 0) {
+        printf("setup failed\n");
+        return 1;
+    }
+
+    size_t len = 12345;
+    unsigned char *frame = malloc(len);
+    for (size_t i = 0; i < len; i++) frame[i] = (unsigned char)(i * 13 + 5);
+    FecBlock blk;
+    fec_block_prepare(&blk, pool, K, R, frame, len, 1);
+    fec_block_encode(&blk, fec_encoder_get(K, R));
+    rtp_fec_sender_send_block(tx, &blk, 90000, RTP_FEC_FLAG_END_OF_FRAME);
+
+    uint8_t buf[65536];
+    uint32_t block_id = 0;
+    for (int n = 0; n < K + R; n++) {
+        RtpFecPacket pkt;
+        ssize_t got = recv(rx, buf, sizeof(buf), 0);
+        if (got > 0 && rtp_fec_parse(buf, (size_t)got, &pkt) == 0) block_id = pkt.hdr.block_id;
+    }
+
+    // İstek alıcıdaki gibi RTCP üzerinden geçer
+    RtcpBlockNack req[2] = {
+        { block_id, 1ull << 0 | 1ull << 3 | 1ull << (K + 1) },
+        { block_id + 100, RTCP_NACK_WHOLE_BLOCK },
+    };
+    uint8_t msg[64];
+    RtcpFeedback fb;
+    size_t mlen = rtcp_build_block_nack(0x55, 0x1234abcd, req, 2, msg, sizeof(msg));
+    int fails = 0;
+    if (rtcp_parse_feedback(msg, mlen, &fb) < 0 || fb.type != RTCP_PT_RTPFB || fb.nack_count != 2 ||
+        fb.nacks[0].missing != req[0].missing || fb.media_ssrc != 0x1234abcd)
+        fails++;
+
+    int sent = rtp_fec_sender_resend(tx, fb.nacks[0].block_id, fb.nacks[0].missing);
+    if (sent != 3) fails++;
+    for (int n = 0; n < sent; n++) {
+        RtpFecPacket pkt;
+        ssize_t got = recv(rx, buf, sizeof(buf), 0);
+        if (got < 0 || rtp_fec_parse(buf, (size_t)got, &pkt) < 0) { fails++; continue; }
+        int idx = pkt.hdr.shard_index;
+        if (!(pkt.hdr.flags & RTP_FEC_FLAG_RETRANSMIT) || !(req[0].missing >> idx & 1) ||
+            memcmp(pkt.payload, blk.shards[idx], blk.shard_size) != 0)
+            fails++;
+    }
+    if (rtp_fec_sender_resend(tx, fb.nacks[1].block_id, fb.nacks[1].missing) != 0) fails++;
+
+    RtpFecResendStats rs;
+    rtp_fec_sender_get_resend_stats(tx, &rs);
+    if (rs.requests != 2 || rs.packets != 3 || rs.misses != 1) fails++;
+    printf("%-8s requests=%llu resent=%llu misses=%llu -> %s\n", "resend",
+           (unsigned long long)rs.requests, (unsigned long long)rs.packets,
+           (unsigned long long)rs.misses, fails ? "FAIL" : "OK");
+
+    fec_block_release(&blk, pool);
+    shard_pool_free(pool);
+    rtp_fec_sender_free(tx);
+    free(frame);
+    close(rx);
+    return fails != 0;
+}
+
+/* --- Birleştirici: paketler soketsiz, doğrudan pack_block çıktısından verilir --- */
+
+typedef struct {
+    int frames;
+    int bad;
+    int lost;
+    uint32_t last_ts;
+} FrameSink;
+
+static void on_frame(void *user, const unsigned char *data, size_t len,
+                     uint32_t rtp_timestamp, int keyframe) {
+    FrameSink *fs = user;
+    // Her birim (ts / 3000) ile başlayan bilinen bir desendir
+    unsigned char seed = (unsigned char)(rtp_timestamp / 3000);
+    if (len < 2 || data[0] != seed || data[len - 1] != (unsigned char)(seed ^ 0x5a)) fs->bad++;
+    fs->frames++;
+    fs->last_ts = rtp_timestamp;
+}
+
+static void on_repair(void *user, FecRepairKind kind, uint32_t block_id, uint64_t missing) {
+    if (kind == FEC_REPAIR_LOST) ((FrameSink *)user)->lost++;
+}
+
+/*
+ * Tek bloklu bir birimi paketleyip SSRC kapısından birleştiriciye verir. id_shift blok
+ * numarasını kaydırır (crc yeniden hesaplanır), yalnızca ilk keep paket verilir (-1 -> hepsi).
+ */
+static void push_unit(FecReassembler *ra, RtpFecSender *tx, ShardPool *pool, uint32_t ts,
+                      uint8_t flags, uint32_t id_shift, int keep) {
+    unsigned char frame[3000];
+    unsigned char seed = (unsigned char)(ts / 3000);
+    memset(frame, seed, sizeof(frame));
+    frame[sizeof(frame) - 1] = (unsigned char)(seed ^ 0x5a);
+    FecBlock blk;
+    fec_block_prepare(&blk, pool, 4, 1, frame, sizeof(frame), 0);
+    fec_block_encode(&blk, fec_encoder_get(4, 1));
+    size_t stride = RTP_FEC_PACKET_OVERHEAD + (size_t)blk.shard_size;
+    uint8_t pkts[5 * (RTP_FEC_PACKET_OVERHEAD + 1024)];
+    int n = rtp_fec_sender_pack_block(tx, &blk, ts, flags | RTP_FEC_FLAG_START_OF_FRAME |
+                                      RTP_FEC_FLAG_END_OF_FRAME, pkts, stride);
+    if (keep >= 0 && keep < n) n = keep;
+    for (int i = 0; i < n; i++) {
+        uint8_t *p = pkts + (size_t)i * stride;
+        if (id_shift) {
+            uint8_t *f = p + RTP_HEADER_SIZE;
+            uint32_t id = ((uint32_t)f[0] << 24 | (uint32_t)f[1] << 16 | (uint32_t)f[2] << 8 | f[3]) + id_shift;
+            f[0] = (uint8_t)(id >> 24); f[1] = (uint8_t)(id >> 16); f[2] = (uint8_t)(id >> 8); f[3] = (uint8_t)id;
+            rtp_fec_seal(p, p + RTP_FEC_PACKET_OVERHEAD, (size_t)blk.shard_size);
+        }
+        RtpFecPacket pkt;
+        if (rtp_fec_parse(p, stride, &pkt) == 0 && fec_reassembler_accept_ssrc(ra, &pkt.hdr))
+            fec_reassembler_push(ra, &pkt);
+    }
+    fec_block_release(&blk, pool);
+}
+
+// Aynı SSRC'de numaralar geriye (sabit SSRC'li bir gönderici yeniden başladı) ya da uzun
+// kesintide ileriye sıçrarsa pencere yeniden kurulur
+static int run_resync(void) {
+    FrameSink fs = { 0 };
+    FecReassembler *ra = fec_reassembler_new(64, 4, on_frame, &fs);
+    RtpFecSender *a = rtp_fec_sender_new("127.0.0.1", 9, 0x1111, 0);
+    RtpFecSender *b = rtp_fec_sender_new("127.0.0.1", 9, 0x1111, 0);
+    ShardPool *pool = shard_pool_new(2);
+    if (!ra || !a || !b || !pool) { printf("setup failed\n"); return 1; }
+    fec_reassembler_set_repair_callback(ra, 0, on_repair);
+
+    uint32_t ts = 0;
+    for (int i = 0; i < 100; i++) push_unit(ra, a, pool, ts += 3000, 0, 0, -1);
+    // Yeni gönderici 0'dan sayar: eski numaralara göre 100 blok geride
+    for (int i = 0; i < 10; i++) push_unit(ra, b, pool, ts += 3000, 0, 0, -1);
+    // Uzun kesintiden sonra bir milyon blok ileride
+    for (int i = 0; i < 10; i++) push_unit(ra, b, pool, ts += 3000, 0, 1000000, -1);
+    fec_reassembler_flush(ra);
+
+    FecReassemblerStats st;
+    fec_reassembler_get_stats(ra, &st);
+    int fails = fs.frames != 120 || fs.bad || st.resyncs != 2 || fs.lost != 2 ||
+                st.blocks_lost != 0 || fs.last_ts != ts;
+    printf("%-8s frames=%d resyncs=%llu lost_reports=%d -> %s\n", "resync", fs.frames,
+           (unsigned long long)st.resyncs, fs.lost, fails ? "FAIL" : "OK");
+
+    fec_reassembler_free(ra);
+    rtp_fec_sender_free(a);
+    rtp_fec_sender_free(b);
+    shard_pool_free(pool);
+    return fails;
+}
+
+// Reset yarım bloğu onarım istemeden atar; yeni dizi pencere içinde geride başlasa da teslim edilir
+static int run_reset(void) {
+    FrameSink fs = { 0 };
+    FecReassembler *ra = fec_reassembler_new(64, 4, on_frame, &fs);
+    RtpFecSender *a = rtp_fec_sender_new("127.0.0.1", 9, 0x1111, 0);
+    RtpFecSender *b = rtp_fec_sender_new("127.0.0.1", 9, 0x1111, 0);
+    ShardPool *pool = shard_pool_new(2);
+    if (!ra || !a || !b || !pool) { printf("setup failed\n"); return 1; }
+    fec_reassembler_set_repair_callback(ra, 0, on_repair);
+
+    uint32_t ts = 0;
+    for (int i = 0; i < 5; i++) push_unit(ra, a, pool, ts += 3000, 0, 0, -1);
+    push_unit(ra, a, pool, ts += 3000, 0, 0, 2);      // k=4'ün 2 shard'ı: bekleyen blok
+    fec_reassembler_reset(ra);
+    // Reset olmasaydı 0..5 numaraları teslim edilmiş sayılıp geç diye atılırdı
+    for (int i = 0; i < 8; i++) push_unit(ra, b, pool, ts += 3000, 0, 0, -1);
+    fec_reassembler_flush(ra);
+
+    FecReassemblerStats st;
+    fec_reassembler_get_stats(ra, &st);
+    int fails = fs.frames != 13 || fs.bad || fs.lost || st.resyncs || st.blocks_lost ||
+                fs.last_ts != ts;
+    printf("%-8s frames=%d lost_reports=%d -> %s\n", "reset", fs.frames, fs.lost,
+           fails ? "FAIL" : "OK");
+
+    fec_reassembler_free(ra);
+    rtp_fec_sender_free(a);
+    rtp_fec_sender_free(b);
+    shard_pool_free(pool);
+    return fails;
+}
+
+// Simulcast: yeni SSRC'ye yalnızca IDR'ının ilk bloğunda geçilir, eski katman sonra atılır
+static int run_layer_switch(void) {
+    FrameSink fs = { 0 };
+    FecReassembler *ra = fec_reassembler_new(64, 4, on_frame, &fs);
+    RtpFecSender *hi = rtp_fec_sender_new("127.0.0.1", 9, 0x1111, 0);
+    RtpFecSender *lo = rtp_fec_sender_new("127.0.0.1", 9, 0x2222, 0);
+    ShardPool *pool = shard_pool_new(2);
+    if (!ra || !hi || !lo || !pool) { printf("setup failed\n"); return 1; }
+
+    uint32_t ts = 0;
+    push_unit(ra, hi, pool, ts += 3000, RTP_FEC_FLAG_KEYFRAME, 0, -1);
+    for (int i = 0; i < 4; i++) push_unit(ra, hi, pool, ts += 3000, 0, 0, -1);
+    push_unit(ra, lo, pool, ts += 3000, 0, 0, -1);                      // IDR'dan önce: atılır
+    push_unit(ra, lo, pool, ts += 3000, RTP_FEC_FLAG_KEYFRAME, 0, -1);  // geçiş
+    push_unit(ra, hi, pool, ts += 3000, 0, 0, -1);                      // yoldaki eski katman
+    for (int i = 0; i < 3; i++) push_unit(ra, lo, pool, ts += 3000, 0, 0, -1);
+    fec_reassembler_flush(ra);
+
+    FecReassemblerStats st;
+    fec_reassembler_get_stats(ra, &st);
+    // Birim başına k + r = 5 paket; iki birim atıldı
+    int fails = fs.frames != 9 || fs.bad || st.layer_switches != 1 || st.stale_packets != 10 ||
+                st.blocks_lost || fs.last_ts != ts;
+    printf("%-8s frames=%d switches=%llu stale=%llu -> %s\n", "simulcast", fs.frames,
+           (unsigned long long)st.layer_switches, (unsigned long long)st.stale_packets,
+           fails ? "FAIL" : "OK");
+
+    fec_reassembler_free(ra);
+    rtp_fec_sender_free(hi);
+    rtp_fec_sender_free(lo);
+    shard_pool_free(pool);
+    return fails;
+}
+
+/*
+ * Yeniden başlayan gönderici yeni bir SSRC'yle GOP ortasından başlar: paketleri atılır,
+ * FEC_SSRC_ORPHAN_US sonra (ve en fazla o aralıkla) o SSRC'ye IDR istenir, IDR gelince
+ * geçilir ve yeni dizi 0'dan teslim edilir.
+ */
+static int run_restart(void) {
+    FrameSink fs = { 0 };
+    FecReassembler *ra = fec_reassembler_new(64, 4, on_frame, &fs);
+    RtpFecSender *a = rtp_fec_sender_new("127.0.0.1", 9, 0x1111, 0);
+    RtpFecSender *b = rtp_fec_sender_new("127.0.0.1", 9, 0x2222, 0);
+    ShardPool *pool = shard_pool_new(2);
+    if (!ra || !a || !b || !pool) { printf("setup failed\n"); return 1; }
+
+    const int64_t frame_us = 33333;
+    int64_t now = 1000000;
+    uint32_t ts = 0;
+    FecReassemblerStats st;
+    push_unit(ra, a, pool, ts += 3000, RTP_FEC_FLAG_KEYFRAME, 0, -1);
+    for (int i = 0; i < 99; i++) {
+        fec_reassembler_advance(ra, now += frame_us);
+        push_unit(ra, a, pool, ts += 3000, 0, 0, -1);
+    }
+    // Yeni SSRC'nin P-frame'leri ~1 s: istekler 10. (333 ms) ve 20. karede (667 ms)
+    int requests_at_first = -1;
+    for (int i = 0; i < 30; i++) {
+        fec_reassembler_advance(ra, now += frame_us);
+        push_unit(ra, b, pool, ts += 3000, 0, 0, -1);
+        fec_reassembler_get_stats(ra, &st);
+        if (requests_at_first < 0 && st.orphan_requests) requests_at_first = i;
+    }
+    int orphan = (int)st.orphan_requests;
+    push_unit(ra, b, pool, ts += 3000, RTP_FEC_FLAG_KEYFRAME, 0, -1);   // PLI'ın IDR'ı
+    for (int i = 0; i < 5; i++) {
+        fec_reassembler_advance(ra, now += frame_us);
+        push_unit(ra, b, pool, ts += 3000, 0, 0, -1);
+    }
+    fec_reassembler_flush(ra);
+
+    fec_reassembler_get_stats(ra, &st);
+    int fails = fs.frames != 106 || fs.bad || orphan != 2 || requests_at_first != 10 ||
+                st.orphan_requests != 2 || st.layer_switches != 1 || st.stale_packets != 150 ||
+                fs.last_ts != ts;
+    printf("%-8s frames=%d keyframe_requests=%d switches=%llu -> %s\n", "restart", fs.frames,
+           orphan, (unsigned long long)st.layer_switches, fails ? "FAIL" : "OK");
+
+    fec_reassembler_free(ra);
+    rtp_fec_sender_free(a);
+    rtp_fec_sender_free(b);
+    shard_pool_free(pool);
+    return fails;
+}
+
+int main(void) {
+    int rc = run(0);
+    rc |= run(1);
+    rc |= run_resend();
+    rc |= run_resync();
+    rc |= run_restart();
+    rc |= run_reset();
+    rc |= run_layer_switch();
+    return rc;
+}